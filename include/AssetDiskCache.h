@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef OB_ASSETDISKCACHE
+#define OB_ASSETDISKCACHE
+
+#include "obtype.h"
+
+#include <string>
+#include <atomic>
+
+namespace OB{
+	/**
+	 * What the disk cache knows about a URL. Internal to
+	 * AssetDiskCache and AssetLocator.
+	 */
+	struct _ob_disk_cache_entry{
+		public:
+			// SHA-256 of the content, also the name of its blob
+			std::string hash;
+			size_t size;
+
+			// Validators sent back to the server when revalidating
+			std::string etag;
+			std::string lastModified;
+	};
+
+	/**
+	 * Persistent cache of remote assets, shared by every engine
+	 * on the same host that points at the same directory.
+	 *
+	 * Content is stored once per SHA-256 hash under blobs/, and
+	 * each URL has a small index file under index/, named by the
+	 * hash of the URL, pointing at its blob along with the ETag and
+	 * Last-Modified the server sent. Both are written to a temporary
+	 * file first and moved into place with rename, so readers never
+	 * see a partial file, even while another process is writing.
+	 *
+	 * Blobs are never removed by the engine.
+	 *
+	 * @author John M. Harris, Jr.
+	 */
+	class AssetDiskCache{
+		public:
+			AssetDiskCache(std::string dir);
+			virtual ~AssetDiskCache();
+
+			/**
+			 * Returns the directory this cache lives in.
+			 *
+			 * @returns Cache directory
+			 * @author John M. Harris, Jr.
+			 */
+			std::string getDirectory();
+
+			/**
+			 * Looks up the index entry for a URL.
+			 *
+			 * @param url URL of the asset
+			 * @param entry Filled in on success
+			 * @returns true if the URL is in the cache
+			 * @author John M. Harris, Jr.
+			 */
+			bool lookup(std::string url, struct _ob_disk_cache_entry& entry);
+
+			/**
+			 * Reads the content of an entry found with lookup.
+			 * The returned buffer is allocated with malloc.
+			 *
+			 * @param entry Entry to read
+			 * @param data Set to the content on success
+			 * @returns true if the content was read and matches the
+			 * entry's size
+			 * @author John M. Harris, Jr.
+			 */
+			bool read(struct _ob_disk_cache_entry& entry, char** data);
+
+			/**
+			 * Stores the content of a URL, along with the
+			 * validators used to revalidate it later.
+			 *
+			 * @param url URL of the asset
+			 * @param data Content
+			 * @param size Size of content
+			 * @param etag ETag header, or empty
+			 * @param lastModified Last-Modified header, or empty
+			 * @returns true on success
+			 * @author John M. Harris, Jr.
+			 */
+			bool store(std::string url, const char* data, size_t size, std::string etag, std::string lastModified);
+
+		private:
+			std::string blobPath(std::string hash);
+			std::string indexPath(std::string url);
+			bool writeAtomic(std::string path, const char* data, size_t size);
+
+			std::string dir;
+			std::atomic<unsigned int> tmpCounter;
+	};
+}
+
+#endif // OB_ASSETDISKCACHE
+
+// Local Variables:
+// mode: c++
+// End:
@@ -23,11 +23,19 @@
 #include "obtype.h"
 #include "mem.h"
 
+#include "AssetDiskCache.h"
+#include "MPSCQueue.h"
+
+#include "type/Enum.h"
+
 #include <pthread.h>
 
 #include <string>
 #include <map>
+#include <list>
+#include <deque>
 #include <vector>
+#include <atomic>
 
 #include "oblibconfig.h"
 
@@ -35,30 +43,118 @@
 #include <irrlicht/irrlicht.h>
 #endif
 
+/**
+ * Default number of bytes of asset data kept in memory by
+ * AssetLocator. Assets still in use are kept even past this.
+ */
+#define OB_ASSET_CACHE_DEFAULT_BUDGET (256 * 1024 * 1024)
+
+/**
+ * Local files at least this big are mapped into memory instead of
+ * being read.
+ */
+#define OB_ASSET_MMAP_THRESHOLD (64 * 1024)
+
+/**
+ * Default number of microseconds AssetLocator::tick may spend
+ * announcing finished loads each tick.
+ */
+#define OB_ASSET_COMPLETION_BUDGET 2000
+
+/**
+ * Default number of queued loads AssetLocator runs at once. Loads
+ * past this wait in priority order.
+ */
+#define OB_ASSET_DEFAULT_MAX_ACTIVE 8
+
+/**
+ * Size assumed for preloaded assets with no size given, when
+ * weighing preload progress.
+ */
+#define OB_ASSET_PRELOAD_DEFAULT_SIZE (64 * 1024)
+
 namespace OB{
 	class OBEngine;
+	struct _ob_download_request;
 
 	namespace Instance{
 		class Instance;
 	}
 
+	/**
+	 * Where the data of an AssetResponse lives, and so how it's
+	 * released.
+	 */
+	enum _ob_asset_storage{
+		OB_ASSET_STORAGE_NEW,
+		OB_ASSET_STORAGE_MALLOC,
+		OB_ASSET_STORAGE_MMAP
+	};
+
 	class AssetResponse{
 		public:
+			/**
+			 * Creates an AssetResponse holding a copy of data.
+			 *
+			 * @param size Size of data
+			 * @param data Data to copy
+			 * @param resURI URI of the asset
+			 * @param eng Engine
+			 * @author John M. Harris, Jr.
+			 */
 			AssetResponse(size_t size, char* data, std::string resURI, OBEngine* eng);
 			~AssetResponse();
 
+			/**
+			 * Creates an AssetResponse that takes ownership of a
+			 * buffer allocated with malloc, without copying it.
+			 *
+			 * @param size Size of data
+			 * @param data Buffer, freed with the response
+			 * @param resURI URI of the asset
+			 * @param eng Engine
+			 * @returns AssetResponse
+			 * @author John M. Harris, Jr.
+			 */
+			static shared_ptr<AssetResponse> adopt(size_t size, char* data, std::string resURI, OBEngine* eng);
+
+			/**
+			 * Creates an AssetResponse backed by a private,
+			 * copy-on-write mapping of a file, so its content is
+			 * only paged in as it's read. The file must not be
+			 * truncated while the response exists.
+			 *
+			 * @param path Path of the file
+			 * @param resURI URI of the asset
+			 * @param eng Engine
+			 * @returns AssetResponse, or NULL if the file couldn't
+			 * be mapped
+			 * @author John M. Harris, Jr.
+			 */
+			static shared_ptr<AssetResponse> mapFile(std::string path, std::string resURI, OBEngine* eng);
+
 			size_t getSize();
 			char* getData();
 			std::string getResURI();
 
 #if HAVE_IRRLICHT
+			/**
+			 * Returns an Irrlicht file reading straight from this
+			 * response's data. The response must outlive it.
+			 *
+			 * @returns Irrlicht read file, or NULL
+			 * @author John M. Harris, Jr.
+			 */
 			irr::io::IReadFile* toIReadFile();
 #endif
 
 		private:
+			AssetResponse(std::string resURI, OBEngine* eng);
+
 			size_t size;
 			char* data;
 			std::string resURI;
+			enum _ob_asset_storage storage;
 
 			OBEngine* eng;
 	};
@@ -69,13 +165,134 @@ namespace OB{
             size_t size;
     };
 
+	/**
+	 * A load in progress, shared by every caller waiting on the same
+	 * URL. Internal to AssetLocator, guarded by its mutex.
+	 */
+	struct _ob_asset_request{
+		public:
+			_ob_asset_request();
+			~_ob_asset_request();
+
+			bool done;
+			// Whether this request is counted in the request queue size
+			bool counted;
+			pthread_cond_t cond;
+
+			// Set by whoever takes care of a finished download, the
+			// DownloadManager callback or a loadAssetSync caller
+			bool finishing;
+			shared_ptr<struct _ob_download_request> download;
+
+			// Copy from the disk cache, allocated with malloc
+			shared_ptr<AssetDiskCache> diskCache;
+			struct _ob_disk_cache_entry cached;
+			char* cachedData;
+
+			// Queued loads, see AssetLocator::loadAsset
+			Enum::AssetPriority priority;
+			// Whether this has left the priority queue
+			bool dispatched;
+			// Whether this counts against the active request limit
+			bool active;
+	};
+
+	/**
+	 * A finished load waiting to be announced on the main thread.
+	 * Internal to AssetLocator.
+	 */
+	struct _ob_asset_completion{
+		public:
+			std::string url;
+			bool loaded;
+			std::string failReason;
+	};
+
+	/**
+	 * An asset to preload, as listed in a preload manifest.
+	 */
+	struct _ob_preload_entry{
+		public:
+			std::string url;
+			// Expected size in bytes, 0 if unknown
+			size_t size;
+			Enum::AssetPriority priority;
+	};
+
+	struct _ob_preload_batch;
+
+	/**
+	 * Function type called when every asset of a preload batch has
+	 * loaded or failed.
+	 */
+	typedef void (*ob_preload_fnc)(shared_ptr<struct _ob_preload_batch> batch, void* ud);
+
+	/**
+	 * A group of assets preloaded together, see AssetLocator::preload.
+	 * Only touched on the main thread.
+	 */
+	struct _ob_preload_batch{
+		public:
+			// Assets still loading, with their progress weight
+			std::map<std::string, double> remaining;
+			size_t total;
+			size_t loaded;
+			size_t failed;
+			double totalWeight;
+			double doneWeight;
+
+			ob_preload_fnc callback;
+			void* ud;
+	};
+
+	/**
+	 * An entry in the AssetLocator content cache. Internal to
+	 * AssetLocator, guarded by its mutex.
+	 */
+	struct _ob_asset_cache_entry{
+		public:
+			shared_ptr<AssetResponse> resp;
+			// Position in the LRU list, front is most recently used
+			std::list<std::string>::iterator lruPos;
+	};
+
 	class AssetLocator{
 		public:
 			AssetLocator(OBEngine* eng);
 			virtual ~AssetLocator();
 
+			/**
+			 * Announces finished loads, firing AssetLoaded or
+			 * AssetLoadFailed and notifying waiting instances.
+			 * Loads finish on other threads, this is where their
+			 * events reach the main thread. Stops once the
+			 * completion budget is used up, leaving the rest for
+			 * the next tick, but always announces at least one.
+			 *
+			 * Called by the engine every tick.
+			 *
+			 * @author John M. Harris, Jr.
+			 */
 			void tick();
 
+			/**
+			 * Returns the number of microseconds tick may spend
+			 * announcing finished loads.
+			 *
+			 * @returns Completion budget in microseconds
+			 * @author John M. Harris, Jr.
+			 */
+			ob_uint64 getCompletionBudget();
+
+			/**
+			 * Sets the number of microseconds tick may spend
+			 * announcing finished loads.
+			 *
+			 * @param budget Completion budget in microseconds
+			 * @author John M. Harris, Jr.
+			 */
+			void setCompletionBudget(ob_uint64 budget);
+
 			/**
 			 * Used internally to process responses from cURL.
 			 * @internal
@@ -83,24 +300,230 @@ namespace OB{
 			 */
 			static size_t _ob_assetlocator_write_data(void* ptr, size_t size, size_t nmemb, struct _ob_curl_body* data);
 
-			void loadAssetSync(std::string url, bool decCount = false, bool allowFile = false);
+			/**
+			 * Used internally to finish asynchronous downloads.
+			 * @internal
+			 * @author John M. Harris, Jr.
+			 */
+			static void _ob_assetlocator_download_done(shared_ptr<struct _ob_download_request> dl, void* ud);
+
+			/**
+			 * Used internally to write downloaded assets to the
+			 * disk cache off the main thread.
+			 * @internal
+			 * @author John M. Harris, Jr.
+			 */
+			static int _ob_assetlocator_store_task(void* metad, ob_uint64 startTime);
+
+			/**
+			 * Loads an asset on the calling thread. If the same
+			 * URL is already being loaded, this waits for that
+			 * load instead of starting another one.
+			 *
+			 * @param url URL of the asset
+			 * @param allowFile Whether file:// URLs may be loaded
+			 * @author John M. Harris, Jr.
+			 */
+			void loadAssetSync(std::string url, bool allowFile = false);
 			static int loadAssetAsyncTask(void* metad, ob_uint64 startTime);
-			void loadAsset(std::string url);
+
+			/**
+			 * Queues an asset to be loaded on the secondary task
+			 * thread. Does nothing if the asset is already
+			 * loaded, except raise the priority of a queued load
+			 * that hasn't started yet.
+			 *
+			 * At most getMaxActiveRequests queued loads run at
+			 * once, the rest start in priority order as those
+			 * finish.
+			 *
+			 * @param url URL of the asset
+			 * @param priority Priority class
+			 * @author John M. Harris, Jr.
+			 */
+			void loadAsset(std::string url, Enum::AssetPriority priority = Enum::AssetPriority::Default);
+
+			/**
+			 * Queues every asset in a list that isn't already
+			 * loaded, each at its own priority, and tracks them
+			 * as a batch. Must be called from the main thread.
+			 *
+			 * If anything is left to load, callback is called
+			 * from tick once the last of it has loaded or failed.
+			 * Otherwise it isn't called at all, and the returned
+			 * batch has nothing remaining.
+			 *
+			 * @param entries Assets to preload
+			 * @param callback Called when the batch is done, or NULL
+			 * @param ud Passed to callback
+			 * @returns Batch
+			 * @author John M. Harris, Jr.
+			 */
+			shared_ptr<struct _ob_preload_batch> preload(std::vector<struct _ob_preload_entry> entries, ob_preload_fnc callback, void* ud);
+
+			/**
+			 * Returns how far along the unfinished preload
+			 * batches are together, from 0 to 1, weighted by the
+			 * expected size of each asset. Returns 1 when nothing
+			 * is being preloaded.
+			 *
+			 * @returns Preload progress
+			 * @author John M. Harris, Jr.
+			 */
+			double getPreloadProgress();
+
+			/**
+			 * Parses a preload manifest. Each line lists a URL,
+			 * optionally followed by its size in bytes and its
+			 * priority, the name or value of an AssetPriority,
+			 * separated by whitespace. Empty lines and lines
+			 * starting with # are ignored.
+			 *
+			 * @param data Manifest text
+			 * @param size Length of data
+			 * @param defaultPriority Priority of entries not giving one
+			 * @returns Entries
+			 * @author John M. Harris, Jr.
+			 */
+			static std::vector<struct _ob_preload_entry> parseManifest(const char* data, size_t size, Enum::AssetPriority defaultPriority);
+
+			/**
+			 * Returns the number of queued loads run at once.
+			 *
+			 * @returns Maximum active requests
+			 * @author John M. Harris, Jr.
+			 */
+			int getMaxActiveRequests();
+
+			/**
+			 * Sets the number of queued loads run at once.
+			 *
+			 * @param maxActive Maximum active requests, at least 1
+			 * @author John M. Harris, Jr.
+			 */
+			void setMaxActiveRequests(int maxActive);
 			shared_ptr<AssetResponse> getAsset(std::string url, bool loadIfNotPresent = false);
 			bool hasAsset(std::string url);
 			void putAsset(std::string url, size_t size, char* data);
 
 			void addWaitingInstance(shared_ptr<Instance::Instance> inst);
 
+			/**
+			 * Returns true if url is cached and loaded. Otherwise
+			 * inst is added to the waiting instances and a load is
+			 * queued, which re-arms loading for an asset that has
+			 * been evicted since the instance last used it.
+			 *
+			 * @param url URL of the asset
+			 * @param inst Instance to notify once it's loaded
+			 * @param priority Priority to load the asset at
+			 * @returns true if the asset is available now
+			 * @author John M. Harris, Jr.
+			 */
+			bool requireAsset(std::string url, shared_ptr<Instance::Instance> inst, Enum::AssetPriority priority = Enum::AssetPriority::Default);
+
 			int getRequestQueueSize();
 
+			/**
+			 * Returns the number of bytes of asset data the cache
+			 * tries to stay under.
+			 *
+			 * @returns Cache budget in bytes
+			 * @author John M. Harris, Jr.
+			 */
+			size_t getCacheBudget();
+
+			/**
+			 * Sets the number of bytes of asset data the cache
+			 * tries to stay under. When it goes over, the least
+			 * recently used assets are dropped, except for those
+			 * still referenced outside of the cache.
+			 *
+			 * @param budget Cache budget in bytes
+			 * @author John M. Harris, Jr.
+			 */
+			void setCacheBudget(size_t budget);
+
+			/**
+			 * Returns the number of bytes of asset data currently
+			 * held by the cache.
+			 *
+			 * @returns Cache size in bytes
+			 * @author John M. Harris, Jr.
+			 */
+			size_t getCacheSize();
+
+			ob_uint64 getCacheHits();
+			ob_uint64 getCacheMisses();
+			ob_uint64 getCacheEvictions();
+
+			/**
+			 * Sets the directory remote assets are cached in
+			 * between runs. An empty string disables the disk
+			 * cache, which is the default.
+			 *
+			 * Cached assets are revalidated with the server using
+			 * their ETag or Last-Modified headers, and are used
+			 * as they are if the server can't be reached.
+			 *
+			 * @param dir Cache directory
+			 * @author John M. Harris, Jr.
+			 */
+			void setDiskCacheDirectory(std::string dir);
+
+			/**
+			 * Returns the directory remote assets are cached in,
+			 * or an empty string if the disk cache is disabled.
+			 *
+			 * @returns Cache directory
+			 * @author John M. Harris, Jr.
+			 */
+			std::string getDiskCacheDirectory();
+
 		private:
-			std::map<std::string, shared_ptr<AssetResponse>> contentCache;
+			shared_ptr<AssetResponse> readResource(std::string url, std::string& failReason);
+			shared_ptr<struct _ob_download_request> prepareDownload(std::string url, bool allowFile, shared_ptr<struct _ob_asset_request> req);
+			void completeDownload(std::string url, shared_ptr<struct _ob_asset_request> req, bool storeAsync);
+			void runRequest(std::string url, shared_ptr<struct _ob_asset_request> req, bool allowFile, bool async);
+			void dispatchPending();
+			void updatePreloads(std::string url, bool loaded);
+			shared_ptr<AssetResponse> finishRequest(std::string url, shared_ptr<struct _ob_asset_request> req, shared_ptr<AssetResponse> resp, std::string failReason);
+			void fireAssetLoadFailed(std::string url, std::string reason);
+			void notifyWaitingInstances(std::string url);
+
+			void cachePut(std::string url, shared_ptr<AssetResponse> resp);
+			void cacheErase(std::map<std::string, struct _ob_asset_cache_entry>::iterator i);
+			void evictAssets();
+
+			std::map<std::string, struct _ob_asset_cache_entry> contentCache;
+			std::list<std::string> lruList;
+			shared_ptr<AssetDiskCache> diskCache;
+			size_t cacheBudget;
+			size_t cacheSize;
+			ob_uint64 cacheHits;
+			ob_uint64 cacheMisses;
+			ob_uint64 cacheEvictions;
+
+			// Filled by whichever thread finishes a load, drained by tick
+			MPSCQueue<struct _ob_asset_completion> completions;
+			std::atomic<ob_uint64> completionBudget;
+
+			// Queued loads waiting to start, one queue per priority
+			std::deque<std::string> pending[(int)Enum::AssetPriority::__COUNT];
+			int activeRequests;
+			int maxActiveRequests;
+
+			std::vector<shared_ptr<struct _ob_preload_batch>> preloads;
+
+			std::map<std::string, shared_ptr<struct _ob_asset_request>> inFlight;
 			OBEngine* eng;
 
 			std::vector<weak_ptr<Instance::Instance>> instancesWaiting;
+			pthread_mutex_t waitingMutex;
 
 			shared_ptr<AssetResponse> loadingResponse;
+			// Guards the cache, inFlight, the pending queues and request
+			// counts, never held during I/O
 			pthread_mutex_t mmutex;
 
 			int requestQueueSize;
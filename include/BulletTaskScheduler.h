@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "oblibconfig.h"
+
+#include "mem.h"
+
+#include "WorkerPool.h"
+
+#if HAVE_BULLET_MT
+#include <LinearMath/btThreads.h>
+#endif
+
+#ifndef OB_BULLETTASKSCHEDULER
+#define OB_BULLETTASKSCHEDULER
+
+namespace OB{
+#if HAVE_BULLET_MT
+	/**
+	 * Runs Bullet's parallel loops on the engine's WorkerPool, so
+	 * the multithreaded dynamics world doesn't start a thread pool
+	 * of its own.
+	 *
+	 * Bullet only has one task scheduler per process, installed
+	 * with btSetTaskScheduler.
+	 *
+	 * @author John M. Harris, Jr.
+	 */
+	class BulletTaskScheduler: public btITaskScheduler{
+		public:
+			BulletTaskScheduler(shared_ptr<WorkerPool> pool);
+			virtual ~BulletTaskScheduler();
+
+			virtual int getMaxNumThreads() const;
+			virtual int getNumThreads() const;
+			virtual void setNumThreads(int numThreads);
+			virtual void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body);
+			virtual btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body);
+
+		private:
+			shared_ptr<WorkerPool> pool;
+	};
+#endif
+}
+
+#endif // OB_BULLETTASKSCHEDULER
+
+// Local Variables:
+// mode: c++
+// End:
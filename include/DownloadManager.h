@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef OB_DOWNLOADMANAGER
+#define OB_DOWNLOADMANAGER
+
+#include "obtype.h"
+#include "mem.h"
+
+#include "oblibconfig.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+
+#include <pthread.h>
+
+#if HAVE_CURL
+#include <curl/curl.h>
+
+/**
+ * Default number of transfers DownloadManager runs at once.
+ */
+#define OB_DOWNLOAD_DEFAULT_MAX_CONCURRENT 16
+
+namespace OB{
+	struct _ob_download_request;
+
+	/**
+	 * Called on the main thread, from DownloadManager::tick, when
+	 * a request submitted with a callback is done.
+	 */
+	typedef void (*ob_download_fnc)(shared_ptr<struct _ob_download_request> req, void* ud);
+
+	/**
+	 * A single transfer run by DownloadManager. Fill in the
+	 * request fields, submit it, and read the response fields once
+	 * it's done.
+	 */
+	struct _ob_download_request{
+		public:
+			_ob_download_request();
+			~_ob_download_request();
+
+			// Request
+			std::string url;
+			long protocols;
+			std::vector<std::string> headers;
+			bool post;
+			std::string postData;
+
+			ob_download_fnc callback;
+			void* ud;
+
+			// Response, valid once done is set
+			bool ok;
+			std::string error;
+			long responseCode;
+			// Allocated with malloc, owned by the request until taken
+			char* data;
+			size_t size;
+			// Header names are lowercased, the last value of a header wins
+			std::map<std::string, std::string> responseHeaders;
+
+			/**
+			 * Takes ownership of the response body. The caller
+			 * is responsible for freeing it with free.
+			 *
+			 * @returns Response body, or NULL
+			 * @author John M. Harris, Jr.
+			 */
+			char* takeData();
+
+			// Internal to DownloadManager, guarded by its mutex
+			bool done;
+			pthread_cond_t cond;
+			CURL* easy;
+			struct curl_slist* headerList;
+	};
+
+	/**
+	 * Runs every remote transfer of an engine on a single
+	 * curl_multi handle, on its own thread.
+	 *
+	 * Connections stay open between transfers and are reused, HTTP/2
+	 * connections are multiplexed, and DNS results and TLS sessions
+	 * are shared between transfers. No more than a set number of
+	 * transfers run at once, the rest wait their turn in order.
+	 *
+	 * Finished requests go into a completion queue that is drained
+	 * by tick on the main thread, which calls their callbacks.
+	 * perform can be used to wait for a request instead, from any
+	 * thread.
+	 *
+	 * If cURL or the transfer thread can't be started, every request
+	 * fails right away with an error saying so. Requests still
+	 * outstanding when the DownloadManager is destroyed fail as
+	 * cancelled, waking anything waiting on them, and their
+	 * callbacks are not called.
+	 *
+	 * @author John M. Harris, Jr.
+	 */
+	class DownloadManager{
+		public:
+			DownloadManager();
+			virtual ~DownloadManager();
+
+			/**
+			 * Queues a request. If it has a callback, that is
+			 * called from tick once the request is done.
+			 *
+			 * @param req Request
+			 * @author John M. Harris, Jr.
+			 */
+			void submit(shared_ptr<struct _ob_download_request> req);
+
+			/**
+			 * Queues a request and waits for it to finish. The
+			 * request's callback, if any, is still called from
+			 * tick.
+			 *
+			 * @param req Request
+			 * @author John M. Harris, Jr.
+			 */
+			void perform(shared_ptr<struct _ob_download_request> req);
+
+			/**
+			 * Waits for a submitted request to finish.
+			 *
+			 * @param req Request
+			 * @author John M. Harris, Jr.
+			 */
+			void wait(shared_ptr<struct _ob_download_request> req);
+
+			/**
+			 * Calls the callbacks of finished requests. Called
+			 * by the engine every tick.
+			 *
+			 * @author John M. Harris, Jr.
+			 */
+			void tick();
+
+			/**
+			 * Returns the number of transfers run at once.
+			 *
+			 * @returns Maximum concurrent transfers
+			 * @author John M. Harris, Jr.
+			 */
+			int getMaxConcurrent();
+
+			/**
+			 * Sets the number of transfers run at once.
+			 *
+			 * @param maxConcurrent Maximum concurrent transfers, at least 1
+			 * @author John M. Harris, Jr.
+			 */
+			void setMaxConcurrent(int maxConcurrent);
+
+			/**
+			 * Returns the number of requests that are running or
+			 * waiting to run.
+			 *
+			 * @returns Outstanding requests
+			 * @author John M. Harris, Jr.
+			 */
+			int getOutstandingCount();
+
+			/**
+			 * Used internally by the transfer thread.
+			 *
+			 * @author John M. Harris, Jr.
+			 */
+			void transferLoop();
+
+			/**
+			 * Used internally to receive response bodies from
+			 * cURL.
+			 * @internal
+			 * @author John M. Harris, Jr.
+			 */
+			static size_t _ob_download_write_data(void* ptr, size_t size, size_t nmemb, struct _ob_download_request* req);
+
+			/**
+			 * Used internally to receive response headers from
+			 * cURL.
+			 * @internal
+			 * @author John M. Harris, Jr.
+			 */
+			static size_t _ob_download_header_data(char* buffer, size_t size, size_t nitems, struct _ob_download_request* req);
+
+		private:
+			void failRequest(shared_ptr<struct _ob_download_request> req, std::string error);
+			void startTransfer(shared_ptr<struct _ob_download_request> req);
+			void finishTransfer(CURL* easy, CURLcode result);
+
+			static void _ob_share_lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+			static void _ob_share_unlock(CURL* handle, curl_lock_data data, void* userptr);
+
+			pthread_mutex_t mmutex;
+			pthread_mutex_t shareMutex[CURL_LOCK_DATA_LAST];
+			pthread_cond_t waitersCond;
+			pthread_t transferThread;
+			bool threadRunning;
+			bool stopping;
+			// Why the DownloadManager couldn't start, empty if it did
+			std::string startError;
+			// Threads blocked in wait, guarded by mmutex
+			int waiters;
+
+			CURLM* multi;
+			CURLSH* share;
+
+			int maxConcurrent;
+			std::deque<shared_ptr<struct _ob_download_request>> pending;
+			std::map<CURL*, shared_ptr<struct _ob_download_request>> active;
+			std::deque<shared_ptr<struct _ob_download_request>> completed;
+	};
+}
+#endif
+
+#endif // OB_DOWNLOADMANAGER
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef OB_IMAGEDECODER
+#define OB_IMAGEDECODER
+
+#include "obtype.h"
+#include "mem.h"
+
+#include "oblibconfig.h"
+
+#include <string>
+#include <map>
+#include <set>
+#include <list>
+
+#include <pthread.h>
+
+/**
+ * Default number of bytes of decoded images ImageDecoder holds on
+ * to while they wait to be taken.
+ */
+#define OB_IMAGEDECODER_DEFAULT_MAX_DECODED (64 * 1024 * 1024)
+
+#if HAVE_SDL2
+
+namespace OB{
+	class AssetResponse;
+	class WorkerPool;
+
+	/**
+	 * A decoded image, ready to be uploaded.
+	 */
+	struct _ob_decoded_image{
+		public:
+			_ob_decoded_image();
+			~_ob_decoded_image();
+
+			int width;
+			int height;
+			// width * height pixels with no padding, each a 32-bit
+			// ARGB value in native byte order, which is what
+			// Irrlicht calls ECF_A8R8G8B8. Allocated with malloc.
+			unsigned char* pixels;
+	};
+
+	/**
+	 * A decoded image waiting to be taken. Internal to ImageDecoder,
+	 * guarded by its mutex.
+	 */
+	struct _ob_decoded_entry{
+		public:
+			shared_ptr<struct _ob_decoded_image> img;
+			// Position in the decode order, front is the oldest
+			std::list<std::string>::iterator orderPos;
+	};
+
+	/**
+	 * Decodes PNG, JPEG and other images on the engine's worker
+	 * threads, so the render thread only has to upload the result.
+	 *
+	 * Decoded images are kept by URL until they're taken. Once
+	 * they take up more than the limit, the oldest are dropped and
+	 * have to be requested again. Images that fail to decode are
+	 * remembered too, so they aren't tried again until forgotten.
+	 *
+	 * Decoding uses SDL_image and doesn't need a window or video
+	 * driver, see decode.
+	 *
+	 * @author John M. Harris, Jr.
+	 */
+	class ImageDecoder{
+		public:
+			ImageDecoder(shared_ptr<WorkerPool> pool);
+			virtual ~ImageDecoder();
+
+			/**
+			 * Decodes an image on the calling thread.
+			 *
+			 * @param data Encoded image
+			 * @param size Length of data
+			 * @param error Set to the reason on failure
+			 * @returns Decoded image, or NULL
+			 * @author John M. Harris, Jr.
+			 */
+			static shared_ptr<struct _ob_decoded_image> decode(const char* data, size_t size, std::string& error);
+
+			/**
+			 * Queues an asset to be decoded on a worker thread.
+			 * Does nothing if it's being decoded, is waiting to
+			 * be taken or failed before.
+			 *
+			 * @param url URL of the asset
+			 * @param resp Asset data, kept alive until decoded
+			 * @author John M. Harris, Jr.
+			 */
+			void request(std::string url, shared_ptr<AssetResponse> resp);
+
+			/**
+			 * Returns a decoded image and drops it from the
+			 * decoder.
+			 *
+			 * @param url URL of the asset
+			 * @returns Decoded image, or NULL if it isn't ready
+			 * @author John M. Harris, Jr.
+			 */
+			shared_ptr<struct _ob_decoded_image> take(std::string url);
+
+			/**
+			 * Returns whether an asset is queued or being decoded.
+			 *
+			 * @param url URL of the asset
+			 * @returns true if decoding
+			 * @author John M. Harris, Jr.
+			 */
+			bool isDecoding(std::string url);
+
+			/**
+			 * Returns whether an asset failed to decode.
+			 *
+			 * @param url URL of the asset
+			 * @returns true if decoding failed
+			 * @author John M. Harris, Jr.
+			 */
+			bool hasFailed(std::string url);
+
+			/**
+			 * Drops anything known about an asset, so it's
+			 * decoded again next time it's requested. Used when
+			 * the asset changes.
+			 *
+			 * @param url URL of the asset
+			 * @author John M. Harris, Jr.
+			 */
+			void forget(std::string url);
+
+			/**
+			 * Returns the number of bytes of decoded images
+			 * waiting to be taken.
+			 *
+			 * @returns Decoded bytes
+			 * @author John M. Harris, Jr.
+			 */
+			size_t getDecodedSize();
+
+			/**
+			 * Returns the number of bytes of decoded images kept
+			 * waiting to be taken before the oldest are dropped.
+			 *
+			 * @returns Maximum decoded bytes
+			 * @author John M. Harris, Jr.
+			 */
+			size_t getMaxDecodedSize();
+
+			/**
+			 * Sets the number of bytes of decoded images kept
+			 * waiting to be taken before the oldest are dropped.
+			 * The newest image is always kept.
+			 *
+			 * @param maxSize Maximum decoded bytes
+			 * @author John M. Harris, Jr.
+			 */
+			void setMaxDecodedSize(size_t maxSize);
+
+			/**
+			 * Used internally by worker threads.
+			 *
+			 * @param url URL of the asset
+			 * @param resp Asset data
+			 * @author John M. Harris, Jr.
+			 */
+			void decodeJob(std::string url, shared_ptr<AssetResponse> resp);
+
+		private:
+			void eraseDecoded(std::map<std::string, struct _ob_decoded_entry>::iterator it);
+			void trimDecoded();
+
+			pthread_mutex_t mmutex;
+			pthread_cond_t idleCond;
+
+			shared_ptr<WorkerPool> pool;
+
+			std::set<std::string> decoding;
+			std::map<std::string, struct _ob_decoded_entry> decoded;
+			std::list<std::string> decodedOrder;
+			std::set<std::string> failed;
+			// Forgotten while decoding, the result is thrown away
+			std::set<std::string> stale;
+			size_t decodedSize;
+			size_t maxDecodedSize;
+			// Jobs queued on the pool, waited for on destruction
+			int outstanding;
+	};
+}
+#endif
+
+#endif // OB_IMAGEDECODER
+
+// Local Variables:
+// mode: c++
+// End:
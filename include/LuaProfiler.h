@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "obtype.h"
+
+#include "lua/OBLua.h"
+
+#include <string>
+#include <map>
+#include <atomic>
+
+#include <pthread.h>
+
+#ifndef OB_LUAPROFILER
+#define OB_LUAPROFILER
+
+/**
+ * Default number of microseconds between samples.
+ *
+ * @author John M. Harris, Jr.
+ */
+#define OB_LUAPROFILER_DEFAULT_INTERVAL 1000
+
+/**
+ * Number of VM instructions between checks of the sample flag. This
+ * is the count passed to lua_sethook.
+ *
+ * @author John M. Harris, Jr.
+ */
+#define OB_LUAPROFILER_HOOK_COUNT 1000
+
+/**
+ * Maximum depth of a single captured stack.
+ *
+ * @author John M. Harris, Jr.
+ */
+#define OB_LUAPROFILER_MAX_DEPTH 64
+
+namespace OB{
+	class OBEngine;
+
+	/**
+	 * Sampling profiler for Lua code running in the engine.
+	 *
+	 * While running, a timer thread raises a flag every sample
+	 * interval. A count hook installed on every Lua state checks
+	 * that flag, and when it is set records the call stack of the
+	 * running coroutine. Samples are aggregated in the "folded
+	 * stack" format used by flamegraph.pl, with one line per unique
+	 * stack, frames separated by ';' from root to leaf, followed by
+	 * the number of samples.
+	 *
+	 * When the profiler is stopped no hooks are installed, so there
+	 * is no cost to leaving it available.
+	 *
+	 * @author John M. Harris, Jr.
+	 */
+	class LuaProfiler{
+		public:
+			LuaProfiler(OBEngine* eng);
+			virtual ~LuaProfiler();
+
+			/**
+			 * Starts sampling. Does nothing if the profiler is
+			 * already running.
+			 *
+			 * @returns true if the profiler is running, false if it couldn't be started
+			 * @author John M. Harris, Jr.
+			 */
+			bool start();
+
+			/**
+			 * Stops sampling. Samples collected so far are kept
+			 * until reset is called.
+			 *
+			 * @author John M. Harris, Jr.
+			 */
+			void stop();
+
+			/**
+			 * Returns whether or not the profiler is currently
+			 * sampling.
+			 *
+			 * @returns bool
+			 * @author John M. Harris, Jr.
+			 */
+			bool isRunning();
+
+			/**
+			 * Returns the interval between samples, in
+			 * microseconds.
+			 *
+			 * @returns Sample interval
+			 * @author John M. Harris, Jr.
+			 */
+			unsigned int getSampleInterval();
+
+			/**
+			 * Sets the interval between samples, in
+			 * microseconds. Takes effect on the next sample.
+			 *
+			 * @param interval Sample interval
+			 * @author John M. Harris, Jr.
+			 */
+			void setSampleInterval(unsigned int interval);
+
+			/**
+			 * Discards all collected samples.
+			 *
+			 * @author John M. Harris, Jr.
+			 */
+			void reset();
+
+			/**
+			 * Returns the total number of samples collected.
+			 *
+			 * @returns Number of samples
+			 * @author John M. Harris, Jr.
+			 */
+			ob_uint64 getSampleCount();
+
+			/**
+			 * Returns collected samples in folded stack format.
+			 *
+			 * @returns Folded stacks
+			 * @author John M. Harris, Jr.
+			 */
+			std::string getFoldedStacks();
+
+			/**
+			 * Writes collected samples in folded stack format to
+			 * a file.
+			 *
+			 * @param path File to write to
+			 * @returns true on success, otherwise false
+			 * @author John M. Harris, Jr.
+			 */
+			bool dumpFoldedStacks(std::string path);
+
+			/**
+			 * Used internally by the Lua hook to record the stack
+			 * of a Lua state, if a sample is due.
+			 *
+			 * @param L Lua state
+			 * @author John M. Harris, Jr.
+			 */
+			void sample(lua_State* L);
+
+			/**
+			 * Used internally by the timer thread.
+			 *
+			 * @author John M. Harris, Jr.
+			 */
+			void timerLoop();
+
+		private:
+			OBEngine* eng;
+
+			std::atomic<bool> running;
+			std::atomic<bool> sampleDue;
+			std::atomic<unsigned int> sampleInterval;
+
+			pthread_t timerThread;
+
+			pthread_mutex_t mmutex;
+			std::map<std::string, ob_uint64> stacks;
+			ob_uint64 sampleCount;
+	};
+}
+
+#endif // OB_LUAPROFILER
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef OB_MPSCQUEUE
+#define OB_MPSCQUEUE
+
+#include <atomic>
+#include <cstddef>
+
+namespace OB{
+	/**
+	 * Unbounded lock-free queue with any number of producers and a
+	 * single consumer, after Dmitry Vyukov's intrusive MPSC node
+	 * queue. push never blocks and is safe from any thread. pop
+	 * must only ever be called from one thread at a time.
+	 *
+	 * pop can briefly report the queue as empty while a push is in
+	 * progress on another thread. That item is returned by a later
+	 * pop.
+	 *
+	 * @author John M. Harris, Jr.
+	 */
+	template <typename T> class MPSCQueue{
+		public:
+			MPSCQueue(){
+				stub.next.store(NULL, std::memory_order_relaxed);
+				head.store(&stub, std::memory_order_relaxed);
+				tail = &stub;
+			}
+
+			virtual ~MPSCQueue(){
+				T discard;
+				while(pop(discard)){}
+			}
+
+			/**
+			 * Adds an item to the back of the queue.
+			 *
+			 * @param value Item
+			 * @author John M. Harris, Jr.
+			 */
+			void push(const T& value){
+				node* n = new node;
+				n->value = value;
+				n->next.store(NULL, std::memory_order_relaxed);
+
+				pushNode(n);
+			}
+
+			/**
+			 * Takes the item at the front of the queue.
+			 *
+			 * @param out Set to the item
+			 * @returns false if the queue is empty
+			 * @author John M. Harris, Jr.
+			 */
+			bool pop(T& out){
+				node* t = tail;
+				node* next = t->next.load(std::memory_order_acquire);
+
+				if(t == &stub){
+					if(next == NULL){
+						return false;
+					}
+					tail = next;
+					t = next;
+					next = next->next.load(std::memory_order_acquire);
+				}
+
+				if(next){
+					tail = next;
+					out = t->value;
+					delete t;
+					return true;
+				}
+
+				// t is the last node. If a producer is between its
+				// exchange and linking, wait for a later pop.
+				if(t != head.load(std::memory_order_acquire)){
+					return false;
+				}
+
+				// Put the stub back behind t, so t can be unlinked
+				pushNode(&stub);
+
+				next = t->next.load(std::memory_order_acquire);
+				if(next){
+					tail = next;
+					out = t->value;
+					delete t;
+					return true;
+				}
+
+				return false;
+			}
+
+		private:
+			struct node{
+				std::atomic<node*> next;
+				T value;
+			};
+
+			void pushNode(node* n){
+				n->next.store(NULL, std::memory_order_relaxed);
+				node* prev = head.exchange(n, std::memory_order_acq_rel);
+				prev->next.store(n, std::memory_order_release);
+			}
+
+			// Producers push here
+			std::atomic<node*> head;
+			// Only touched by the consumer
+			node* tail;
+			node stub;
+	};
+}
+
+#endif // OB_MPSCQUEUE
+
+// Local Variables:
+// mode: c++
+// End:
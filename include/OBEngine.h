@@ -36,13 +36,19 @@
 
 #include "OBLogger.h"
 #include "AssetLocator.h"
+#include "DownloadManager.h"
+#include "ImageDecoder.h"
 #include "OBSerializer.h"
 #include "PluginManager.h"
+#include "LuaProfiler.h"
+#include "WorkerPool.h"
+#include "BulletTaskScheduler.h"
 #include "OBRenderUtils.h"
 
 #include "OBInputEventReceiver.h"
 
 #include <lua/OBLua.h>
+#include <lua/OBLuaAllocator.h>
 
 #include <instance/DataModel.h>
 
@@ -82,6 +88,9 @@ namespace OB{
 #ifndef OB_FONTMANAGER
 	class FontManager;
 #endif
+	namespace Type{
+		class EventQueue;
+	}
 
 #if HAVE_IRRLICHT
 	typedef std::function<void(irr::video::IVideoDriver*)> post_render_func_t;
@@ -385,6 +394,30 @@ namespace OB{
 			 */
 			shared_ptr<AssetLocator> getAssetLocator();
 
+#if HAVE_CURL
+			/**
+			 * Returns the DownloadManager that runs remote
+			 * transfers for assets and HttpService. This is NULL
+			 * until init is called.
+			 *
+			 * @returns DownloadManager
+			 * @author John M. Harris, Jr.
+			 */
+			shared_ptr<DownloadManager> getDownloadManager();
+#endif
+
+#if HAVE_SDL2
+			/**
+			 * Returns the ImageDecoder that decodes image assets
+			 * on the worker threads. This is NULL until init is
+			 * called.
+			 *
+			 * @returns ImageDecoder
+			 * @author John M. Harris, Jr.
+			 */
+			shared_ptr<ImageDecoder> getImageDecoder();
+#endif
+
 			/**
 			 * Returns the PluginManager associated with this OBEngine
 			 * instance.
@@ -402,6 +435,82 @@ namespace OB{
 			 */
 			shared_ptr<OBLogger> getLogger();
 
+			/**
+			 * Returns the Lua profiler.
+			 *
+			 * @returns LuaProfiler
+			 * @author John M. Harris, Jr.
+			 */
+			shared_ptr<LuaProfiler> getLuaProfiler();
+
+			/**
+			 * Returns the allocator used by the global Lua state
+			 * and every thread created from it. This can be used
+			 * to inspect Lua memory usage, or to set a memory limit.
+			 *
+			 * @returns LuaAllocator
+			 * @author John M. Harris, Jr.
+			 */
+			shared_ptr<Lua::LuaAllocator> getLuaAllocator();
+
+			/**
+			 * Returns the queue of deferred event connections
+			 * fired on this engine, which is drained every tick.
+			 *
+			 * @returns EventQueue
+			 * @author John M. Harris, Jr.
+			 */
+			shared_ptr<Type::EventQueue> getEventQueue();
+
+			/**
+			 * Returns the pool of worker threads used to run
+			 * work, such as physics, off the main thread. This
+			 * is NULL until init is called.
+			 *
+			 * @returns WorkerPool
+			 * @author John M. Harris, Jr.
+			 */
+			shared_ptr<WorkerPool> getWorkerPool();
+
+			/**
+			 * Returns the number of worker threads. Defaults to
+			 * one less than the number of hardware threads.
+			 *
+			 * @returns Number of worker threads
+			 * @author John M. Harris, Jr.
+			 */
+			int getWorkerThreads();
+
+			/**
+			 * Sets the number of worker threads. 0 runs all work
+			 * on the main thread. This can be changed at any
+			 * time, but not from a worker thread.
+			 *
+			 * @param numThreads Number of worker threads
+			 * @author John M. Harris, Jr.
+			 */
+			void setWorkerThreads(int numThreads);
+
+			/**
+			 * Returns the directory remote assets are cached in
+			 * between runs, or an empty string if there is none.
+			 *
+			 * @returns Asset cache directory
+			 * @author John M. Harris, Jr.
+			 */
+			std::string getAssetCacheDirectory();
+
+			/**
+			 * Sets the directory remote assets are cached in
+			 * between runs. Several engines, even in different
+			 * processes, may share the same directory. Empty by
+			 * default, which disables the disk cache.
+			 *
+			 * @param dir Asset cache directory
+			 * @author John M. Harris, Jr.
+			 */
+			void setAssetCacheDirectory(std::string dir);
+
 			/**
 			 * Returns the input event receiver.
 			 *
@@ -425,6 +534,8 @@ namespace OB{
 			bool vsync;
 			void* windowId;
 			bool resizable;
+			int workerThreads;
+			std::string assetCacheDir;
 
 			lua_State* globalState;
 
@@ -452,9 +563,22 @@ namespace OB{
 			shared_ptr<TaskScheduler> taskSched;
 			shared_ptr<TaskScheduler> secondaryTaskSched;
 			shared_ptr<AssetLocator> assetLocator;
+#if HAVE_CURL
+			shared_ptr<DownloadManager> downloadManager;
+#endif
+#if HAVE_SDL2
+			shared_ptr<ImageDecoder> imageDecoder;
+#endif
 			shared_ptr<PluginManager> pluginManager;
 			shared_ptr<OBSerializer> serializer;
 			shared_ptr<OBLogger> logger;
+			shared_ptr<LuaProfiler> luaProfiler;
+			shared_ptr<Lua::LuaAllocator> luaAllocator;
+			shared_ptr<Type::EventQueue> eventQueue;
+			shared_ptr<WorkerPool> workerPool;
+#if HAVE_BULLET_MT
+			BulletTaskScheduler* bulletTaskSched;
+#endif
 			shared_ptr<Instance::DataModel> dm;
 	};
 }
@@ -25,6 +25,8 @@
 #include "obtype.h"
 #include "mem.h"
 
+#include "TextureCache.h"
+
 #if HAVE_IRRLICHT
 #include <irrlicht/irrlicht.h>
 
@@ -84,6 +86,40 @@ namespace OB{
 			 */
 			irr::IrrlichtDevice* getIrrlichtDevice();
 
+			/**
+			 * Returns the shared texture cache.
+			 *
+			 * @returns TextureCache
+			 * @author John M. Harris, Jr.
+			 */
+			shared_ptr<TextureCache> getTextureCache();
+
+			/**
+			 * Returns the texture of an image asset from the
+			 * texture cache, creating it if the asset is loaded.
+			 * The image is decoded on the worker threads when
+			 * possible, in which case this returns NULL and sets
+			 * pending until it's ready to be uploaded.
+			 *
+			 * Every texture returned has to be given back with
+			 * releaseTexture.
+			 *
+			 * @param url URL of the image
+			 * @param flags OB_TEXTURE_ flags
+			 * @param pending Set if the texture isn't ready yet
+			 * @returns Texture, or NULL
+			 * @author John M. Harris, Jr.
+			 */
+			irr::video::ITexture* acquireTexture(std::string url, int flags, bool& pending);
+
+			/**
+			 * Gives back a texture returned by acquireTexture.
+			 *
+			 * @param tex Texture, may be NULL
+			 * @author John M. Harris, Jr.
+			 */
+			void releaseTexture(irr::video::ITexture* tex);
+
 			// STATIC FUNCTIONS
 
 #if HAVE_SDL2
@@ -100,6 +136,8 @@ namespace OB{
 			irr::IrrlichtDevice* irrDev;
 			irr::video::IVideoDriver* irrDriv;
 			irr::scene::ISceneManager* irrSceneMgr;
+
+			shared_ptr<TextureCache> textureCache;
 	};
 }
 
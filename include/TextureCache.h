@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef OB_TEXTURECACHE
+#define OB_TEXTURECACHE
+
+#include "obtype.h"
+#include "mem.h"
+
+#include "oblibconfig.h"
+
+#include <string>
+#include <map>
+
+#if HAVE_IRRLICHT
+#include <irrlicht/irrlicht.h>
+#endif
+
+/**
+ * Texture flag: create mip maps. Textures drawn at their own size,
+ * like 2D interface images, don't need them.
+ */
+#define OB_TEXTURE_MIPMAPS 1
+
+namespace OB{
+	class OBEngine;
+
+	/**
+	 * Creates and destroys textures for TextureCache. Implemented by
+	 * IrrlichtTextureDriver, and by mock drivers to exercise the
+	 * cache without a GPU.
+	 *
+	 * Textures are opaque to the cache, which only passes them back
+	 * to the driver.
+	 *
+	 * @author John M. Harris, Jr.
+	 */
+	class TextureDriver{
+		public:
+			virtual ~TextureDriver();
+
+			/**
+			 * Creates a texture from an image asset.
+			 *
+			 * @param url URL of the image
+			 * @param flags OB_TEXTURE_ flags
+			 * @param pending Set if the image isn't ready yet and
+			 * this should be tried again later
+			 * @returns Texture, or NULL
+			 * @author John M. Harris, Jr.
+			 */
+			virtual void* createTexture(std::string url, int flags, bool& pending) = 0;
+
+			/**
+			 * Destroys a texture made by createTexture.
+			 *
+			 * @param tex Texture
+			 * @author John M. Harris, Jr.
+			 */
+			virtual void destroyTexture(void* tex) = 0;
+
+			/**
+			 * Returns roughly how much video memory a texture
+			 * takes, including mip maps.
+			 *
+			 * @param tex Texture
+			 * @returns Bytes
+			 * @author John M. Harris, Jr.
+			 */
+			virtual size_t getTextureMemory(void* tex) = 0;
+	};
+
+	/**
+	 * Identifies a texture in TextureCache. Internal to
+	 * TextureCache.
+	 */
+	struct _ob_texture_key{
+		public:
+			std::string url;
+			int flags;
+
+			bool operator<(const struct _ob_texture_key& other) const;
+	};
+
+	/**
+	 * A texture held by TextureCache. Internal to TextureCache.
+	 */
+	struct _ob_texture_entry{
+		public:
+			void* tex;
+			size_t memory;
+			int refs;
+	};
+
+	/**
+	 * Shares textures between everything drawing the same image.
+	 * Textures are keyed by URL and flags and reference counted:
+	 * each acquire is matched by a release, and a texture is
+	 * destroyed as soon as its last user releases it.
+	 *
+	 * Only used from the render thread.
+	 *
+	 * @author John M. Harris, Jr.
+	 */
+	class TextureCache{
+		public:
+			TextureCache(shared_ptr<TextureDriver> driver);
+			virtual ~TextureCache();
+
+			/**
+			 * Returns the texture of an image asset, creating it
+			 * if needed, and adds a reference to it.
+			 *
+			 * @param url URL of the image
+			 * @param flags OB_TEXTURE_ flags
+			 * @param pending Set if the texture isn't ready yet and
+			 * this should be tried again later
+			 * @returns Texture, or NULL
+			 * @author John M. Harris, Jr.
+			 */
+			void* acquire(std::string url, int flags, bool& pending);
+
+			/**
+			 * Drops a reference added by acquire, destroying the
+			 * texture if it was the last one. Does nothing for
+			 * NULL or textures this cache doesn't know.
+			 *
+			 * @param tex Texture
+			 * @author John M. Harris, Jr.
+			 */
+			void release(void* tex);
+
+			/**
+			 * Returns the number of textures held.
+			 *
+			 * @returns Texture count
+			 * @author John M. Harris, Jr.
+			 */
+			size_t getTextureCount();
+
+			/**
+			 * Returns roughly how much video memory the held
+			 * textures take.
+			 *
+			 * @returns Bytes
+			 * @author John M. Harris, Jr.
+			 */
+			size_t getTextureMemory();
+
+			/**
+			 * Returns the number of times acquire found an
+			 * existing texture.
+			 *
+			 * @returns Hit count
+			 * @author John M. Harris, Jr.
+			 */
+			ob_uint64 getHits();
+
+			/**
+			 * Returns the number of textures acquire had to
+			 * create.
+			 *
+			 * @returns Miss count
+			 * @author John M. Harris, Jr.
+			 */
+			ob_uint64 getMisses();
+
+			/**
+			 * Returns the number of textures destroyed because
+			 * their last user released them.
+			 *
+			 * @returns Eviction count
+			 * @author John M. Harris, Jr.
+			 */
+			ob_uint64 getEvictions();
+
+		private:
+			shared_ptr<TextureDriver> driver;
+
+			std::map<struct _ob_texture_key, struct _ob_texture_entry> textures;
+			std::map<void*, struct _ob_texture_key> keys;
+
+			size_t textureMemory;
+			ob_uint64 hits;
+			ob_uint64 misses;
+			ob_uint64 evictions;
+	};
+
+#if HAVE_IRRLICHT
+	/**
+	 * TextureDriver for the Irrlicht video driver. Images are
+	 * decoded by the engine's ImageDecoder when there is one, and
+	 * by Irrlicht's own loaders otherwise.
+	 *
+	 * @author John M. Harris, Jr.
+	 */
+	class IrrlichtTextureDriver: public TextureDriver{
+		public:
+			IrrlichtTextureDriver(OBEngine* eng, irr::video::IVideoDriver* irrDriv);
+			virtual ~IrrlichtTextureDriver();
+
+			virtual void* createTexture(std::string url, int flags, bool& pending);
+			virtual void destroyTexture(void* tex);
+			virtual size_t getTextureMemory(void* tex);
+
+		private:
+			OBEngine* eng;
+			irr::video::IVideoDriver* irrDriv;
+	};
+#endif
+}
+
+#endif // OB_TEXTURECACHE
+
+// Local Variables:
+// mode: c++
+// End:
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "obtype.h"
+
+#include <vector>
+#include <deque>
+#include <atomic>
+
+#include <pthread.h>
+
+#ifndef OB_WORKERPOOL
+#define OB_WORKERPOOL
+
+namespace OB{
+	/**
+	 * Function type of a job queued with WorkerPool::enqueue.
+	 */
+	typedef void (*ob_worker_fnc)(void* ud);
+
+	/**
+	 * Function type of the body of WorkerPool::parallelFor, called
+	 * with the half-open range [iBegin, iEnd).
+	 */
+	typedef void (*ob_parallel_for_fnc)(void* ud, int iBegin, int iEnd);
+
+	/**
+	 * A parallelFor in progress. Internal to WorkerPool.
+	 */
+	struct _ob_worker_batch{
+		ob_parallel_for_fnc fnc;
+		void* ud;
+		int iEnd;
+		int grainSize;
+		std::atomic<int> next;
+		// Workers currently running chunks, guarded by the pool mutex
+		int users;
+	};
+
+	/**
+	 * A job queued with WorkerPool::enqueue. Internal to WorkerPool.
+	 */
+	struct _ob_worker_job{
+		ob_worker_fnc fnc;
+		void* ud;
+	};
+
+	/**
+	 * Pool of worker threads owned by the engine, shared by
+	 * everything that wants to run work off the main thread, such
+	 * as the physics simulation.
+	 *
+	 * parallelFor splits a range into chunks that are run by the
+	 * workers and the calling thread together, and returns once
+	 * they are all done. enqueue runs a single job on the next free
+	 * worker without waiting for it.
+	 *
+	 * Threads are never stopped when the pool shrinks, extra
+	 * workers just sleep until it grows again. This keeps the set
+	 * of threads stable for libraries, like Bullet, that give each
+	 * thread a permanent index.
+	 *
+	 * @author John M. Harris, Jr.
+	 */
+	class WorkerPool{
+		public:
+			WorkerPool(int numThreads);
+			virtual ~WorkerPool();
+
+			/**
+			 * Returns the number of worker threads in use, not
+			 * counting the threads calling parallelFor.
+			 *
+			 * @returns Number of workers
+			 * @author John M. Harris, Jr.
+			 */
+			int getNumThreads();
+
+			/**
+			 * Sets the number of worker threads in use. 0 runs
+			 * everything on the calling thread.
+			 *
+			 * @param numThreads Number of workers
+			 * @author John M. Harris, Jr.
+			 */
+			void setNumThreads(int numThreads);
+
+			/**
+			 * Queues a job to be run on a worker thread. If the
+			 * pool has no workers, the job runs immediately on
+			 * the calling thread. Jobs that haven't started when
+			 * the pool is destroyed are dropped.
+			 *
+			 * @param fnc Job
+			 * @param ud Passed to fnc
+			 * @author John M. Harris, Jr.
+			 */
+			void enqueue(ob_worker_fnc fnc, void* ud);
+
+			/**
+			 * Calls fnc over [iBegin, iEnd) in chunks of at most
+			 * grainSize, spread over the workers and the calling
+			 * thread, and waits for all of them to finish.
+			 *
+			 * Only one parallelFor runs on the workers at a time,
+			 * a nested or concurrent call runs on the calling
+			 * thread alone.
+			 *
+			 * @param iBegin First index
+			 * @param iEnd One past the last index
+			 * @param grainSize Largest chunk size
+			 * @param fnc Loop body
+			 * @param ud Passed to fnc
+			 * @author John M. Harris, Jr.
+			 */
+			void parallelFor(int iBegin, int iEnd, int grainSize, ob_parallel_for_fnc fnc, void* ud);
+
+			/**
+			 * Returns the number of workers used by default: one
+			 * less than the number of hardware threads, since
+			 * the main thread takes part in parallelFor.
+			 *
+			 * @returns Default number of workers
+			 * @author John M. Harris, Jr.
+			 */
+			static int getDefaultNumThreads();
+
+			/**
+			 * Used internally by worker threads.
+			 *
+			 * @param idx Index of this worker
+			 * @author John M. Harris, Jr.
+			 */
+			void workerLoop(int idx);
+
+		private:
+			static void runChunks(struct _ob_worker_batch* batch);
+
+			pthread_mutex_t mmutex;
+			pthread_cond_t workCond;
+			pthread_cond_t doneCond;
+
+			std::vector<pthread_t> threads;
+			int numActive;
+			bool stopping;
+
+			struct _ob_worker_batch* batch;
+			std::deque<struct _ob_worker_job> jobs;
+	};
+}
+
+#endif // OB_WORKERPOOL
+
+// Local Variables:
+// mode: c++
+// End:
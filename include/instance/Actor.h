@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "instance/Instance.h"
+
+#include "BitStream.h"
+#include "lua/OBLuaAllocator.h"
+
+#include <deque>
+#include <set>
+#include <atomic>
+
+#include <pthread.h>
+
+#ifndef OB_INST_ACTOR
+#define OB_INST_ACTOR
+
+/**
+ * Number of Lua instructions an Actor runs between checks of
+ * whether it has been asked to stop.
+ */
+#define OB_ACTOR_HOOK_COUNT 1000
+
+namespace OB{
+	namespace Instance{
+		/**
+		 * Work queued for an Actor's worker thread.
+		 *
+		 * @author John M. Harris, Jr.
+		 */
+		struct _ob_actor_job{
+			bool isScript;
+			// Chunk name for scripts, topic for messages
+			std::string name;
+			std::string source;
+			shared_ptr<BitStream> args;
+		};
+
+		/**
+		 * A property write requested by an Actor, applied at the
+		 * next sync point.
+		 *
+		 * @author John M. Harris, Jr.
+		 */
+		struct _ob_actor_write{
+			std::string path;
+			std::string prop;
+			shared_ptr<BitStream> val;
+		};
+
+		/**
+		 * A message or log line sent from an Actor to the main
+		 * thread, delivered at the next sync point.
+		 *
+		 * @author John M. Harris, Jr.
+		 */
+		struct _ob_actor_out{
+			bool isLog;
+			OBLogLevel logLevel;
+			std::string topic;
+			shared_ptr<BitStream> args;
+		};
+
+		/**
+		 * Scripts placed under an Actor don't run on the main Lua
+		 * state. Instead, each Actor has its own isolated Lua state
+		 * running on its own worker thread, so independent Actors
+		 * run in parallel.
+		 *
+		 * Code running in an Actor has no direct access to the
+		 * DataModel. It uses the 'actor' library instead:
+		 *
+		 * actor.send(topic, ...) fires MessageReceived on the Actor
+		 * instance on the main thread.
+		 *
+		 * actor.receive(topic, fnc) calls fnc for every message sent
+		 * to this Actor with Actor:SendMessage(topic, ...).
+		 *
+		 * actor.get(path, property) reads a property from a snapshot
+		 * taken on the main thread. The first read of a property
+		 * waits for the next sync point, after which it is kept up
+		 * to date every tick.
+		 *
+		 * actor.set(path, property, value) buffers a property write,
+		 * which is applied at the next sync point.
+		 *
+		 * Paths are '.' separated names, relative to the Actor, or
+		 * to the DataModel if they start with "game". Messages and
+		 * property values are serialized with BitStream::writeVar,
+		 * and only nil, booleans, numbers and strings cross into an
+		 * Actor.
+		 *
+		 * @author John M. Harris, Jr.
+		 */
+		class Actor: public Instance{
+			public:
+				Actor(OBEngine* eng);
+				virtual ~Actor();
+
+				/**
+				 * Queues Lua source to be run on this Actor's
+				 * worker thread, starting the worker if needed.
+				 *
+				 * @param chunkName Chunk name, used in errors
+				 * @param source Lua source
+				 * @author John M. Harris, Jr.
+				 */
+				void runSource(std::string chunkName, std::string source);
+
+				/**
+				 * Sends a message to handlers registered in this
+				 * Actor with actor.receive.
+				 *
+				 * @param topic Message topic
+				 * @param args Message arguments
+				 * @author John M. Harris, Jr.
+				 */
+				void SendMessage(std::string topic, std::vector<shared_ptr<Type::VarWrapper>> args);
+
+				/**
+				 * Applies buffered writes, delivers outgoing
+				 * messages and refreshes the property snapshot.
+				 * Must be called from the main thread.
+				 *
+				 * @author John M. Harris, Jr.
+				 */
+				void sync();
+
+				/**
+				 * Calls sync on every running Actor belonging to
+				 * an engine. Called from OBEngine::tick.
+				 *
+				 * @param eng Engine
+				 * @author John M. Harris, Jr.
+				 */
+				static void syncAll(OBEngine* eng);
+
+				/**
+				 * Stops the worker once this Actor is no longer
+				 * in the DataModel.
+				 *
+				 * @author John M. Harris, Jr.
+				 */
+				virtual void ancestryUpdated();
+
+				/**
+				 * Used internally by the worker thread.
+				 *
+				 * @author John M. Harris, Jr.
+				 */
+				void workerLoop();
+
+				// Used by the 'actor' library, on the worker thread
+				void postMessage(std::string topic, shared_ptr<BitStream> args);
+				void postLog(std::string message, OBLogLevel logLevel);
+				void postWrite(std::string path, std::string prop, shared_ptr<BitStream> val);
+				shared_ptr<Type::VarWrapper> readSnapshot(std::string path, std::string prop);
+				bool isStopRequested();
+
+				DECLARE_LUA_METHOD(SendMessage);
+
+				static void register_lua_methods(lua_State* L);
+				static void register_lua_events(lua_State* L);
+
+				DECLARE_CLASS(Actor);
+
+				shared_ptr<Type::Event> MessageReceived;
+
+			private:
+				void startWorker();
+				void stopWorker();
+				void initState();
+				void runJob(struct _ob_actor_job job);
+
+				shared_ptr<Instance> resolvePath(std::string path);
+
+				bool workerRunning;
+				// Also read without the mutex, by the stop hook
+				std::atomic<bool> stopRequested;
+				pthread_t workerThread;
+
+				pthread_mutex_t mmutex;
+				pthread_cond_t workCond;
+				pthread_cond_t snapCond;
+
+				lua_State* aL;
+				shared_ptr<Lua::LuaAllocator> allocator;
+
+				std::deque<struct _ob_actor_job> inbox;
+				std::vector<struct _ob_actor_out> outbox;
+				std::vector<struct _ob_actor_write> writes;
+
+				std::map<std::string, shared_ptr<Type::VarWrapper>> snapshot;
+				std::set<std::string> watched;
+				ob_uint64 snapshotGen;
+		};
+	}
+}
+
+#endif // OB_INST_ACTOR
+
+
+// Local Variables:
+// mode: c++
+// End:
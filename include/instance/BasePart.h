@@ -25,12 +25,25 @@
 #include <irrlicht/irrlicht.h>
 #endif
 
+#if HAVE_BULLET
+#include <btBulletDynamicsCommon.h>
+#endif
+
 #include "type/Color3.h"
 #include "type/Vector3.h"
 
 #ifndef OB_INST_BASEPART
 #define OB_INST_BASEPART
 
+/*
+ * Collision filter groups. Parts with CanCollide set only
+ * collide with each other, parts without it don't collide with
+ * anything, and both are visible to queries such as raycasts.
+ */
+#define OB_PHYS_GROUP_COLLIDE 1
+#define OB_PHYS_GROUP_NOCOLLIDE 2
+#define OB_PHYS_GROUP_QUERY 4
+
 namespace OB{
 	namespace Instance{
 		/**
@@ -69,6 +82,62 @@ namespace OB{
 				virtual void updatePosition();
 				virtual void updateRotation();
 
+				virtual void ancestryUpdated();
+
+#if HAVE_BULLET
+				/**
+				 * Returns the collision shape used for this part's
+				 * rigid body, or NULL if it has no physical shape.
+				 *
+				 * @returns Collision shape
+				 * @author John M. Harris, Jr.
+				 */
+				virtual shared_ptr<btCollisionShape> getCollisionShape();
+
+				/**
+				 * Returns the mass this part has when it isn't
+				 * anchored.
+				 *
+				 * @returns Mass
+				 * @author John M. Harris, Jr.
+				 */
+				virtual double getMass();
+
+				/**
+				 * Returns this part's rigid body, or NULL if it
+				 * isn't in a Workspace.
+				 *
+				 * @returns Rigid body
+				 * @author John M. Harris, Jr.
+				 */
+				btRigidBody* getRigidBody();
+
+				/**
+				 * Rebuilds this part's rigid body after its shape
+				 * or mass changed.
+				 *
+				 * @author John M. Harris, Jr.
+				 */
+				void updatePhysicsShape();
+
+				/**
+				 * Called by Workspace after a simulation step moved
+				 * this part's rigid body, to copy its transform
+				 * back to Position and Rotation.
+				 *
+				 * @author John M. Harris, Jr.
+				 */
+				void physicsMoved();
+
+				/**
+				 * Removes this part's rigid body from the physics
+				 * world it is in, if any.
+				 *
+				 * @author John M. Harris, Jr.
+				 */
+				void leavePhysicsWorld();
+#endif
+
 #if HAVE_ENET
 				/**
 				 * Replicates properties of this Instance.
@@ -110,6 +179,17 @@ namespace OB{
 				double Transparency;
 				shared_ptr<Type::Vector3> Position;
 				shared_ptr<Type::Vector3> Rotation;
+
+#if HAVE_BULLET
+				void enterPhysicsWorld(btDiscreteDynamicsWorld* world);
+				void updatePhysicsFlags();
+				void updatePhysicsTransform();
+				btTransform getBulletTransform();
+
+				btDiscreteDynamicsWorld* physWorld;
+				btRigidBody* rigidBody;
+				shared_ptr<btCollisionShape> collisionShape;
+#endif
 		};
 	}
 }
@@ -19,6 +19,8 @@
 
 #include "instance/Instance.h"
 
+#include "type/Enum.h"
+
 #ifndef OB_INST_CONTENTPROVIDER
 #define OB_INST_CONTENTPROVIDER
 
@@ -39,16 +41,24 @@ namespace OB{
 				shared_ptr<Type::Event> GetAssetLoaded();
 				shared_ptr<Type::Event> GetAssetLoadFailed();
 
-				void Preload(std::string url);
+				void Preload(std::string url, Enum::AssetPriority priority = Enum::AssetPriority::Default);
 				void Load(std::string url);
-				char* GetAsset(std::string url);
+				shared_ptr<AssetResponse> GetAsset(std::string url);
 
 				virtual std::string fixedSerializedID();
 
 				DECLARE_LUA_METHOD(Preload);
+				DECLARE_LUA_METHOD(PreloadAsync);
 				DECLARE_LUA_METHOD(Load);
 				DECLARE_LUA_METHOD(GetAsset);
 				DECLARE_LUA_METHOD(getRequestQueueSize);
+				DECLARE_LUA_METHOD(getCacheMemoryUsage);
+				DECLARE_LUA_METHOD(getCacheMemoryBudget);
+				DECLARE_LUA_METHOD(setCacheMemoryBudget);
+				DECLARE_LUA_METHOD(getCacheHitCount);
+				DECLARE_LUA_METHOD(getCacheMissCount);
+				DECLARE_LUA_METHOD(getCacheEvictionCount);
+				DECLARE_LUA_METHOD(getPreloadProgress);
 
 				static void register_lua_methods(lua_State* L);
 				static void register_lua_property_getters(lua_State* L);
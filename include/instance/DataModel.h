@@ -197,6 +197,44 @@ namespace OB{
 				virtual shared_ptr<Type::VarWrapper> getProperty(std::string prop);
 				virtual void setProperty(std::string prop, shared_ptr<Type::VarWrapper> val);
 
+				/**
+				 * Ticks every tickable Instance in this DataModel.
+				 * Instances added during a tick are first ticked on
+				 * the next one.
+				 *
+				 * @author John M. Harris, Jr.
+				 */
+				virtual void tick();
+
+				/**
+				 * Adds an Instance to the list ticked by this
+				 * DataModel. Called by Instance when a tickable
+				 * Instance moves into this DataModel.
+				 *
+				 * @param inst Instance
+				 * @author John M. Harris, Jr.
+				 */
+				void addTickable(shared_ptr<Instance> inst);
+
+				/**
+				 * Removes an Instance from the list ticked by this
+				 * DataModel. Instances that are destroyed without
+				 * being removed are dropped on the next tick.
+				 *
+				 * @param inst Instance
+				 * @author John M. Harris, Jr.
+				 */
+				void removeTickable(shared_ptr<Instance> inst);
+
+				/**
+				 * Returns the number of Instances ticked by this
+				 * DataModel.
+				 *
+				 * @returns Number of tickable Instances
+				 * @author John M. Harris, Jr.
+				 */
+				size_t getTickableCount();
+
 				virtual void preRender();
 				virtual void render();
 
@@ -226,6 +264,17 @@ namespace OB{
 				std::map<ob_uint64, weak_ptr<Instance>> instMap;
 				std::vector<ob_uint64> freedNetIDs;
 
+				/*
+				 * Entries are matched by owner, so an entry can be
+				 * found even once its Instance is gone. Entries
+				 * removed while ticking are reset and erased
+				 * afterwards along with expired ones, so the loop
+				 * never shifts.
+				 */
+				std::vector<weak_ptr<Instance>> tickables;
+				bool ticking;
+				bool tickablesDirty;
+
 				static void register_lua_methods(lua_State* L);
 		};
 	}
@@ -19,11 +19,68 @@
 
 #include "instance/Instance.h"
 
+#include "DownloadManager.h"
+
+#include <list>
+
 #ifndef OB_INST_HTTPSERVICE
 #define OB_INST_HTTPSERVICE
 
+/**
+ * Default number of HttpService requests run at once against a
+ * single host.
+ */
+#define OB_HTTP_DEFAULT_MAX_PER_HOST 4
+
+/**
+ * Default size of the HttpService response cache, in bytes.
+ */
+#define OB_HTTP_CACHE_DEFAULT_BUDGET (4 * 1024 * 1024)
+
 namespace OB{
 	namespace Instance{
+#if HAVE_CURL
+		/**
+		 * A request waiting for, or holding, one of the slots of
+		 * its host. Internal to HttpService.
+		 */
+		struct _ob_http_request{
+			weak_ptr<Instance> svc;
+			std::string host;
+			bool cacheable;
+			shared_ptr<struct _ob_download_request> req;
+			ob_download_fnc callback;
+			void* ud;
+			// Lua thread kept alive until callback has run, or NULL
+			lua_State* L;
+			int threadRef;
+		};
+#endif
+
+		/**
+		 * A cached GET response. Internal to HttpService.
+		 */
+		struct _ob_http_cache_entry{
+			std::string body;
+			ob_uint64 expires;
+			std::list<std::string>::iterator lruIt;
+		};
+
+		/**
+		 * The HttpService class lets scripts make HTTP requests.
+		 *
+		 * From Lua, GetAsync and PostAsync yield the calling
+		 * script while the request runs on the DownloadManager,
+		 * and resume it from the engine tick once it's done, so
+		 * a slow server never stalls the game. Only a few
+		 * requests run against any one host at a time, the rest
+		 * wait their turn.
+		 *
+		 * Successful GET responses are kept in memory for as long
+		 * as their Cache-Control or Expires headers allow.
+		 *
+		 * @author John M. Harris, Jr.
+		 */
 		class HttpService: public Instance{
 			public:
 			    HttpService(OBEngine* eng);
@@ -31,13 +88,160 @@ namespace OB{
 
 				virtual std::string fixedSerializedID();
 
-				DECLARE_CLASS(HttpService);
-
+				/**
+				 * Fetches a URL, waiting for the response. Unlike
+				 * the Lua method, this blocks the calling thread
+				 * and doesn't count against the per-host limit.
+				 *
+				 * @param url URL
+				 * @param nocache Skip the response cache
+				 * @returns Response body
+				 * @author John M. Harris, Jr.
+				 */
 				std::string GetAsync(std::string url, bool nocache);
+
+				/**
+				 * Posts data to a URL, waiting for the response.
+				 * Like GetAsync, this blocks the calling thread.
+				 *
+				 * @param url URL
+				 * @param data Request body
+				 * @param contentType Content type, 0 to 3, JSON otherwise
+				 * @returns Response body
+				 * @author John M. Harris, Jr.
+				 */
 				std::string PostAsync(std::string url, std::string data, int contentType);
 				std::string UrlEncode(std::string input);
 				std::string UrlDecode(std::string input);
 				std::string GenerateGUID(bool wrapInCurlyBraces);
+
+#if HAVE_CURL
+				/**
+				 * Runs a request without waiting for it. The
+				 * request is held back while the maximum number
+				 * of requests to its host are running. callback
+				 * is called from the engine tick once it's done.
+				 * If the HttpService goes away first, the request
+				 * fails instead.
+				 *
+				 * @param req Request, its callback is replaced
+				 * @param cacheable Whether a successful response may be cached
+				 * @param callback Called with the finished request
+				 * @param ud Passed to callback
+				 * @param L Lua thread to keep alive until callback has run, or NULL
+				 * @author John M. Harris, Jr.
+				 */
+				void request(shared_ptr<struct _ob_download_request> req, bool cacheable, ob_download_fnc callback, void* ud, lua_State* L = NULL);
+
+				/**
+				 * Used internally when a request started by
+				 * request is done.
+				 *
+				 * @param hreq Request
+				 * @author John M. Harris, Jr.
+				 */
+				void finishRequest(struct _ob_http_request* hreq);
+#endif
+
+				/**
+				 * Looks up a fresh cached response to a GET.
+				 *
+				 * @param url URL
+				 * @param body Set to the response body on a hit
+				 * @returns true on a hit
+				 * @author John M. Harris, Jr.
+				 */
+				bool getCachedResponse(std::string url, std::string& body);
+
+				/**
+				 * Returns the number of bytes of response bodies
+				 * kept in the cache.
+				 *
+				 * @returns Cache size
+				 * @author John M. Harris, Jr.
+				 */
+				size_t getCacheSize();
+
+				/**
+				 * Returns the size the response cache is kept
+				 * under.
+				 *
+				 * @returns Cache budget, in bytes
+				 * @author John M. Harris, Jr.
+				 */
+				size_t getCacheBudget();
+
+				/**
+				 * Sets the size the response cache is kept under.
+				 * 0 disables the cache.
+				 *
+				 * @param budget Cache budget, in bytes
+				 * @author John M. Harris, Jr.
+				 */
+				void setCacheBudget(size_t budget);
+
+				/**
+				 * Empties the response cache.
+				 *
+				 * @author John M. Harris, Jr.
+				 */
+				void clearCache();
+
+				/**
+				 * Returns the number of requests run at once
+				 * against a single host.
+				 *
+				 * @returns Maximum requests per host
+				 * @author John M. Harris, Jr.
+				 */
+				int getMaxRequestsPerHost();
+
+				/**
+				 * Sets the number of requests run at once against
+				 * a single host.
+				 *
+				 * @param maxPerHost Maximum requests per host, at least 1
+				 * @author John M. Harris, Jr.
+				 */
+				void setMaxRequestsPerHost(int maxPerHost);
+
+				/**
+				 * Returns the host part of a URL, including the
+				 * port if there is one, in lower case.
+				 *
+				 * @param url URL
+				 * @returns Host
+				 * @author John M. Harris, Jr.
+				 */
+				static std::string getHost(std::string url);
+
+				DECLARE_LUA_METHOD(GetAsync);
+				DECLARE_LUA_METHOD(PostAsync);
+
+				static void register_lua_methods(lua_State* L);
+
+				DECLARE_CLASS(HttpService);
+
+			private:
+#if HAVE_CURL
+				void startRequest(struct _ob_http_request* hreq);
+				void storeResponse(shared_ptr<struct _ob_download_request> req);
+
+				std::map<std::string, int> hostActive;
+				std::map<std::string, std::deque<struct _ob_http_request*> > hostQueue;
+#endif
+				int maxPerHost;
+
+				// Evicts least recently used responses, cacheMutex must be held
+				void trimCache();
+
+				// Guarded by cacheMutex, GetAsync may be called from any thread
+				pthread_mutex_t cacheMutex;
+				std::map<std::string, struct _ob_http_cache_entry> cache;
+				// Most recently used first
+				std::list<std::string> cacheLRU;
+				size_t cacheSize;
+				size_t cacheBudget;
 		};
 	}
 }
@@ -217,6 +217,7 @@ protected: \
 namespace OB{
 	namespace Instance{
 		class NetworkReplicator;
+		class DataModel;
 
 		struct _PropertyInfo{
 			public:
@@ -371,6 +372,23 @@ namespace OB{
 				 */
 				virtual std::string GetFullName();
 
+				/**
+				 * Returns an Event that fires whenever one property
+				 * of this Instance changes, including changes
+				 * replicated from a server. Unlike Changed, it only
+				 * wakes listeners of that property and is fired
+				 * without arguments.
+				 *
+				 * Events are created the first time they're asked
+				 * for, so properties nobody watches cost nothing.
+				 *
+				 * @param property Name of the property
+				 * @returns Event, or NULL if there is no such property
+				 *
+				 * @author John M. Harris, Jr.
+				 */
+				shared_ptr<Type::Event> GetPropertyChangedSignal(std::string property);
+
 				/**
 				 * Used for class inheritance checking.
 				 * @param name Name of the class to test against.
@@ -495,7 +513,10 @@ namespace OB{
 				virtual void setProperty(std::string prop, shared_ptr<Type::VarWrapper> val);
 
 				/**
-				 * Called internally every tick.
+				 * Called internally every tick, but only for
+				 * Instances that set tickable in their constructor.
+				 * Their children aren't ticked along with them,
+				 * tickable descendants are ticked on their own.
 				 *
 				 * @author John M. Harris, Jr.
 				 */
@@ -518,7 +539,8 @@ namespace OB{
 				virtual void render();
 
 				/**
-				 * Convenience method to call tick on all children.
+				 * Convenience method to call tick on all children,
+				 * whether or not they are tickable.
 
 				 * @author John M. Harris, Jr.
 				 */
@@ -555,6 +577,18 @@ namespace OB{
 				virtual void removeChild(shared_ptr<Instance> kid);
 				virtual void addChild(shared_ptr<Instance> kid);
 
+				/**
+				 * Called on this Instance and every one of its
+				 * descendants after the Parent of this Instance
+				 * changes. Subclasses that depend on their
+				 * ancestors, such as parts that join the physics
+				 * world of the Workspace they are in, override this
+				 * and set ancestryAware in their constructor.
+				 *
+				 * @author John M. Harris, Jr.
+				 */
+				virtual void ancestryUpdated();
+
 				/**
 				 * Returns the current Parent of this Instance.
 				 *
@@ -579,12 +613,14 @@ namespace OB{
 				static shared_ptr<Instance> checkInstance(lua_State* L, int index, bool errIfNot = true, bool allowNil = true);
 
 				/**
-				 * Handles attempts to set properties of this Instance.
+				 * Handles attempts to get properties, methods or
+				 * events of this Instance. The first upvalue is
+				 * the table built by buildLuaIndexTable.
 				 *
 				 * @param L Lua State
 				 *
-				 * @returns 0 or error (Does not return if an
-				 * error occurs)
+				 * @returns 1 if there is a corresponding value,
+				 * otherwise errors. (No return)
 				 *
 				 * @author DigiTechs
 				 * @author John M. Harris, Jr.
@@ -592,13 +628,29 @@ namespace OB{
 				static int lua_index(lua_State* L);
 
 				/**
-				 * Handles attempts to get properties, methods or
-				 * events of this Instance.
+				 * Builds the flattened lookup table used by
+				 * lua_index from the method, property getter and
+				 * event tables of a class metatable, and leaves it
+				 * on top of the stack. Property getters take
+				 * precedence over methods, which take precedence
+				 * over events.
 				 *
 				 * @param L Lua State
+				 * @param metatable Index of the class metatable
 				 *
-				 * @returns 1 if there is a corresponding value,
-				 * otherwise errors. (No return)
+				 * @author John M. Harris, Jr.
+				 */
+				static void buildLuaIndexTable(lua_State* L, int metatable);
+
+				/**
+				 * Handles attempts to set properties of this
+				 * Instance. The first upvalue is the property
+				 * setter table of the class.
+				 *
+				 * @param L Lua State
+				 *
+				 * @returns 0 or error (Does not return if an
+				 * error occurs)
 				 *
 				 * @author DigiTechs
 				 * @author John M. Harris, Jr.
@@ -671,6 +723,7 @@ namespace OB{
 				DECLARE_LUA_METHOD(FindFirstChildWhichIsA);
 				DECLARE_LUA_METHOD(GetChildren);
 				DECLARE_LUA_METHOD(GetFullName);
+				DECLARE_LUA_METHOD(GetPropertyChangedSignal);
 				DECLARE_LUA_METHOD(IsA);
 				DECLARE_LUA_METHOD(IsAncestorOf);
 				DECLARE_LUA_METHOD(IsDescendantOf);
@@ -764,12 +817,65 @@ namespace OB{
 				std::string Name;
 				shared_ptr<Instance> Parent;
 
-				void fireAncestryChanged(std::vector<shared_ptr<Type::VarWrapper>> args);
-				void fireDescendantAdded(std::vector<shared_ptr<Type::VarWrapper>> args);
-				void fireDescendantRemoving(std::vector<shared_ptr<Type::VarWrapper>> args);
+				void fireAncestryChanged(const std::vector<shared_ptr<Type::VarWrapper>>& args);
+				void fireDescendantAdded(const std::vector<shared_ptr<Type::VarWrapper>>& args);
+				void fireDescendantRemoving(const std::vector<shared_ptr<Type::VarWrapper>>& args);
 				virtual void propertyChanged(std::string property);
 				static void propertyChanged(std::string property, shared_ptr<Instance> inst);
 
+				void notifyAncestryUpdated();
+
+				/*
+				 * Instances that do work in tick set tickable in
+				 * their constructor. While they are in a DataModel,
+				 * it keeps them in a flat list that it ticks, so
+				 * the rest of the tree costs nothing per tick.
+				 */
+				bool tickable;
+				weak_ptr<DataModel> tickDataModel;
+
+				void updateTickRegistration();
+
+				/*
+				 * Instances that override ancestryUpdated set
+				 * ancestryAware in their constructor.
+				 *
+				 * ancestryDependents counts the descendants of this
+				 * Instance that are tickable or ancestryAware, so
+				 * notifyAncestryUpdated can skip subtrees with
+				 * nothing in them that cares where they are.
+				 */
+				bool ancestryAware;
+				int ancestryDependents;
+
+				bool needsAncestryUpdates();
+				void adjustAncestryDependents(int delta);
+
+				// Created on first use by GetPropertyChangedSignal
+				std::map<std::string, shared_ptr<Type::Event>> propertyChangedSignals;
+
+				/*
+				 * Listener counts used to skip building and firing
+				 * hierarchy events nobody is listening to.
+				 *
+				 * descendantListeners counts DescendantAdded and
+				 * DescendantRemoving listeners on this Instance and
+				 * all of its ancestors, so a walk up the tree can stop
+				 * as soon as it reaches 0.
+				 *
+				 * ancestryListeners counts AncestryChanged listeners
+				 * on this Instance and all of its descendants, so a
+				 * walk down the tree can skip empty subtrees.
+				 */
+				int descendantListeners;
+				int ancestryListeners;
+
+				void adjustDescendantListeners(int delta);
+				void adjustAncestryListeners(int delta);
+
+				static void descendantListenersChanged(Type::Event* evt, int delta, void* ud);
+				static void ancestryListenersChanged(Type::Event* evt, int delta, void* ud);
+
 				ob_int64 netId;
 
 				std::vector<shared_ptr<Instance>> children;
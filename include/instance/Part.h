@@ -25,6 +25,10 @@
 #include <irrlicht/irrlicht.h>
 #endif
 
+#if HAVE_BULLET
+#include <tuple>
+#endif
+
 #ifndef OB_INST_PART
 #define OB_INST_PART
 
@@ -46,6 +50,25 @@ namespace OB{
 				virtual void updateSize();
 				virtual void updateColor();
 
+#if HAVE_BULLET
+				/**
+				 * Returns a box shape matching Size. Parts of the
+				 * same size share one shape.
+				 *
+				 * @returns Collision shape
+				 * @author John M. Harris, Jr.
+				 */
+				virtual shared_ptr<btCollisionShape> getCollisionShape();
+
+				/**
+				 * Returns the volume of this part.
+				 *
+				 * @returns Mass
+				 * @author John M. Harris, Jr.
+				 */
+				virtual double getMass();
+#endif
+
 #if HAVE_ENET
 				/**
 				 * Replicates properties of this Instance.
@@ -73,6 +96,13 @@ namespace OB{
 				DECLARE_CLASS(Part);
 
 				shared_ptr<Type::Vector3> Size;
+
+#if HAVE_BULLET
+				typedef std::tuple<double, double, double> BoxShapeKey;
+
+				// Shapes are removed when the last part using them goes away
+				static std::map<BoxShapeKey, weak_ptr<btBoxShape>> boxShapeCache;
+#endif
 		};
 	}
 }
@@ -99,6 +99,16 @@ namespace OB{
 #if HAVE_IRRLICHT
 				void updateSkyBox();
 
+				/**
+				 * Lets go of a face texture. It's released once the
+				 * scene node has been rebuilt without it.
+				 *
+				 * @param tex Face texture, set to NULL
+				 * @author John M. Harris, Jr.
+				 */
+				void dropTexture(irr::video::ITexture*& tex);
+				void releaseStaleTextures();
+
 				virtual bool assetLoaded(std::string res);
 
 				bool skybox_needs_updating;
@@ -109,6 +119,8 @@ namespace OB{
 				irr::video::ITexture* right_tex;
 				irr::video::ITexture* front_tex;
 				irr::video::ITexture* back_tex;
+				// Dropped textures the scene node may still be using
+				std::vector<irr::video::ITexture*> stale_tex;
 
 				bool top_loading;
 				bool bottom_loading;
@@ -66,9 +66,21 @@ namespace OB{
 
 				void updateSkyDome();
 
+				/**
+				 * Lets go of the dome texture. It's released once the
+				 * scene node has been rebuilt without it.
+				 *
+				 * @param tex Dome texture, set to NULL
+				 * @author John M. Harris, Jr.
+				 */
+				void dropTexture(irr::video::ITexture*& tex);
+				void releaseStaleTextures();
+
 				virtual bool assetLoaded(std::string res);
 
 				irr::video::ITexture* dome_tex;
+				// Dropped textures the scene node may still be using
+				std::vector<irr::video::ITexture*> stale_tex;
 
 				irr::scene::ISceneNode* irrNode;
 #endif
@@ -18,6 +18,7 @@
  */
 
 #include "instance/Model.h"
+#include "instance/BasePart.h"
 
 #include "type/Vector3.h"
 
@@ -25,13 +26,47 @@
 
 #if HAVE_BULLET
 #include <btBulletDynamicsCommon.h>
+
+#if HAVE_BULLET_MT
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#endif
 #endif
 
 #ifndef OB_INST_WORKSPACE
 #define OB_INST_WORKSPACE
 
+// Length of one physics step, in seconds
+#define OB_PHYSICS_STEP (1.0 / 60.0)
+
+// Most steps taken in one tick, the rest of the time is dropped
+#define OB_PHYSICS_MAX_STEPS 4
+
 namespace OB{
 	namespace Instance{
+		/**
+		 * Limits the parts returned by a spatial query. Parts that
+		 * are in instances, or are descendants of them, are left
+		 * out, or if include is true, are the only ones returned.
+		 *
+		 * @author John M. Harris, Jr.
+		 */
+		struct _ob_query_filter{
+			std::vector<shared_ptr<Instance>> instances;
+			bool include;
+		};
+
+		/**
+		 * Result of a raycast. part is NULL if nothing was hit.
+		 *
+		 * @author John M. Harris, Jr.
+		 */
+		struct _ob_raycast_result{
+			shared_ptr<BasePart> part;
+			shared_ptr<Type::Vector3> position;
+			shared_ptr<Type::Vector3> normal;
+		};
+
 		/**
 		 * Workspace contains all physics objects that will be
 		 * rendered by the engine.
@@ -45,6 +80,16 @@ namespace OB{
 
 				double getDistributedGameTime();
 
+				/**
+				 * Returns how long one physics step took, in
+				 * milliseconds, averaged over the steps taken in
+				 * the last tick that stepped.
+				 *
+				 * @returns Physics step time
+				 * @author John M. Harris, Jr.
+				 */
+				double getPhysicsStepTime();
+
 				shared_ptr<Instance> getCurrentCamera();
 				void setCurrentCamera(shared_ptr<Instance> inst);
 
@@ -57,6 +102,79 @@ namespace OB{
 				bool getDestroyFallenParts();
 				void setDestroyFallenParts(bool dfp);
 
+#if HAVE_BULLET
+				/**
+				 * Returns the physics world parts in this Workspace
+				 * are simulated in.
+				 *
+				 * @returns Dynamics world
+				 * @author John M. Harris, Jr.
+				 */
+				btDiscreteDynamicsWorld* getDynamicsWorld();
+#endif
+
+				/**
+				 * Casts a ray from origin along direction, whose
+				 * length is the length of the ray, and returns the
+				 * first part hit.
+				 *
+				 * @param origin Start of the ray
+				 * @param direction Direction and length of the ray
+				 * @param filter Parts to leave out or look at
+				 * @returns First hit
+				 * @author John M. Harris, Jr.
+				 */
+				struct _ob_raycast_result Raycast(shared_ptr<Type::Vector3> origin, shared_ptr<Type::Vector3> direction, const struct _ob_query_filter& filter);
+
+				/**
+				 * Casts many rays at once, which are spread over the
+				 * engine's worker threads when Bullet allows it.
+				 * origins and directions must be the same length.
+				 *
+				 * @param origins Start of each ray
+				 * @param directions Direction and length of each ray
+				 * @param filter Parts to leave out or look at
+				 * @returns First hit of each ray
+				 * @author John M. Harris, Jr.
+				 */
+				std::vector<struct _ob_raycast_result> RaycastMany(const std::vector<shared_ptr<Type::Vector3>>& origins, const std::vector<shared_ptr<Type::Vector3>>& directions, const struct _ob_query_filter& filter);
+
+				/**
+				 * Returns the parts whose bounding boxes overlap the
+				 * axis aligned box from min to max.
+				 *
+				 * @param min Minimum corner
+				 * @param max Maximum corner
+				 * @param filter Parts to leave out or look at
+				 * @param maxParts Most parts returned, or 0 for all
+				 * @returns Parts
+				 * @author John M. Harris, Jr.
+				 */
+				std::vector<shared_ptr<BasePart>> FindPartsInRegion3(shared_ptr<Type::Vector3> min, shared_ptr<Type::Vector3> max, const struct _ob_query_filter& filter, int maxParts);
+
+				/**
+				 * Returns the parts that touch the sphere around
+				 * center.
+				 *
+				 * @param center Center of the sphere
+				 * @param radius Radius of the sphere
+				 * @param filter Parts to leave out or look at
+				 * @param maxParts Most parts returned, or 0 for all
+				 * @returns Parts
+				 * @author John M. Harris, Jr.
+				 */
+				std::vector<shared_ptr<BasePart>> GetPartsInRadius(shared_ptr<Type::Vector3> center, double radius, const struct _ob_query_filter& filter, int maxParts);
+
+				/**
+				 * Steps the physics simulation in fixed steps of
+				 * OB_PHYSICS_STEP seconds, copies the transforms of
+				 * bodies that moved back to their parts and destroys
+				 * parts that fell below FallenPartsDestroyHeight.
+				 *
+				 * @author John M. Harris, Jr.
+				 */
+				virtual void tick();
+
 #if HAVE_ENET
 				/**
 				 * Replicates properties of this Instance.
@@ -74,6 +192,7 @@ namespace OB{
 				virtual void setProperty(std::string prop, shared_ptr<Type::VarWrapper> val);
 
 				DECLARE_LUA_METHOD(getDistributedGameTime);
+				DECLARE_LUA_METHOD(getPhysicsStepTime);
 				DECLARE_LUA_METHOD(getCurrentCamera);
 				DECLARE_LUA_METHOD(setCurrentCamera);
 				DECLARE_LUA_METHOD(getGravity);
@@ -83,6 +202,12 @@ namespace OB{
 				DECLARE_LUA_METHOD(getDestroyFallenParts);
 				DECLARE_LUA_METHOD(setDestroyFallenParts);
 
+				DECLARE_LUA_METHOD(Raycast);
+				DECLARE_LUA_METHOD(RaycastMany);
+				DECLARE_LUA_METHOD(FindPartsInRegion3);
+				DECLARE_LUA_METHOD(GetPartsInRadius);
+
+				static void register_lua_methods(lua_State* L);
 				static void register_lua_property_getters(lua_State* L);
 				static void register_lua_property_setters(lua_State* L);
 
@@ -91,10 +216,16 @@ namespace OB{
 				void updateGravity();
 
 #if HAVE_BULLET
+				void stepPhysics();
+
+				ob_uint64 lastPhysicsTick;
+				double physicsAccumulator;
+				double physicsStepTime;
+
 				btBroadphaseInterface* broadphase;
 				btDefaultCollisionConfiguration* collisionConfiguration;
 				btCollisionDispatcher* dispatcher;
-				btSequentialImpulseConstraintSolver* solver;
+				btConstraintSolver* solver;
 				btDiscreteDynamicsWorld* dynamicsWorld;
 #endif
 
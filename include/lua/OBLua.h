@@ -158,6 +158,50 @@ namespace OB{
 		 */
 		void setDMBound(lua_State* L, bool dmBound);
 
+		/**
+		 * Sets a debug hook on every Lua state known to the engine.
+		 * Passing NULL as the hook removes hooks from all states.
+		 * Threads created afterwards inherit the hook of the state
+		 * they are created from.
+		 *
+		 * @param eng Engine whose states should be hooked
+		 * @param hook Hook function, or NULL
+		 * @param mask Hook event mask
+		 * @param count Instruction count, used with LUA_MASKCOUNT
+		 * @author John M. Harris, Jr.
+		 */
+		void set_hook_all(OBEngine* eng, lua_Hook hook, int mask, int count);
+
+		/**
+		 * Pushes the values a parked Lua state is resumed with, and
+		 * returns how many were pushed. Used with resume_later.
+		 */
+		typedef int (*ob_lua_resume_fnc)(lua_State* L, void* ud);
+
+		/**
+		 * Resumes a Lua state parked with lua_yield from the engine's
+		 * TaskScheduler, the way wait does. The state stays parked
+		 * while the game is paused if it gets paused, and is dropped
+		 * with the DataModel if it is DM bound.
+		 *
+		 * The state is kept from being collected until it has been
+		 * resumed, so this also works for threads that nothing else
+		 * refers to, like one from coroutine.wrap that was dropped.
+		 *
+		 * pushArgs runs on the TaskScheduler right before the state
+		 * is resumed, so it is also where ud should be freed. If
+		 * false is returned, pushArgs will never run, and ud is
+		 * still the caller's to free.
+		 *
+		 * @param L Parked Lua state
+		 * @param pushArgs Pushes the resume arguments, or NULL for none
+		 * @param ud Passed to pushArgs
+		 * @param blockLogService Block the LogService while the state runs
+		 * @returns true if the state will be resumed, false if it has no engine
+		 * @author John M. Harris, Jr.
+		 */
+		bool resume_later(lua_State* L, ob_lua_resume_fnc pushArgs, void* ud, bool blockLogService = false);
+
 		/**
 		 * Used internally to handle errors. Returns a Lua error as a
 		 * string.
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef OB_LUA_OBLUAALLOCATOR
+#define OB_LUA_OBLUAALLOCATOR
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Largest block size, in bytes, served from slabs. Anything larger
+ * goes straight to malloc.
+ *
+ * @author John M. Harris, Jr.
+ */
+#define OB_LUAALLOC_MAX_SMALL 256
+
+/**
+ * Distance between size classes, in bytes. This is also the
+ * alignment of every small block.
+ *
+ * @author John M. Harris, Jr.
+ */
+#define OB_LUAALLOC_GRANULARITY 16
+
+/**
+ * Number of small size classes.
+ *
+ * @author John M. Harris, Jr.
+ */
+#define OB_LUAALLOC_NUM_CLASSES (OB_LUAALLOC_MAX_SMALL / OB_LUAALLOC_GRANULARITY)
+
+/**
+ * Size of each slab requested from malloc, in bytes.
+ *
+ * @author John M. Harris, Jr.
+ */
+#define OB_LUAALLOC_SLAB_SIZE 65536
+
+namespace OB{
+	namespace Lua{
+		/**
+		 * Allocator used for Lua states created by OpenBlox.
+		 *
+		 * Small blocks (up to OB_LUAALLOC_MAX_SMALL bytes) are
+		 * carved out of large slabs and recycled through one free
+		 * list per size class, which keeps the many tiny strings,
+		 * tables and closures Lua creates away from the system
+		 * allocator. Larger blocks fall back to malloc.
+		 *
+		 * One allocator is used per Lua universe (everything
+		 * created from a single lua_newstate), and a Lua universe
+		 * is only ever used from one thread at a time, so the
+		 * allocator does no locking of its own.
+		 *
+		 * The allocator also keeps track of how many bytes are in
+		 * use, and can enforce a hard memory limit. When an
+		 * allocation would exceed the limit it fails, which Lua
+		 * reports as a memory error in the script that caused it.
+		 *
+		 * @author John M. Harris, Jr.
+		 */
+		class LuaAllocator{
+			public:
+				LuaAllocator();
+				virtual ~LuaAllocator();
+
+				/**
+				 * lua_Alloc compatible function. The ud parameter
+				 * must be a LuaAllocator*.
+				 *
+				 * @param ud LuaAllocator
+				 * @param ptr Block being reallocated or freed, or NULL
+				 * @param osize Original size of the block
+				 * @param nsize New size of the block
+				 * @returns Allocated block, or NULL
+				 * @author John M. Harris, Jr.
+				 */
+				static void* l_alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+				/**
+				 * Allocates, reallocates or frees a block, with the
+				 * same semantics as lua_Alloc.
+				 *
+				 * @param ptr Block being reallocated or freed, or NULL
+				 * @param osize Original size of the block
+				 * @param nsize New size of the block
+				 * @returns Allocated block, or NULL
+				 * @author John M. Harris, Jr.
+				 */
+				void* allocate(void* ptr, size_t osize, size_t nsize);
+
+				/**
+				 * Returns the number of bytes currently allocated
+				 * by Lua through this allocator.
+				 *
+				 * @returns Bytes in use
+				 * @author John M. Harris, Jr.
+				 */
+				size_t getBytesInUse();
+
+				/**
+				 * Returns the highest number of bytes that have
+				 * been in use at once.
+				 *
+				 * @returns Peak bytes in use
+				 * @author John M. Harris, Jr.
+				 */
+				size_t getPeakBytes();
+
+				/**
+				 * Returns the number of bytes held in slabs,
+				 * whether or not they are in use.
+				 *
+				 * @returns Slab bytes
+				 * @author John M. Harris, Jr.
+				 */
+				size_t getSlabBytes();
+
+				/**
+				 * Returns the memory limit, in bytes. 0 means
+				 * there is no limit.
+				 *
+				 * @returns Memory limit
+				 * @author John M. Harris, Jr.
+				 */
+				size_t getMemoryLimit();
+
+				/**
+				 * Sets the memory limit, in bytes. 0 means there
+				 * is no limit. Lowering the limit below the
+				 * current usage doesn't free anything, it only
+				 * causes further growth to fail.
+				 *
+				 * @param limit Memory limit
+				 * @author John M. Harris, Jr.
+				 */
+				void setMemoryLimit(size_t limit);
+
+			private:
+				struct FreeBlock{
+					FreeBlock* next;
+				};
+
+				void* allocSmall(size_t sizeClass);
+				void freeSmall(void* ptr, size_t sizeClass);
+
+				FreeBlock* freeLists[OB_LUAALLOC_NUM_CLASSES];
+
+				std::vector<void*> slabs;
+				char* slabCur;
+				char* slabEnd;
+
+				size_t bytesInUse;
+				size_t peakBytes;
+				size_t slabBytes;
+				size_t memoryLimit;
+		};
+	}
+}
+
+#endif // OB_LUA_OBLUAALLOCATOR
+
+// Local Variables:
+// mode: c++
+// End:
@@ -21,6 +21,17 @@
 #define OPENBLOX_MEM_H
 
 #include <memory>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+/**
+ * Largest number of free blocks of one size a thread keeps for reuse.
+ * Blocks freed past this go back to the system allocator.
+ *
+ * @author John M. Harris, Jr.
+ */
+#define OB_POOL_MAX_FREE_BLOCKS 1024
 
 namespace OB{
 	using std::make_shared;
@@ -28,6 +39,159 @@ namespace OB{
 	using std::weak_ptr;
 	using std::dynamic_pointer_cast;
 	using std::unique_ptr;
+
+	/**
+	 * Free list of fixed size blocks, one per thread. Freed blocks
+	 * are kept for reuse instead of going back to the system, so
+	 * once a program has warmed up, allocating and freeing blocks
+	 * rarely touches malloc.
+	 *
+	 * Each block is its own allocation, so any thread can free it.
+	 * A block freed on a different thread than the one it was
+	 * allocated on joins the freeing thread's list. Each list holds
+	 * at most OB_POOL_MAX_FREE_BLOCKS blocks, anything past that is
+	 * given back with operator delete. This keeps threads that only
+	 * free, like the main thread freeing results made on worker
+	 * threads, from growing their list without bound. A thread's
+	 * list is given back when the thread exits.
+	 *
+	 * @author John M. Harris, Jr.
+	 */
+	template<size_t BlockSize>
+	class _ob_block_pool{
+		public:
+			static void* allocate(){
+				FreeBlock*& head = getHead();
+
+				if(!head){
+					return ::operator new(stride);
+				}
+
+				FreeBlock* blk = head;
+				head = blk->next;
+				getCount()--;
+				return blk;
+			}
+
+			static void deallocate(void* ptr){
+				size_t& count = getCount();
+
+				if(count >= OB_POOL_MAX_FREE_BLOCKS || getExited()){
+					::operator delete(ptr);
+					return;
+				}
+
+				// Make sure this thread's list is drained when it exits
+				if(count == 0){
+					getDrain();
+				}
+
+				FreeBlock*& head = getHead();
+
+				FreeBlock* blk = static_cast<FreeBlock*>(ptr);
+				blk->next = head;
+				head = blk;
+				count++;
+			}
+
+		private:
+			struct FreeBlock{
+				FreeBlock* next;
+			};
+
+			// Gives a thread's free blocks back when the thread exits
+			struct Drain{
+				~Drain(){
+					FreeBlock*& head = getHead();
+					while(head){
+						FreeBlock* blk = head;
+						head = blk->next;
+						::operator delete(blk);
+					}
+					getCount() = 0;
+
+					// Blocks freed by later thread_local destructors skip the list
+					getExited() = true;
+				}
+			};
+
+			static const size_t stride = BlockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : BlockSize;
+
+			static FreeBlock*& getHead(){
+				static thread_local FreeBlock* head = NULL;
+				return head;
+			}
+
+			static size_t& getCount(){
+				static thread_local size_t count = 0;
+				return count;
+			}
+
+			static bool& getExited(){
+				static thread_local bool exited = false;
+				return exited;
+			}
+
+			static Drain& getDrain(){
+				static thread_local Drain drain;
+				return drain;
+			}
+	};
+
+	/**
+	 * Standard allocator backed by _ob_block_pool. Single objects
+	 * come from the pool for their size, arrays go to operator
+	 * new.
+	 *
+	 * @author John M. Harris, Jr.
+	 */
+	template<class T>
+	class PoolAllocator{
+		public:
+			typedef T value_type;
+
+			PoolAllocator(){}
+
+			template<class U>
+			PoolAllocator(const PoolAllocator<U>&){}
+
+			T* allocate(size_t n){
+				if(n == 1){
+					return static_cast<T*>(_ob_block_pool<sizeof(T)>::allocate());
+				}
+				return static_cast<T*>(::operator new(n * sizeof(T)));
+			}
+
+			void deallocate(T* ptr, size_t n){
+				if(n == 1){
+					_ob_block_pool<sizeof(T)>::deallocate(ptr);
+					return;
+				}
+				::operator delete(ptr);
+			}
+
+			template<class U>
+			bool operator==(const PoolAllocator<U>&) const{
+				return true;
+			}
+
+			template<class U>
+			bool operator!=(const PoolAllocator<U>&) const{
+				return false;
+			}
+	};
+
+	/**
+	 * Like make_shared, but the object and its control block come
+	 * from a PoolAllocator. Use this for small, short lived
+	 * objects that are created very often, like Vector3.
+	 *
+	 * @author John M. Harris, Jr.
+	 */
+	template<class T, class... Args>
+	shared_ptr<T> make_pooled(Args&&... args){
+		return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+	}
 }
 
 #endif
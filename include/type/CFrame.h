@@ -18,6 +18,7 @@
  */
 
 #include "type/Type.h"
+#include "type/CFrameKernels.h"
 
 #include "oblibconfig.h"
 
@@ -123,6 +124,71 @@ namespace OB{
 
 				shared_ptr<CFrame> lerp(shared_ptr<CFrame> goal, double alpha);
 
+				/**
+				 * Returns the inverse of this CFrame, or NULL if it
+				 * can't be inverted.
+				 *
+				 * @returns Inverse CFrame
+				 * @author John M. Harris, Jr.
+				 */
+				shared_ptr<CFrame> inverse();
+
+				/**
+				 * Transforms a point from this CFrame's object space
+				 * into world space.
+				 *
+				 * @param v Point
+				 * @returns Transformed point
+				 * @author John M. Harris, Jr.
+				 */
+				shared_ptr<Vector3> pointToWorldSpace(shared_ptr<Vector3> v);
+
+				/**
+				 * Rotates a direction from this CFrame's object
+				 * space into world space, ignoring the position.
+				 *
+				 * @param v Direction
+				 * @returns Rotated direction
+				 * @author John M. Harris, Jr.
+				 */
+				shared_ptr<Vector3> vectorToWorldSpace(shared_ptr<Vector3> v);
+
+				/**
+				 * Transforms count points, packed as x, y, z
+				 * triples, into world space. out may be the same
+				 * array as in.
+				 *
+				 * @param in Points in object space
+				 * @param out Points in world space
+				 * @param count Number of points
+				 * @author John M. Harris, Jr.
+				 */
+				void pointsToWorldSpace(const double* in, double* out, size_t count);
+
+				/**
+				 * Rotates count directions, packed as x, y, z
+				 * triples, into world space. out may be the same
+				 * array as in.
+				 *
+				 * @param in Directions in object space
+				 * @param out Directions in world space
+				 * @param count Number of directions
+				 * @author John M. Harris, Jr.
+				 */
+				void vectorsToWorldSpace(const double* in, double* out, size_t count);
+
+				/**
+				 * Composes this CFrame with count child matrices, as
+				 * if by this * child for each one. out may be the
+				 * same array as children.
+				 *
+				 * @param children Matrices relative to this CFrame
+				 * @param out Resulting matrices
+				 * @param count Number of matrices
+				 * @author John M. Harris, Jr.
+				 */
+				void mulMany(const double (*children)[4][4], double (*out)[4][4], size_t count);
+
 				/**
 				 * Returns the Tait-Bryan Euler angles for the CFrame's orientation in x-y-z order.
 				 *
@@ -175,6 +241,10 @@ namespace OB{
 				static int lua_getP(lua_State* L);
 
 				static int lua_lerp(lua_State* L);
+				static int lua_inverse(lua_State* L);
+				static int lua_pointToWorldSpace(lua_State* L);
+				static int lua_vectorToWorldSpace(lua_State* L);
+				static int lua_pointsToWorldSpace(lua_State* L);
 
 				/**
 				 * Returns (on the %Lua stack) the Euler angles in x-y-z order, or nil.
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef OB_TYPE_CFRAMEKERNELS
+#define OB_TYPE_CFRAMEKERNELS
+
+#include <cstddef>
+#include <string>
+
+namespace OB{
+	namespace Type{
+		/**
+		 * Math kernels used by CFrame, operating directly on 4×4
+		 * row-major matrices laid out like CFrame::m (rows 0-2 are
+		 * the rotation, row 3 is the position).
+		 *
+		 * Several implementations exist: a portable scalar one, and
+		 * SSE2 and AVX2 versions on x86. The best one supported by
+		 * the running CPU is picked the first time get() is called.
+		 *
+		 * Points and vectors are packed as x, y, z triples.
+		 *
+		 * @author John M. Harris, Jr.
+		 */
+		struct CFrameKernels{
+			/**
+			 * Name of this implementation, "scalar", "sse2" or
+			 * "avx2".
+			 */
+			const char* name;
+
+			/**
+			 * out = a × b. out may alias a or b.
+			 */
+			void (*mul)(double out[4][4], const double a[4][4], const double b[4][4]);
+
+			/**
+			 * out[i] = a[i] × b, for count matrices. This is
+			 * how a list of child CFrames is composed with one
+			 * parent. out may alias a.
+			 */
+			void (*mulMany)(double (*out)[4][4], const double (*a)[4][4], const double b[4][4], size_t count);
+
+			/**
+			 * Transforms count points by m, including the
+			 * position. out may alias in.
+			 */
+			void (*transformPoints)(const double m[4][4], const double* in, double* out, size_t count);
+
+			/**
+			 * Transforms count vectors by m, ignoring the
+			 * position. out may alias in.
+			 */
+			void (*transformVectors)(const double m[4][4], const double* in, double* out, size_t count);
+
+			/**
+			 * Returns the fastest implementation supported by
+			 * this CPU.
+			 *
+			 * @returns Kernels
+			 * @author John M. Harris, Jr.
+			 */
+			static const CFrameKernels* get();
+
+			/**
+			 * Returns an implementation by name, or NULL if it
+			 * isn't supported by this build or CPU. Mostly
+			 * useful for comparing implementations.
+			 *
+			 * @param name "scalar", "sse2" or "avx2"
+			 * @returns Kernels, or NULL
+			 * @author John M. Harris, Jr.
+			 */
+			static const CFrameKernels* get(std::string name);
+
+			/**
+			 * Inverts an affine matrix. Returns false, leaving
+			 * out untouched, if the rotation part is singular.
+			 *
+			 * This is dominated by a division and doesn't gain
+			 * anything from SIMD, so there's only one version.
+			 *
+			 * @param out Inverse
+			 * @param in Matrix to invert
+			 * @returns true on success
+			 * @author John M. Harris, Jr.
+			 */
+			static bool inverse(double out[4][4], const double in[4][4]);
+
+			/**
+			 * Interpolates between two rigid transforms. The
+			 * position is interpolated linearly and the rotation
+			 * by spherical linear interpolation of quaternions,
+			 * falling back to a normalized linear interpolation
+			 * when the rotations are nearly the same. out may
+			 * alias a or b.
+			 *
+			 * @param out Result
+			 * @param a Start, returned for alpha = 0
+			 * @param b Goal, returned for alpha = 1
+			 * @param alpha Interpolation factor
+			 * @author John M. Harris, Jr.
+			 */
+			static void lerp(double out[4][4], const double a[4][4], const double b[4][4], double alpha);
+
+			/**
+			 * Calls lerp for count pairs of transforms with the
+			 * same alpha, like the joints of an animation rig
+			 * blending between two poses.
+			 *
+			 * @param out Results
+			 * @param a Start transforms
+			 * @param b Goal transforms
+			 * @param count Number of transforms
+			 * @param alpha Interpolation factor
+			 * @author John M. Harris, Jr.
+			 */
+			static void lerpMany(double (*out)[4][4], const double (*a)[4][4], const double (*b)[4][4], size_t count, double alpha);
+		};
+	}
+}
+
+#endif // OB_TYPE_CFRAMEKERNELS
+
+
+// Local Variables:
+// mode: c++
+// End:
@@ -261,6 +261,12 @@ namespace OB{
 			  Outline,
 			  Middle,
 			  Inset);
+
+		LENUM(AssetPriority,
+			  UI,
+			  Near,
+			  Default,
+			  Far);
 	}
 }
 
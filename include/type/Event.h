@@ -22,9 +22,12 @@
 #include "type/VarWrapper.h"
 
 #include <vector>
+#include <deque>
 
 #include <functional>
 
+#include <pthread.h>
+
 #ifndef OB_TYPE_EVENT
 #define OB_TYPE_EVENT
 
@@ -32,18 +35,82 @@ namespace OB{
 	namespace Type{
 		class EventConnection;
 
+		// A Lua thread parked in Event:Wait()
+		struct evt_waiter_t{
+			lua_State* L;
+			// Registry reference keeping L alive while it's parked
+			int ref;
+		};
+
+		// A connection waiting to be fired by Event::dispatchDeferred
+		struct evt_dispatch_t{
+			shared_ptr<EventConnection> evtCon;
+			shared_ptr<std::vector<shared_ptr<VarWrapper>>> args;
+		};
+
+		/*
+		 * Connections fired but not yet dispatched, in the order
+		 * they were fired. Each OBEngine owns one, so deferred
+		 * connections are only ever run by the engine that fired
+		 * them.
+		 */
+		class EventQueue{
+			public:
+				EventQueue();
+				virtual ~EventQueue();
+
+				void push(const struct evt_dispatch_t& disp);
+
+				/*
+				 * Fires every deferred connection queued before this
+				 * call, in the order they were fired. Called once per
+				 * tick by OBEngine.
+				 */
+				void dispatchDeferred();
+				size_t getDeferredCount();
+
+			private:
+				std::deque<struct evt_dispatch_t> deferred;
+				pthread_mutex_t mmutex;
+		};
+
 		class Event: public Type{
 			public:
 				Event(std::string name, bool canFireFromLua = false, bool blockLogService = false);
 				virtual ~Event();
 
-				shared_ptr<EventConnection> Connect(std::function<void(std::vector<shared_ptr<VarWrapper>>)> fnc);
+				shared_ptr<EventConnection> Connect(std::function<void(const std::vector<shared_ptr<VarWrapper>>&)> fnc);
 				shared_ptr<EventConnection> Connect(void (*fnc)(std::vector<shared_ptr<VarWrapper>>, void*), void* ud);
+				shared_ptr<EventConnection> Connect(void (*fnc)(const std::vector<shared_ptr<VarWrapper>>&, void*), void* ud);
+
+				/*
+				 * Immediate connections are called from inside Fire
+				 * rather than being deferred. Only use this for C++
+				 * listeners that never disconnect or fire events
+				 * re-entrantly.
+				 */
+				shared_ptr<EventConnection> ConnectImmediate(std::function<void(const std::vector<shared_ptr<VarWrapper>>&)> fnc);
 
 				void disconnectAll();
 				void disconnect(shared_ptr<EventConnection> conn);
 				bool isConnected(shared_ptr<EventConnection> conn);
 				bool doesBlockLogService();
+				bool hasWaiters();
+
+				/*
+				 * Cheap check for whether firing this event would do
+				 * anything. Use it to avoid building arguments that
+				 * nobody will see.
+				 */
+				bool hasListeners();
+				size_t getListenerCount();
+
+				/*
+				 * Called with the change in getListenerCount whenever
+				 * a connection or waiter is added or removed. Only
+				 * one hook can be set, pass NULL to clear it.
+				 */
+				void setListenerHook(void (*hook)(Event*, int, void*), void* ud);
 
 				void Fire(OBEngine* eng, std::vector<shared_ptr<VarWrapper>> argList);
 				void Fire(OBEngine* eng);
@@ -56,6 +123,12 @@ namespace OB{
 				bool blockLogService;
 				std::string name;
 				std::vector<shared_ptr<EventConnection>> conns;
+				std::vector<struct evt_waiter_t> waiters;
+
+				void (*listenerHook)(Event*, int, void*);
+				void* listenerHookUd;
+
+				void listenersChanged(int delta);
 
 				static int lua_fire(lua_State* L);
 				static int lua_connect(lua_State* L);
@@ -20,6 +20,7 @@
 #include "type/Type.h"
 
 #include <functional>
+#include <vector>
 
 #ifndef OB_TYPE_EVENTCONNECTION
 #define OB_TYPE_EVENTCONNECTION
@@ -30,14 +31,16 @@ namespace OB{
 
 		class EventConnection: public Type{
 			public:
-				EventConnection(shared_ptr<Event> evt, std::function<void(std::vector<shared_ptr<VarWrapper>>)>);
-				EventConnection(shared_ptr<Event> evt, std::function<void(std::vector<shared_ptr<VarWrapper>>)>, void* ud);
+				EventConnection(shared_ptr<Event> evt, std::function<void(const std::vector<shared_ptr<VarWrapper>>&)>);
+				EventConnection(shared_ptr<Event> evt, std::function<void(const std::vector<shared_ptr<VarWrapper>>&)>, void* ud);
 				virtual ~EventConnection();
 
 				void Disconnect();
 				bool isConnected();
+				bool isImmediate();
+				void setImmediate(bool immediate);
 
-				void fire(std::vector<shared_ptr<VarWrapper>> args);
+				void fire(const std::vector<shared_ptr<VarWrapper>>& args);
 
 				virtual std::string toString();
 
@@ -51,8 +54,9 @@ namespace OB{
 				static void register_lua_property_getters(lua_State* L);
 
 				shared_ptr<Event> evt;
-				std::function<void(std::vector<shared_ptr<VarWrapper>>)> fnc;
+				std::function<void(const std::vector<shared_ptr<VarWrapper>>&)> fnc;
 				void* ud;
+				bool immediate;
 		};
 
 		shared_ptr<EventConnection> checkEventConnection(lua_State* L, int n, bool errIfNot = true, bool allowNil = true);
@@ -36,6 +36,11 @@ namespace OB{
 				shared_ptr<UDim> getX();
 				shared_ptr<UDim> getY();
 
+				double getXScale();
+				double getXOffset();
+				double getYScale();
+				double getYOffset();
+
 				shared_ptr<UDim2> add(shared_ptr<UDim2> v);
 				shared_ptr<UDim2> sub(shared_ptr<UDim2> v);
 				virtual bool equals(shared_ptr<Type> other);
@@ -56,8 +61,10 @@ namespace OB{
 
 				DECLARE_TYPE();
 
-				shared_ptr<UDim> x;
-				shared_ptr<UDim> y;
+				double xScale;
+				double xOffset;
+				double yScale;
+				double yOffset;
 
 		};
 
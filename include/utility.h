@@ -54,6 +54,14 @@ namespace OB{
 	 */
 	ob_uint64 currentTimeMillis();
 
+	/**
+	 * Returns the current time in microseconds.
+	 *
+	 * @returns Current time in micros
+	 * @author John M. Harris, Jr.
+	 */
+	ob_uint64 currentTimeMicros();
+
 	/**
 	 * Returns true if str starts with prefix.
 	 *
@@ -68,6 +76,17 @@ namespace OB{
 	 */
 	bool ob_str_endsWith(std::string str, std::string suffix);
 
+	/**
+	 * Returns the SHA-256 digest of data as 64 lowercase hex
+	 * characters.
+	 *
+	 * @param data Data to hash
+	 * @param len Length of data
+	 * @returns Hex digest
+	 * @author John M. Harris, Jr.
+	 */
+	std::string ob_sha256_hex(const char* data, size_t len);
+
 	enum empties_t{
 		empties_ok,
 		no_empties
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AssetDiskCache.h"
+
+#include "utility.h"
+
+#include <fstream>
+#include <sstream>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace OB{
+	static void _ob_disk_cache_mkdir(std::string path){
+#ifdef _WIN32
+		_mkdir(path.c_str());
+#else
+		mkdir(path.c_str(), 0755);
+#endif
+	}
+
+	AssetDiskCache::AssetDiskCache(std::string dir){
+		if(!dir.empty() && !ob_str_endsWith(dir, "/")){
+			dir = dir + "/";
+		}
+
+		this->dir = dir;
+		tmpCounter = 0;
+
+		// Failures here just show up as misses later
+		_ob_disk_cache_mkdir(dir);
+		_ob_disk_cache_mkdir(dir + "blobs");
+		_ob_disk_cache_mkdir(dir + "index");
+	}
+
+	AssetDiskCache::~AssetDiskCache(){}
+
+	std::string AssetDiskCache::getDirectory(){
+		return dir;
+	}
+
+	std::string AssetDiskCache::blobPath(std::string hash){
+		return dir + "blobs/" + hash;
+	}
+
+	std::string AssetDiskCache::indexPath(std::string url){
+		return dir + "index/" + ob_sha256_hex(url.c_str(), url.size());
+	}
+
+	bool AssetDiskCache::writeAtomic(std::string path, const char* data, size_t size){
+		// Unique per process and per call, so concurrent writers never share a temp file
+#ifdef _WIN32
+		int pid = _getpid();
+#else
+		int pid = getpid();
+#endif
+		std::stringstream tmpName;
+		tmpName << path << ".tmp." << pid << "." << tmpCounter.fetch_add(1);
+		std::string tmpPath = tmpName.str();
+
+		{
+			std::ofstream out(tmpPath.c_str(), std::ios::binary | std::ios::trunc);
+			if(!out){
+				return false;
+			}
+
+			out.write(data, size);
+			out.close();
+
+			if(!out){
+				remove(tmpPath.c_str());
+				return false;
+			}
+		}
+
+#ifdef _WIN32
+		// rename doesn't replace existing files here
+		remove(path.c_str());
+#endif
+
+		if(rename(tmpPath.c_str(), path.c_str()) != 0){
+			remove(tmpPath.c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool AssetDiskCache::lookup(std::string url, struct _ob_disk_cache_entry& entry){
+		std::ifstream in(indexPath(url).c_str(), std::ios::binary);
+		if(!in){
+			return false;
+		}
+
+		std::string sizeStr;
+		if(!std::getline(in, entry.hash) || !std::getline(in, sizeStr)){
+			return false;
+		}
+		std::getline(in, entry.etag);
+		std::getline(in, entry.lastModified);
+
+		if(entry.hash.size() != 64){
+			return false;
+		}
+
+		entry.size = strtoull(sizeStr.c_str(), NULL, 10);
+
+		return true;
+	}
+
+	bool AssetDiskCache::read(struct _ob_disk_cache_entry& entry, char** data){
+		std::ifstream in(blobPath(entry.hash).c_str(), std::ios::binary | std::ios::ate);
+		if(!in){
+			return false;
+		}
+
+		std::streamoff fileLen = in.tellg();
+		if(fileLen < 0 || (size_t)fileLen != entry.size || entry.size == 0){
+			return false;
+		}
+		in.seekg(0, std::ios::beg);
+
+		char* buf = (char*)malloc(entry.size);
+		if(!buf){
+			return false;
+		}
+
+		if(!in.read(buf, entry.size)){
+			free(buf);
+			return false;
+		}
+
+		*data = buf;
+		return true;
+	}
+
+	bool AssetDiskCache::store(std::string url, const char* data, size_t size, std::string etag, std::string lastModified){
+		if(!data || size == 0){
+			return false;
+		}
+
+		std::string hash = ob_sha256_hex(data, size);
+		std::string bPath = blobPath(hash);
+
+		// Same hash, same content. Another process may have written it already.
+		struct stat st;
+		if(stat(bPath.c_str(), &st) != 0 || (size_t)st.st_size != size){
+			if(!writeAtomic(bPath, data, size)){
+				return false;
+			}
+		}
+
+		std::stringstream index;
+		index << hash << "\n" << size << "\n" << etag << "\n" << lastModified << "\n";
+		std::string indexStr = index.str();
+
+		return writeAtomic(indexPath(url), indexStr.c_str(), indexStr.size());
+	}
+}
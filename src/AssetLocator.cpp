@@ -19,6 +19,8 @@
 
 #include "AssetLocator.h"
 
+#include "AssetDiskCache.h"
+#include "DownloadManager.h"
 #include "OBEngine.h"
 #include "TaskScheduler.h"
 #include "OBException.h"
@@ -28,32 +30,107 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <set>
 
 #include <cstdlib>
 #include <cstring>
 
-#include "oblibconfig.h"
-
-#if HAVE_CURL
-#include <curl/curl.h>
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
+#include "oblibconfig.h"
+
 namespace OB{
     AssetResponse::AssetResponse(size_t size, char* data, std::string resURI, OBEngine* eng){
         this->size = size;
         this->data = new char[size];
         this->resURI = resURI;
         this->eng = eng;
+        storage = OB_ASSET_STORAGE_NEW;
 
 		memcpy(this->data, data, size);
     }
 
+    AssetResponse::AssetResponse(std::string resURI, OBEngine* eng){
+        size = 0;
+        data = NULL;
+        this->resURI = resURI;
+        this->eng = eng;
+        storage = OB_ASSET_STORAGE_NEW;
+    }
+
     AssetResponse::~AssetResponse(){
         if(data){
-			delete[] data;
+            switch(storage){
+                case OB_ASSET_STORAGE_MALLOC: {
+                    free(data);
+                    break;
+                }
+                case OB_ASSET_STORAGE_MMAP: {
+#ifndef _WIN32
+                    munmap(data, size);
+#endif
+                    break;
+                }
+                default: {
+                    delete[] data;
+                }
+            }
         }
     }
 
+    shared_ptr<AssetResponse> AssetResponse::adopt(size_t size, char* data, std::string resURI, OBEngine* eng){
+        shared_ptr<AssetResponse> resp(new AssetResponse(resURI, eng));
+        resp->size = size;
+        resp->data = data;
+        resp->storage = OB_ASSET_STORAGE_MALLOC;
+
+        return resp;
+    }
+
+    shared_ptr<AssetResponse> AssetResponse::mapFile(std::string path, std::string resURI, OBEngine* eng){
+#ifndef _WIN32
+        int fd = open(path.c_str(), O_RDONLY);
+        if(fd < 0){
+            return NULL;
+        }
+
+        struct stat st;
+        if(fstat(fd, &st) != 0 || st.st_size <= 0){
+            close(fd);
+            return NULL;
+        }
+
+        // Private and writable, so callers scribbling on getData() never touch the file
+        void* mapped = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+        // The mapping stays valid after the descriptor is closed
+        close(fd);
+
+        if(mapped == MAP_FAILED){
+            return NULL;
+        }
+
+        shared_ptr<AssetResponse> resp(new AssetResponse(resURI, eng));
+        resp->size = st.st_size;
+        resp->data = (char*)mapped;
+        resp->storage = OB_ASSET_STORAGE_MMAP;
+
+        return resp;
+#else
+        (void)path;
+        (void)resURI;
+        (void)eng;
+        return NULL;
+#endif
+    }
+
     size_t AssetResponse::getSize(){
         return size;
     }
@@ -82,17 +159,51 @@ namespace OB{
     }
 #endif
 
+    _ob_asset_request::_ob_asset_request(){
+        done = false;
+        counted = false;
+        finishing = false;
+        cachedData = NULL;
+
+        priority = Enum::AssetPriority::Default;
+        dispatched = false;
+        active = false;
+
+        pthread_cond_init(&cond, NULL);
+    }
+
+    _ob_asset_request::~_ob_asset_request(){
+        if(cachedData){
+            free(cachedData);
+        }
+
+        pthread_cond_destroy(&cond);
+    }
+
     AssetLocator::AssetLocator(OBEngine* eng){
         this->eng = eng;
 
         requestQueueSize = 0;
 
+        cacheBudget = OB_ASSET_CACHE_DEFAULT_BUDGET;
+        cacheSize = 0;
+        cacheHits = 0;
+        cacheMisses = 0;
+        cacheEvictions = 0;
+
+        completionBudget = OB_ASSET_COMPLETION_BUDGET;
+
+        activeRequests = 0;
+        maxActiveRequests = OB_ASSET_DEFAULT_MAX_ACTIVE;
+
         loadingResponse = make_shared<AssetResponse>(0, (char*)NULL, "loading://null", eng);
 
         pthread_mutex_init(&mmutex, NULL);
+        pthread_mutex_init(&waitingMutex, NULL);
     }
 
     AssetLocator::~AssetLocator(){
+        pthread_mutex_destroy(&waitingMutex);
         pthread_mutex_destroy(&mmutex);
     }
 
@@ -121,278 +232,680 @@ namespace OB{
         return n;
     }
 
-    void AssetLocator::loadAssetSync(std::string url, bool decCount, bool allowFile){
+    void AssetLocator::fireAssetLoadFailed(std::string url, std::string reason){
+        shared_ptr<Instance::DataModel> dm = eng->getDataModel();
+        shared_ptr<Instance::ContentProvider> cp = dm->getContentProvider();
+        shared_ptr<Type::Event> AssetLoadFailed = cp->GetAssetLoadFailed();
+
+        std::vector<shared_ptr<Type::VarWrapper>> fireArgs;
+        fireArgs.push_back(make_shared<Type::VarWrapper>(url));
+        fireArgs.push_back(make_shared<Type::VarWrapper>(reason));
+
+        AssetLoadFailed->Fire(eng, fireArgs);
+    }
+
+    void AssetLocator::notifyWaitingInstances(std::string url){
+        pthread_mutex_lock(&waitingMutex);
+
+        std::vector<weak_ptr<Instance::Instance>>::iterator i = instancesWaiting.begin();
+        while(i != instancesWaiting.end()){
+            if(i->expired()){
+                i = instancesWaiting.erase(i);
+                continue;
+            }
+
+            shared_ptr<Instance::Instance> inst = i->lock();
+            if(inst){
+                bool didLoad = inst->assetLoaded(url);
+                if(didLoad){
+                    i = instancesWaiting.erase(i);
+                    continue;
+                }
+            }
+
+            i++;
+        }
+
+        pthread_mutex_unlock(&waitingMutex);
+    }
+
+    struct _ob_assetLocatorMetad{
+        std::string url;
+        shared_ptr<struct _ob_asset_request> req;
+        OBEngine* eng;
+    };
+
+    shared_ptr<AssetResponse> AssetLocator::readResource(std::string url, std::string& failReason){
+        std::string furl = url.substr(6);
+
+        char* ccanonPath = realpath(furl.c_str(), NULL);
+        if(!ccanonPath){
+            ccanonPath = realpath(("res/" + furl).c_str(), NULL);
+        }
+
+        if(!ccanonPath){
+            failReason = "File not found.";
+            return NULL;
+        }
+
+        std::string canonPath = ccanonPath;
+        free(ccanonPath);
+
+        char* realRes = realpath("res/", NULL);
+        char* thisDir = get_current_dir_name();
+
+        bool underRes;
+        if(realRes){
+            underRes = ob_str_startsWith(canonPath, std::string(realRes)) && ob_str_startsWith(canonPath, std::string(thisDir));
+            free(realRes);
+        }else{
+            underRes = ob_str_startsWith(canonPath, std::string(thisDir));
+        }
+        free(thisDir);
+
+        if(!underRes){
+            failReason = "File not under resource directory.";
+            return NULL;
+        }
+
+        std::ifstream file(canonPath, std::ios::binary | std::ios::ate);
+        if(!file){
+            failReason = "Failed to read file.";
+            return NULL;
+        }
+
+        size_t fileLen = file.tellg();
+
+        // Big files are paged in on demand instead of copied
+        if(fileLen >= OB_ASSET_MMAP_THRESHOLD){
+            shared_ptr<AssetResponse> resp = AssetResponse::mapFile(canonPath, url, eng);
+            if(resp){
+                return resp;
+            }
+        }
+
+        if(fileLen == 0){
+            return NULL;
+        }
+
+        file.seekg(0, std::ios::beg);
+
+        char* bodyDat = (char*)malloc(fileLen);
+        if(!bodyDat || !file.read(bodyDat, fileLen)){
+            free(bodyDat);
+
+            failReason = "Failed to read file.";
+            return NULL;
+        }
+
+        return AssetResponse::adopt(fileLen, bodyDat, url, eng);
+    }
+
+    shared_ptr<struct _ob_download_request> AssetLocator::prepareDownload(std::string url, bool allowFile, shared_ptr<struct _ob_asset_request> req){
+#if HAVE_CURL
         pthread_mutex_lock(&mmutex);
+        req->diskCache = diskCache;
+        pthread_mutex_unlock(&mmutex);
 
-        if(url.empty()){
-            if(decCount){
-                requestQueueSize--;
+        // A copy from an earlier run, revalidated with the server
+        if(req->diskCache && req->diskCache->lookup(url, req->cached)){
+            if(!req->diskCache->read(req->cached, &req->cachedData)){
+                req->cachedData = NULL;
+            }
+        }
+
+        shared_ptr<struct _ob_download_request> dl = make_shared<struct _ob_download_request>();
+        dl->url = url;
+
+        dl->protocols = CURLPROTO_FTP | CURLPROTO_FTPS | CURLPROTO_GOPHER | CURLPROTO_HTTP | CURLPROTO_HTTPS | CURLPROTO_SCP | CURLPROTO_SFTP | CURLPROTO_SMB | CURLPROTO_SMBS | CURLPROTO_TFTP;
+        if(allowFile){
+            dl->protocols = CURLPROTO_FILE | dl->protocols;
+        }
+
+        if(req->cachedData){
+            if(!req->cached.etag.empty()){
+                dl->headers.push_back("If-None-Match: " + req->cached.etag);
+            }
+            if(!req->cached.lastModified.empty()){
+                dl->headers.push_back("If-Modified-Since: " + req->cached.lastModified);
             }
+        }
+
+        return dl;
+#else
+        (void)url;
+        (void)allowFile;
+        (void)req;
+        return NULL;
+#endif
+    }
+
+    struct _ob_assetLocatorStoreMetad{
+        shared_ptr<AssetDiskCache> diskCache;
+        std::string url;
+        shared_ptr<AssetResponse> resp;
+        std::string etag;
+        std::string lastModified;
+    };
+
+    int AssetLocator::_ob_assetlocator_store_task(void* metad, ob_uint64 startTime){
+        (void)startTime;
+
+        struct _ob_assetLocatorStoreMetad* smetad = (struct _ob_assetLocatorStoreMetad*)metad;
+
+        smetad->diskCache->store(smetad->url, smetad->resp->getData(), smetad->resp->getSize(), smetad->etag, smetad->lastModified);
+
+        delete smetad;
+
+        return 0;
+    }
+
+    void AssetLocator::completeDownload(std::string url, shared_ptr<struct _ob_asset_request> req, bool storeAsync){
+#if HAVE_CURL
+        pthread_mutex_lock(&mmutex);
+        if(req->finishing){
             pthread_mutex_unlock(&mmutex);
             return;
         }
+        req->finishing = true;
+        shared_ptr<struct _ob_download_request> dl = req->download;
+        pthread_mutex_unlock(&mmutex);
 
-        if(!allowFile && ob_str_startsWith(url, "file://")){
-            if(decCount){
-                requestQueueSize--;
+        std::string failReason;
+
+        // Not modified, or the server can't be reached: use what we have
+        if(req->cachedData && (dl->responseCode == 304 || !dl->ok)){
+            if(!dl->ok){
+                std::cout << "[AssetLocator] cURL Error: " << dl->error << ", using cached copy" << std::endl;
             }
-            pthread_mutex_unlock(&mmutex);
+
+            shared_ptr<AssetResponse> resp = AssetResponse::adopt(req->cached.size, req->cachedData, url, eng);
+            req->cachedData = NULL;
+
+            finishRequest(url, req, resp, failReason);
             return;
         }
 
-        struct _ob_curl_body* body = new struct _ob_curl_body;
-        body->size = 0;
-        body->data = NULL;
+        if(!dl->ok){
+            std::cout << "[AssetLocator] cURL Error: " << dl->error << std::endl;
 
+            failReason = dl->error;
+            finishRequest(url, req, NULL, failReason);
+            return;
+        }
+
+        std::string etag;
+        std::string lastModified;
+        if(dl->responseHeaders.count("etag") != 0){
+            etag = dl->responseHeaders["etag"];
+        }
+        if(dl->responseHeaders.count("last-modified") != 0){
+            lastModified = dl->responseHeaders["last-modified"];
+        }
+
+        // Without a validator there'd be no way to tell when it's stale
+        bool store = req->diskCache && dl->responseCode == 200 && dl->data && (!etag.empty() || !lastModified.empty());
+
+        if(store && !storeAsync){
+            req->diskCache->store(url, dl->data, dl->size, etag, lastModified);
+        }
+
+        shared_ptr<AssetResponse> resp;
+        if(dl->data){
+            size_t size = dl->size;
+            resp = AssetResponse::adopt(size, dl->takeData(), url, eng);
+        }
+
+        resp = finishRequest(url, req, resp, failReason);
+
+        if(store && storeAsync && resp){
+            struct _ob_assetLocatorStoreMetad* smetad = new struct _ob_assetLocatorStoreMetad;
+            smetad->diskCache = req->diskCache;
+            smetad->url = url;
+            smetad->resp = resp;
+            smetad->etag = etag;
+            smetad->lastModified = lastModified;
+
+            shared_ptr<TaskScheduler> taskS = eng->getSecondaryTaskScheduler();
+            taskS->enqueue(_ob_assetlocator_store_task, smetad, 0, false, false);
+        }
+#else
+        (void)url;
+        (void)req;
+        (void)storeAsync;
+#endif
+    }
+
+    void AssetLocator::runRequest(std::string url, shared_ptr<struct _ob_asset_request> req, bool allowFile, bool async){
+        std::string failReason;
+
+        // No locks are held while reading or downloading
         if(ob_str_startsWith(url, "res://")){
-            std::string furl = url.substr(6);
+            shared_ptr<AssetResponse> resp = readResource(url, failReason);
+            finishRequest(url, req, resp, failReason);
+            return;
+        }
 
-            char* ccanonPath = realpath(furl.c_str(), NULL);
-            if(!ccanonPath){
-                ccanonPath = realpath(("res/" + furl).c_str(), NULL);
-            }
+#if HAVE_CURL
+        shared_ptr<DownloadManager> dm = eng->getDownloadManager();
+        shared_ptr<struct _ob_download_request> dl;
+        if(dm){
+            dl = prepareDownload(url, allowFile, req);
+        }
 
-            if(ccanonPath){
-                std::string canonPath = ccanonPath;
+        if(!dl){
+            std::cout << "[AssetLocator] Failed to initialize cURL" << std::endl;
 
-                char* realRes = realpath("res/", NULL);
-                char* thisDir = get_current_dir_name();
-                if(realRes){
-                    if(!ob_str_startsWith(canonPath, std::string(realRes)) || !ob_str_startsWith(canonPath, std::string(thisDir))){
-                        shared_ptr<Instance::DataModel> dm = eng->getDataModel();
-                        shared_ptr<Instance::ContentProvider> cp = dm->getContentProvider();
-                        shared_ptr<Type::Event> AssetLoadFailed = cp->GetAssetLoadFailed();
+            failReason = "Failed to initialize cURL.";
+            finishRequest(url, req, NULL, failReason);
+            return;
+        }
 
-                        std::vector<shared_ptr<Type::VarWrapper>> fireArgs;
-                        fireArgs.push_back(make_shared<Type::VarWrapper>(url));
-                        fireArgs.push_back(make_shared<Type::VarWrapper>("File not under resource directory."));
+        if(async){
+            struct _ob_assetLocatorMetad* metad = new struct _ob_assetLocatorMetad;
+            metad->url = url;
+            metad->req = req;
+            metad->eng = eng;
 
-                        AssetLoadFailed->Fire(eng, fireArgs);
+            dl->callback = _ob_assetlocator_download_done;
+            dl->ud = metad;
+        }
 
-                        if(decCount){
-                            requestQueueSize--;
-                        }
+        pthread_mutex_lock(&mmutex);
+        req->download = dl;
+        // Anyone already waiting in loadAssetSync can now wait on the download itself
+        pthread_cond_broadcast(&req->cond);
+        pthread_mutex_unlock(&mmutex);
 
-                        delete body;
+        if(async){
+            dm->submit(dl);
+            return;
+        }
 
-                        pthread_mutex_unlock(&mmutex);
-                        free(thisDir);
-                        return;
-                    }
-                }else{
-                    if(!ob_str_startsWith(canonPath, std::string(thisDir))){
-                        shared_ptr<Instance::DataModel> dm = eng->getDataModel();
-                        shared_ptr<Instance::ContentProvider> cp = dm->getContentProvider();
-                        shared_ptr<Type::Event> AssetLoadFailed = cp->GetAssetLoadFailed();
+        dm->perform(dl);
+        completeDownload(url, req, false);
 
-                        std::vector<shared_ptr<Type::VarWrapper>> fireArgs;
-                        fireArgs.push_back(make_shared<Type::VarWrapper>(url));
-                        fireArgs.push_back(make_shared<Type::VarWrapper>("File not under resource directory."));
+        // A loadAssetSync caller waiting on this may have finished it instead
+        pthread_mutex_lock(&mmutex);
+        while(!req->done){
+            pthread_cond_wait(&req->cond, &mmutex);
+        }
+        pthread_mutex_unlock(&mmutex);
+#else
+        (void)allowFile;
+        (void)async;
+
+        finishRequest(url, req, NULL, failReason);
+#endif
+    }
 
-                        AssetLoadFailed->Fire(eng, fireArgs);
+    shared_ptr<AssetResponse> AssetLocator::finishRequest(std::string url, shared_ptr<struct _ob_asset_request> req, shared_ptr<AssetResponse> resp, std::string failReason){
+        if(!resp && failReason.empty()){
+            std::cout << "[AssetLocator] No data" << std::endl;
 
-                        if(decCount){
-                            requestQueueSize--;
-                        }
+            failReason = "No data.";
+        }
 
-                        delete body;
+        pthread_mutex_lock(&mmutex);
 
-                        pthread_mutex_unlock(&mmutex);
-                        free(thisDir);
-                        return;
-                    }
-                }
-                free(thisDir);
+        if(resp){
+            cachePut(url, resp);
+        }else{
+            // Drop the placeholder left by loadAsset, so the asset can be requested again
+            std::map<std::string, struct _ob_asset_cache_entry>::iterator ci = contentCache.find(url);
+            if(ci != contentCache.end() && ci->second.resp == loadingResponse){
+                cacheErase(ci);
+            }
+        }
 
-                std::ifstream file(canonPath, std::ios::binary | std::ios::ate);
-                size_t fileLen = file.tellg();
-                file.seekg(0, std::ios::beg);
+        std::map<std::string, shared_ptr<struct _ob_asset_request>>::iterator ri = inFlight.find(url);
+        if(ri != inFlight.end() && ri->second == req){
+            inFlight.erase(ri);
+        }
 
-                char* bodyDat = (char*)malloc(fileLen);
-                if(file.read(bodyDat, fileLen)){
-                    bodyDat[fileLen] = '\0';
+        if(req->counted){
+            requestQueueSize--;
+        }
+        // The next queued load is started from tick
+        if(req->active){
+            activeRequests--;
+        }
 
-                    body->data = bodyDat;
-                    body->size = fileLen;
-                }else{
-                    shared_ptr<Instance::DataModel> dm = eng->getDataModel();
-                    shared_ptr<Instance::ContentProvider> cp = dm->getContentProvider();
-                    shared_ptr<Type::Event> AssetLoadFailed = cp->GetAssetLoadFailed();
+        req->done = true;
+        pthread_cond_broadcast(&req->cond);
 
-                    std::vector<shared_ptr<Type::VarWrapper>> fireArgs;
-                    fireArgs.push_back(make_shared<Type::VarWrapper>(url));
-                    fireArgs.push_back(make_shared<Type::VarWrapper>("Failed to read file."));
+        pthread_mutex_unlock(&mmutex);
 
-                    AssetLoadFailed->Fire(eng, fireArgs);
+        // Announced from tick, on the main thread
+        struct _ob_asset_completion completion;
+        completion.url = url;
+        completion.loaded = resp != NULL;
+        completion.failReason = failReason;
+        completions.push(completion);
 
-                    if(decCount){
-                        requestQueueSize--;
-                    }
+        return resp;
+    }
 
-                    delete body;
+    void AssetLocator::tick(){
+        dispatchPending();
 
-                    pthread_mutex_unlock(&mmutex);
-                    free(bodyDat);
-                    return;
-                }
-            }else{
+        ob_uint64 startTime = currentTimeMicros();
+        ob_uint64 budget = completionBudget;
+
+        struct _ob_asset_completion completion;
+        while(completions.pop(completion)){
+            if(completion.loaded){
                 shared_ptr<Instance::DataModel> dm = eng->getDataModel();
                 shared_ptr<Instance::ContentProvider> cp = dm->getContentProvider();
-                shared_ptr<Type::Event> AssetLoadFailed = cp->GetAssetLoadFailed();
+                shared_ptr<Type::Event> AssetLoaded = cp->GetAssetLoaded();
 
                 std::vector<shared_ptr<Type::VarWrapper>> fireArgs;
-                fireArgs.push_back(make_shared<Type::VarWrapper>(url));
-                fireArgs.push_back(make_shared<Type::VarWrapper>("File not found."));
+                fireArgs.push_back(make_shared<Type::VarWrapper>(completion.url));
 
-                AssetLoadFailed->Fire(eng, fireArgs);
+                AssetLoaded->Fire(eng, fireArgs);
 
-                if(decCount){
-                    requestQueueSize--;
-                }
+                notifyWaitingInstances(completion.url);
+            }else{
+                fireAssetLoadFailed(completion.url, completion.failReason);
+            }
 
-                delete body;
+            updatePreloads(completion.url, completion.loaded);
 
-                pthread_mutex_unlock(&mmutex);
-                return;
+            if(currentTimeMicros() - startTime >= budget){
+                break;
             }
-        }else{
+        }
+    }
 
-#if HAVE_CURL
+    ob_uint64 AssetLocator::getCompletionBudget(){
+        return completionBudget;
+    }
 
-            CURL* curl;
-            CURLcode res;
+    void AssetLocator::setCompletionBudget(ob_uint64 budget){
+        completionBudget = budget;
+    }
 
-            curl = curl_easy_init();
-            if(curl){
-				long curl_protos = CURLPROTO_FTP | CURLPROTO_FTPS | CURLPROTO_GOPHER | CURLPROTO_HTTP | CURLPROTO_HTTPS | CURLPROTO_SCP | CURLPROTO_SFTP | CURLPROTO_SMB | CURLPROTO_SMBS | CURLPROTO_TFTP;
-				if(allowFile){
-					curl_protos = CURLPROTO_FILE | curl_protos;
-				}
+    void AssetLocator::dispatchPending(){
+        std::vector<struct _ob_assetLocatorMetad*> toStart;
 
-                curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-                curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1);
-                curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
-                curl_easy_setopt(curl, CURLOPT_PROTOCOLS, curl_protos);
-				curl_easy_setopt(curl, CURLOPT_DEFAULT_PROTOCOL, "https");
-                curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _ob_assetlocator_write_data);
-                curl_easy_setopt(curl, CURLOPT_WRITEDATA, body);
+        pthread_mutex_lock(&mmutex);
 
-                res = curl_easy_perform(curl);
-                if(res != CURLE_OK){
-                    std::cout << "[AssetLocator] cURL Error: " << curl_easy_strerror(res) << std::endl;
+        for(int p = 0; p < (int)Enum::AssetPriority::__COUNT && activeRequests < maxActiveRequests; p++){
+            while(activeRequests < maxActiveRequests && !pending[p].empty()){
+                std::string url = pending[p].front();
+                pending[p].pop_front();
 
-                    shared_ptr<Instance::DataModel> dm = eng->getDataModel();
-                    shared_ptr<Instance::ContentProvider> cp = dm->getContentProvider();
-                    shared_ptr<Type::Event> AssetLoadFailed = cp->GetAssetLoadFailed();
+                // Raising a priority or loadAssetSync taking over a
+                // queued load leaves stale entries behind
+                std::map<std::string, shared_ptr<struct _ob_asset_request>>::iterator ri = inFlight.find(url);
+                if(ri == inFlight.end()){
+                    continue;
+                }
 
-                    std::vector<shared_ptr<Type::VarWrapper>> fireArgs;
-                    fireArgs.push_back(make_shared<Type::VarWrapper>(url));
-                    fireArgs.push_back(make_shared<Type::VarWrapper>(std::string(curl_easy_strerror(res))));
+                shared_ptr<struct _ob_asset_request> req = ri->second;
+                if(req->dispatched || (int)req->priority != p){
+                    continue;
+                }
 
-                    AssetLoadFailed->Fire(eng, fireArgs);
+                req->dispatched = true;
+                req->active = true;
+                activeRequests++;
 
-                    curl_easy_cleanup(curl);
+                struct _ob_assetLocatorMetad* metad = new struct _ob_assetLocatorMetad;
+                metad->url = url;
+                metad->req = req;
+                metad->eng = eng;
 
-                    if(decCount){
-                        requestQueueSize--;
-                    }
+                toStart.push_back(metad);
+            }
+        }
 
-					if(body->data){
-						delete[] body->data;
-					}
+        pthread_mutex_unlock(&mmutex);
 
-                    delete body;
+        if(toStart.empty()){
+            return;
+        }
 
-                    pthread_mutex_unlock(&mmutex);
+        shared_ptr<TaskScheduler> taskS = eng->getSecondaryTaskScheduler();
+        for(std::vector<struct _ob_assetLocatorMetad*>::size_type i = 0; i < toStart.size(); i++){
+            taskS->enqueue(loadAssetAsyncTask, toStart[i], 0, false, false);
+        }
+    }
 
-                    return;
+    void AssetLocator::updatePreloads(std::string url, bool loaded){
+        std::vector<shared_ptr<struct _ob_preload_batch>> finished;
+
+        for(std::vector<shared_ptr<struct _ob_preload_batch>>::iterator it = preloads.begin(); it != preloads.end();){
+            shared_ptr<struct _ob_preload_batch> batch = *it;
+
+            std::map<std::string, double>::iterator ri = batch->remaining.find(url);
+            if(ri != batch->remaining.end()){
+                batch->doneWeight += ri->second;
+                if(loaded){
+                    batch->loaded++;
+                }else{
+                    batch->failed++;
                 }
+                batch->remaining.erase(ri);
+            }
 
-                curl_easy_cleanup(curl);
+            if(batch->remaining.empty()){
+                finished.push_back(batch);
+                it = preloads.erase(it);
             }else{
-                std::cout << "[AssetLocator] Failed to initialize cURL" << std::endl;
+                ++it;
+            }
+        }
 
-                shared_ptr<Instance::DataModel> dm = eng->getDataModel();
-                shared_ptr<Instance::ContentProvider> cp = dm->getContentProvider();
-                shared_ptr<Type::Event> AssetLoadFailed = cp->GetAssetLoadFailed();
+        // Callbacks may start new preloads, so they run last
+        for(std::vector<shared_ptr<struct _ob_preload_batch>>::size_type i = 0; i < finished.size(); i++){
+            shared_ptr<struct _ob_preload_batch> batch = finished[i];
+            if(batch->callback){
+                batch->callback(batch, batch->ud);
+            }
+        }
+    }
 
-                std::vector<shared_ptr<Type::VarWrapper>> fireArgs;
-                fireArgs.push_back(make_shared<Type::VarWrapper>(url));
-                fireArgs.push_back(make_shared<Type::VarWrapper>("Failed to initialize cURL."));
+    shared_ptr<struct _ob_preload_batch> AssetLocator::preload(std::vector<struct _ob_preload_entry> entries, ob_preload_fnc callback, void* ud){
+        shared_ptr<struct _ob_preload_batch> batch = make_shared<struct _ob_preload_batch>();
+        batch->total = 0;
+        batch->loaded = 0;
+        batch->failed = 0;
+        batch->totalWeight = 0;
+        batch->doneWeight = 0;
+        batch->callback = callback;
+        batch->ud = ud;
+
+        std::set<std::string> seen;
+
+        for(std::vector<struct _ob_preload_entry>::size_type i = 0; i < entries.size(); i++){
+            struct _ob_preload_entry& entry = entries[i];
+
+            if(!seen.insert(entry.url).second){
+                // Listed twice, only the priority can still matter
+                if(batch->remaining.count(entry.url) != 0){
+                    loadAsset(entry.url, entry.priority);
+                }
+                continue;
+            }
 
-                AssetLoadFailed->Fire(eng, fireArgs);
+            double weight = entry.size > 0 ? entry.size : OB_ASSET_PRELOAD_DEFAULT_SIZE;
+            batch->total++;
+            batch->totalWeight += weight;
 
-                if(decCount){
-                    requestQueueSize--;
-                }
+            if(entry.url.empty() || ob_str_startsWith(entry.url, "file://")){
+                batch->failed++;
+                batch->doneWeight += weight;
+                continue;
+            }
 
-                delete body;
+            pthread_mutex_lock(&mmutex);
+            std::map<std::string, struct _ob_asset_cache_entry>::iterator ci = contentCache.find(entry.url);
+            bool loaded = ci != contentCache.end() && ci->second.resp != loadingResponse;
+            pthread_mutex_unlock(&mmutex);
 
-                pthread_mutex_unlock(&mmutex);
-                return;
+            if(loaded){
+                batch->loaded++;
+                batch->doneWeight += weight;
+                continue;
             }
-#endif
+
+            // Anything loading now is announced from tick, on this thread
+            batch->remaining[entry.url] = weight;
+            loadAsset(entry.url, entry.priority);
         }
 
-        if(body->data){
-            shared_ptr<Instance::DataModel> dm = eng->getDataModel();
-            shared_ptr<Instance::ContentProvider> cp = dm->getContentProvider();
-            shared_ptr<Type::Event> AssetLoaded = cp->GetAssetLoaded();
+        if(!batch->remaining.empty()){
+            preloads.push_back(batch);
+        }
 
-            std::vector<shared_ptr<Type::VarWrapper>> fireArgs;
-            fireArgs.push_back(make_shared<Type::VarWrapper>(url));
+        return batch;
+    }
 
-            putAsset(url, body->size, body->data);
+    double AssetLocator::getPreloadProgress(){
+        double totalWeight = 0;
+        double doneWeight = 0;
 
-			delete[] body->data;
+        for(std::vector<shared_ptr<struct _ob_preload_batch>>::size_type i = 0; i < preloads.size(); i++){
+            totalWeight += preloads[i]->totalWeight;
+            doneWeight += preloads[i]->doneWeight;
+        }
 
-            AssetLoaded->Fire(eng, fireArgs);
+        if(totalWeight <= 0){
+            return 1;
+        }
 
-            std::vector<weak_ptr<Instance::Instance>>::iterator i = instancesWaiting.begin();
-            while(i != instancesWaiting.end()){
-                if(i->expired()){
-                    i = instancesWaiting.erase(i);
-                    continue;
-                }
+        return doneWeight / totalWeight;
+    }
+
+    static Enum::AssetPriority _ob_parse_asset_priority(std::string tok, Enum::AssetPriority defaultPriority){
+        for(std::map<std::string, shared_ptr<Type::LuaEnumItem>>::iterator it = Enum::LuaAssetPriority->enumValues.begin(); it != Enum::LuaAssetPriority->enumValues.end(); ++it){
+            shared_ptr<Type::LuaEnumItem> item = it->second;
+            if(item->getName() == tok || std::to_string(item->getValue()) == tok){
+                return (Enum::AssetPriority)item->getValue();
+            }
+        }
+
+        return defaultPriority;
+    }
+
+    std::vector<struct _ob_preload_entry> AssetLocator::parseManifest(const char* data, size_t size, Enum::AssetPriority defaultPriority){
+        std::vector<struct _ob_preload_entry> entries;
+
+        if(!data || size == 0){
+            return entries;
+        }
+
+        std::istringstream in(std::string(data, size));
+        std::string line;
+
+        while(std::getline(in, line)){
+            std::istringstream lineIn(line);
+
+            struct _ob_preload_entry entry;
+            entry.size = 0;
+            entry.priority = defaultPriority;
 
-                shared_ptr<Instance::Instance> inst = i->lock();
-                if(inst){
-                    bool didLoad = inst->assetLoaded(url);
-                    if(didLoad){
-                        i = instancesWaiting.erase(i);
-                        continue;
+            if(!(lineIn >> entry.url) || entry.url[0] == '#'){
+                continue;
+            }
+
+            std::string tok;
+            if(lineIn >> tok){
+                // A number is the size, which may be left out
+                char* end = NULL;
+                unsigned long long siz = strtoull(tok.c_str(), &end, 10);
+                if(*end == '\0'){
+                    entry.size = siz;
+                    if(!(lineIn >> tok)){
+                        tok.clear();
                     }
                 }
 
-                i++;
+                if(!tok.empty()){
+                    entry.priority = _ob_parse_asset_priority(tok, defaultPriority);
+                }
             }
-        }else{
-            std::cout << "[AssetLocator] No data" << std::endl;
 
-            shared_ptr<Instance::DataModel> dm = eng->getDataModel();
-            shared_ptr<Instance::ContentProvider> cp = dm->getContentProvider();
-            shared_ptr<Type::Event> AssetLoadFailed = cp->GetAssetLoadFailed();
+            entries.push_back(entry);
+        }
 
-            std::vector<shared_ptr<Type::VarWrapper>> fireArgs;
-            fireArgs.push_back(make_shared<Type::VarWrapper>(url));
-            fireArgs.push_back(make_shared<Type::VarWrapper>("No data."));
+        return entries;
+    }
+
+    int AssetLocator::getMaxActiveRequests(){
+        pthread_mutex_lock(&mmutex);
+        int maxActive = maxActiveRequests;
+        pthread_mutex_unlock(&mmutex);
 
-            AssetLoadFailed->Fire(eng, fireArgs);
+        return maxActive;
+    }
+
+    void AssetLocator::setMaxActiveRequests(int maxActive){
+        if(maxActive < 1){
+            maxActive = 1;
         }
 
-        if(decCount){
-            requestQueueSize--;
+        pthread_mutex_lock(&mmutex);
+        maxActiveRequests = maxActive;
+        pthread_mutex_unlock(&mmutex);
+    }
+
+    void AssetLocator::loadAssetSync(std::string url, bool allowFile){
+        if(url.empty()){
+            return;
+        }
+
+        if(!allowFile && ob_str_startsWith(url, "file://")){
+            return;
+        }
+
+        pthread_mutex_lock(&mmutex);
+
+        std::map<std::string, shared_ptr<struct _ob_asset_request>>::iterator ri = inFlight.find(url);
+        if(ri != inFlight.end()){
+            shared_ptr<struct _ob_asset_request> req = ri->second;
+
+            // Still waiting in the priority queue, load it here instead
+            if(req->counted && !req->dispatched){
+                req->dispatched = true;
+                pthread_mutex_unlock(&mmutex);
+
+                runRequest(url, req, allowFile, false);
+                return;
+            }
+
+            // Someone else is already loading this, wait for them
+            while(!req->done){
+#if HAVE_CURL
+                // Async downloads are normally finished from the
+                // engine tick. Finish it here instead, in case this
+                // is the thread that would run that tick.
+                if(req->download && !req->finishing){
+                    shared_ptr<struct _ob_download_request> dl = req->download;
+                    pthread_mutex_unlock(&mmutex);
+
+                    eng->getDownloadManager()->wait(dl);
+                    completeDownload(url, req, false);
+
+                    pthread_mutex_lock(&mmutex);
+                    continue;
+                }
+#endif
+                pthread_cond_wait(&req->cond, &mmutex);
+            }
+
+            pthread_mutex_unlock(&mmutex);
+            return;
         }
 
-        delete body;
+        shared_ptr<struct _ob_asset_request> req = make_shared<struct _ob_asset_request>();
+        inFlight.emplace(url, req);
 
         pthread_mutex_unlock(&mmutex);
-    }
 
-    struct _ob_assetLocatorMetad{
-        char* url;
-        OBEngine* eng;
-    };
+        runRequest(url, req, allowFile, false);
+    }
 
     int AssetLocator::loadAssetAsyncTask(void* metad, ob_uint64 startTime){
         if(metad == NULL){
@@ -404,15 +917,28 @@ namespace OB{
         OBEngine* eng = locmetad->eng;
         shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 
-        assetLoc->loadAssetSync(locmetad->url, true);
+        // Remote assets only start downloading here, they finish in _ob_assetlocator_download_done
+        assetLoc->runRequest(locmetad->url, locmetad->req, false, true);
 
-        free(locmetad->url);
-        free(metad);
+        delete locmetad;
 
         return 0;
     }
 
-    void AssetLocator::loadAsset(std::string url){
+    void AssetLocator::_ob_assetlocator_download_done(shared_ptr<struct _ob_download_request> dl, void* ud){
+        (void)dl;
+
+        struct _ob_assetLocatorMetad* locmetad = (struct _ob_assetLocatorMetad*)ud;
+
+        shared_ptr<AssetLocator> assetLoc = locmetad->eng->getAssetLocator();
+        if(assetLoc){
+            assetLoc->completeDownload(locmetad->url, locmetad->req, true);
+        }
+
+        delete locmetad;
+    }
+
+    void AssetLocator::loadAsset(std::string url, Enum::AssetPriority priority){
         if(url.empty()){
             return;
         }
@@ -421,27 +947,41 @@ namespace OB{
             return;
         }
 
-        shared_ptr<TaskScheduler> taskS = eng->getSecondaryTaskScheduler();
+        pthread_mutex_lock(&mmutex);
 
-        struct _ob_assetLocatorMetad* metad = new struct _ob_assetLocatorMetad;
+        std::map<std::string, shared_ptr<struct _ob_asset_request>>::iterator ri = inFlight.find(url);
+        if(ri != inFlight.end()){
+            shared_ptr<struct _ob_asset_request> req = ri->second;
 
-		// Because Windows, without MinGW or similar, is fucking annoying
-#ifdef _MSC_VER
-		metad->url = _strdup(url.c_str());
-#else
-		metad->url = strdup(url.c_str());
-#endif
-        metad->eng = eng;
+            // Still queued, move it up. The old entry is skipped by dispatchPending.
+            if(req->counted && !req->dispatched && priority < req->priority){
+                req->priority = priority;
+                pending[(int)priority].push_back(url);
+            }
 
-        pthread_mutex_lock(&mmutex);
+            pthread_mutex_unlock(&mmutex);
+            return;
+        }
+
+        if(contentCache.count(url) != 0){
+            pthread_mutex_unlock(&mmutex);
+            return;
+        }
+
+        shared_ptr<struct _ob_asset_request> req = make_shared<struct _ob_asset_request>();
+        req->counted = true;
+        req->priority = priority;
+        inFlight.emplace(url, req);
+
+        cachePut(url, loadingResponse);
 
         requestQueueSize++;
 
-        pthread_mutex_unlock(&mmutex);
+        pending[(int)priority].push_back(url);
 
-        contentCache.emplace(url, loadingResponse);
+        pthread_mutex_unlock(&mmutex);
 
-        taskS->enqueue(loadAssetAsyncTask, metad, 0, false, false);
+        dispatchPending();
     }
 
     shared_ptr<AssetResponse> AssetLocator::getAsset(std::string url, bool loadIfNotPresent){
@@ -449,15 +989,33 @@ namespace OB{
             return NULL;
         }
 
-        if(hasAsset(url)){
-            shared_ptr<AssetResponse> resp = contentCache.at(url);
+        shared_ptr<AssetResponse> resp;
+        bool found = false;
+
+        pthread_mutex_lock(&mmutex);
+
+        std::map<std::string, struct _ob_asset_cache_entry>::iterator i = contentCache.find(url);
+        if(i != contentCache.end()){
+            resp = i->second.resp;
+            found = true;
+        }
+
+        if(found && resp != loadingResponse){
+            cacheHits++;
+            lruList.splice(lruList.begin(), lruList, i->second.lruPos);
+        }else{
+            cacheMisses++;
+        }
+
+        pthread_mutex_unlock(&mmutex);
+
+        if(found){
             if(resp != loadingResponse){
                 return resp;
             }
         }else{
             if(loadIfNotPresent){
                 loadAsset(url);
-                return getAsset(url, false);
             }
         }
 
@@ -465,26 +1023,179 @@ namespace OB{
     }
 
     bool AssetLocator::hasAsset(std::string url){
-        return contentCache.count(url) != 0;
+        pthread_mutex_lock(&mmutex);
+        bool has = contentCache.count(url) != 0;
+        pthread_mutex_unlock(&mmutex);
+
+        return has;
     }
 
     void AssetLocator::putAsset(std::string url, size_t size, char* data){
-        std::map<std::string, shared_ptr<AssetResponse>>::iterator i = contentCache.find(url);
+        shared_ptr<AssetResponse> resp = make_shared<AssetResponse>(size, data, url, eng);
 
+        pthread_mutex_lock(&mmutex);
+        cachePut(url, resp);
+        pthread_mutex_unlock(&mmutex);
+    }
+
+    void AssetLocator::cachePut(std::string url, shared_ptr<AssetResponse> resp){
+        std::map<std::string, struct _ob_asset_cache_entry>::iterator i = contentCache.find(url);
         if(i != contentCache.end()){
-            contentCache.erase(i);
+            cacheSize -= i->second.resp->getSize();
+            i->second.resp = resp;
+            lruList.splice(lruList.begin(), lruList, i->second.lruPos);
+        }else{
+            lruList.push_front(url);
+
+            struct _ob_asset_cache_entry entry;
+            entry.resp = resp;
+            entry.lruPos = lruList.begin();
+            contentCache.emplace(url, entry);
         }
 
-        contentCache.emplace(url, make_shared<AssetResponse>(size, data, url, eng));
+        cacheSize += resp->getSize();
+
+        evictAssets();
+    }
+
+    void AssetLocator::cacheErase(std::map<std::string, struct _ob_asset_cache_entry>::iterator i){
+        cacheSize -= i->second.resp->getSize();
+        lruList.erase(i->second.lruPos);
+        contentCache.erase(i);
+    }
+
+    void AssetLocator::evictAssets(){
+        std::list<std::string>::iterator li = lruList.end();
+        while(cacheSize > cacheBudget && li != lruList.begin()){
+            li--;
+
+            std::map<std::string, struct _ob_asset_cache_entry>::iterator i = contentCache.find(*li);
+            if(i == contentCache.end()){
+                continue;
+            }
+
+            shared_ptr<AssetResponse> resp = i->second.resp;
+
+            // Loading placeholders hold no data, and anything still
+            // referenced outside of the cache stays pinned
+            if(resp == loadingResponse || resp.use_count() > 2){
+                continue;
+            }
+
+            // Step forward first, li is invalidated by cacheErase
+            std::list<std::string>::iterator next = li;
+            next++;
+
+            cacheErase(i);
+            cacheEvictions++;
+
+            li = next;
+        }
     }
 
     void AssetLocator::addWaitingInstance(shared_ptr<Instance::Instance> inst){
         if(inst){
+            pthread_mutex_lock(&waitingMutex);
             instancesWaiting.push_back(inst);
+            pthread_mutex_unlock(&waitingMutex);
         }
     }
 
+    bool AssetLocator::requireAsset(std::string url, shared_ptr<Instance::Instance> inst, Enum::AssetPriority priority){
+        if(url.empty()){
+            return false;
+        }
+
+        pthread_mutex_lock(&mmutex);
+        std::map<std::string, struct _ob_asset_cache_entry>::iterator i = contentCache.find(url);
+        bool loaded = i != contentCache.end() && i->second.resp != loadingResponse;
+        pthread_mutex_unlock(&mmutex);
+
+        if(loaded){
+            return true;
+        }
+
+        // Not loaded yet, or evicted since it last was
+        addWaitingInstance(inst);
+        loadAsset(url, priority);
+
+        return false;
+    }
+
+    void AssetLocator::setDiskCacheDirectory(std::string dir){
+        shared_ptr<AssetDiskCache> newCache;
+        if(!dir.empty()){
+            newCache = make_shared<AssetDiskCache>(dir);
+        }
+
+        pthread_mutex_lock(&mmutex);
+        diskCache = newCache;
+        pthread_mutex_unlock(&mmutex);
+    }
+
+    std::string AssetLocator::getDiskCacheDirectory(){
+        pthread_mutex_lock(&mmutex);
+        shared_ptr<AssetDiskCache> dCache = diskCache;
+        pthread_mutex_unlock(&mmutex);
+
+        if(dCache){
+            return dCache->getDirectory();
+        }
+        return "";
+    }
+
     int AssetLocator::getRequestQueueSize(){
-        return requestQueueSize;
+        pthread_mutex_lock(&mmutex);
+        int size = requestQueueSize;
+        pthread_mutex_unlock(&mmutex);
+
+        return size;
+    }
+
+    size_t AssetLocator::getCacheBudget(){
+        pthread_mutex_lock(&mmutex);
+        size_t budget = cacheBudget;
+        pthread_mutex_unlock(&mmutex);
+
+        return budget;
+    }
+
+    void AssetLocator::setCacheBudget(size_t budget){
+        pthread_mutex_lock(&mmutex);
+        cacheBudget = budget;
+        evictAssets();
+        pthread_mutex_unlock(&mmutex);
+    }
+
+    size_t AssetLocator::getCacheSize(){
+        pthread_mutex_lock(&mmutex);
+        size_t size = cacheSize;
+        pthread_mutex_unlock(&mmutex);
+
+        return size;
+    }
+
+    ob_uint64 AssetLocator::getCacheHits(){
+        pthread_mutex_lock(&mmutex);
+        ob_uint64 hits = cacheHits;
+        pthread_mutex_unlock(&mmutex);
+
+        return hits;
+    }
+
+    ob_uint64 AssetLocator::getCacheMisses(){
+        pthread_mutex_lock(&mmutex);
+        ob_uint64 misses = cacheMisses;
+        pthread_mutex_unlock(&mmutex);
+
+        return misses;
+    }
+
+    ob_uint64 AssetLocator::getCacheEvictions(){
+        pthread_mutex_lock(&mmutex);
+        ob_uint64 evictions = cacheEvictions;
+        pthread_mutex_unlock(&mmutex);
+
+        return evictions;
     }
 }
@@ -562,12 +562,10 @@ namespace OB{
 
 	void BitStream::writeUDim2(shared_ptr<Type::UDim2> var){
 		if(var){
-			shared_ptr<Type::UDim> x = var->getX();
-			shared_ptr<Type::UDim> y = var->getY();
-			writeDouble(x->getScale());
-			writeDouble(x->getOffset());
-			writeDouble(y->getScale());
-			writeDouble(y->getOffset());
+			writeDouble(var->getXScale());
+			writeDouble(var->getXOffset());
+			writeDouble(var->getYScale());
+			writeDouble(var->getYOffset());
 		}else{
 			writeDouble(0);
 			writeDouble(0);
@@ -582,7 +580,7 @@ namespace OB{
 		double yScale = readDouble();
 		double yOffset = readDouble();
 
-		return make_shared<Type::UDim2>(xScale, xOffset, yScale, yOffset);
+		return make_pooled<Type::UDim2>(xScale, xOffset, yScale, yOffset);
 	}
 
 	void BitStream::writeUDim(shared_ptr<Type::UDim> var){
@@ -599,7 +597,7 @@ namespace OB{
 		double scale = readDouble();
 		double offset = readDouble();
 
-		return make_shared<Type::UDim>(scale, offset);
+		return make_pooled<Type::UDim>(scale, offset);
 	}
 
 	void BitStream::writeColor3(shared_ptr<Type::Color3> var){
@@ -619,7 +617,7 @@ namespace OB{
 		int g = readInt();
 		int b = readInt();
 
-		return make_shared<Type::Color3>(r, g, b);
+		return make_pooled<Type::Color3>(r, g, b);
 	}
 
 	void BitStream::writeVector3(shared_ptr<Type::Vector3> var){
@@ -639,7 +637,7 @@ namespace OB{
 		double y = readDouble();
 		double z = readDouble();
 
-		return make_shared<Type::Vector3>(x, y, z);
+		return make_pooled<Type::Vector3>(x, y, z);
 	}
 
 	void BitStream::writeVector2(shared_ptr<Type::Vector2> var){
@@ -656,7 +654,7 @@ namespace OB{
 		double x = readDouble();
 		double y = readDouble();
 
-		return make_shared<Type::Vector2>(x, y);
+		return make_pooled<Type::Vector2>(x, y);
 	}
 
 	void BitStream::writeLuaEnum(shared_ptr<Type::LuaEnum> var){
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "BulletTaskScheduler.h"
+
+namespace OB{
+#if HAVE_BULLET_MT
+	struct _ob_bt_sum{
+		const btIParallelSumBody* body;
+		pthread_mutex_t mmutex;
+		btScalar sum;
+	};
+
+	static void _ob_bt_for(void* ud, int iBegin, int iEnd){
+		const btIParallelForBody* body = (const btIParallelForBody*)ud;
+		body->forLoop(iBegin, iEnd);
+	}
+
+	static void _ob_bt_sum(void* ud, int iBegin, int iEnd){
+		struct _ob_bt_sum* sum = (struct _ob_bt_sum*)ud;
+		btScalar partial = sum->body->sumLoop(iBegin, iEnd);
+
+		pthread_mutex_lock(&sum->mmutex);
+		sum->sum += partial;
+		pthread_mutex_unlock(&sum->mmutex);
+	}
+
+	BulletTaskScheduler::BulletTaskScheduler(shared_ptr<WorkerPool> pool) : btITaskScheduler("OpenBlox"){
+		this->pool = pool;
+	}
+
+	BulletTaskScheduler::~BulletTaskScheduler(){}
+
+	int BulletTaskScheduler::getMaxNumThreads() const{
+		return BT_MAX_THREAD_COUNT;
+	}
+
+	int BulletTaskScheduler::getNumThreads() const{
+		// The thread stepping the world takes part too
+		return pool->getNumThreads() + 1;
+	}
+
+	void BulletTaskScheduler::setNumThreads(int numThreads){
+		if(numThreads > BT_MAX_THREAD_COUNT){
+			numThreads = BT_MAX_THREAD_COUNT;
+		}
+		pool->setNumThreads(numThreads - 1);
+	}
+
+	void BulletTaskScheduler::parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body){
+		// Tells Bullet's thread-safety checks that workers are running
+		btPushThreadsAreRunning();
+		pool->parallelFor(iBegin, iEnd, grainSize, _ob_bt_for, (void*)&body);
+		btPopThreadsAreRunning();
+	}
+
+	btScalar BulletTaskScheduler::parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body){
+		struct _ob_bt_sum sum;
+		sum.body = &body;
+		pthread_mutex_init(&sum.mmutex, NULL);
+		sum.sum = 0;
+
+		btPushThreadsAreRunning();
+		pool->parallelFor(iBegin, iEnd, grainSize, _ob_bt_sum, &sum);
+		btPopThreadsAreRunning();
+
+		pthread_mutex_destroy(&sum.mmutex);
+		return sum.sum;
+	}
+#endif
+}
@@ -51,6 +51,7 @@
 #include "instance/DataModel.h"
 #include "instance/Humanoid.h"
 #include "instance/Folder.h"
+#include "instance/Actor.h"
 #include "instance/BasePart.h"
 #include "instance/MeshPart.h"
 #include "instance/Part.h"
@@ -191,6 +192,7 @@ namespace OB{
 		Instance::DataModel::registerClass();
 		Instance::Humanoid::registerClass();
 		Instance::Folder::registerClass();
+		Instance::Actor::registerClass();
 		Instance::BasePart::registerClass();
 		Instance::MeshPart::registerClass();
 		Instance::Part::registerClass();
@@ -0,0 +1,517 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "DownloadManager.h"
+
+#if HAVE_CURL
+
+#include "utility.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+namespace OB{
+	_ob_download_request::_ob_download_request(){
+		protocols = 0;
+		post = false;
+
+		callback = NULL;
+		ud = NULL;
+
+		ok = false;
+		responseCode = 0;
+		data = NULL;
+		size = 0;
+
+		done = false;
+		easy = NULL;
+		headerList = NULL;
+
+		pthread_cond_init(&cond, NULL);
+	}
+
+	_ob_download_request::~_ob_download_request(){
+		if(data){
+			free(data);
+		}
+
+		pthread_cond_destroy(&cond);
+	}
+
+	char* _ob_download_request::takeData(){
+		char* taken = data;
+		data = NULL;
+		size = 0;
+		return taken;
+	}
+
+#if LIBCURL_VERSION_NUM >= 0x075500
+	// CURLOPT_PROTOCOLS takes a bitmask, its replacement a list of names
+	static std::string _ob_download_protocols_str(long protocols){
+		static const struct{
+			long bit;
+			const char* name;
+		} names[] = {
+			{CURLPROTO_DICT, "dict"},
+			{CURLPROTO_FILE, "file"},
+			{CURLPROTO_FTP, "ftp"},
+			{CURLPROTO_FTPS, "ftps"},
+			{CURLPROTO_GOPHER, "gopher"},
+			{CURLPROTO_GOPHERS, "gophers"},
+			{CURLPROTO_HTTP, "http"},
+			{CURLPROTO_HTTPS, "https"},
+			{CURLPROTO_IMAP, "imap"},
+			{CURLPROTO_IMAPS, "imaps"},
+			{CURLPROTO_LDAP, "ldap"},
+			{CURLPROTO_LDAPS, "ldaps"},
+			{CURLPROTO_MQTT, "mqtt"},
+			{CURLPROTO_POP3, "pop3"},
+			{CURLPROTO_POP3S, "pop3s"},
+			{CURLPROTO_RTSP, "rtsp"},
+			{CURLPROTO_SCP, "scp"},
+			{CURLPROTO_SFTP, "sftp"},
+			{CURLPROTO_SMB, "smb"},
+			{CURLPROTO_SMBS, "smbs"},
+			{CURLPROTO_SMTP, "smtp"},
+			{CURLPROTO_SMTPS, "smtps"},
+			{CURLPROTO_TELNET, "telnet"},
+			{CURLPROTO_TFTP, "tftp"}
+		};
+
+		std::string str;
+		for(size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++){
+			if(protocols & names[i].bit){
+				if(!str.empty()){
+					str += ",";
+				}
+				str += names[i].name;
+			}
+		}
+
+		return str;
+	}
+#endif
+
+	void* _ob_download_thread(void* vdm){
+		DownloadManager* dm = (DownloadManager*)vdm;
+
+		dm->transferLoop();
+
+		pthread_exit(NULL);
+		return NULL;
+	}
+
+	DownloadManager::DownloadManager(){
+		pthread_mutex_init(&mmutex, NULL);
+		pthread_cond_init(&waitersCond, NULL);
+		for(int i = 0; i < CURL_LOCK_DATA_LAST; i++){
+			pthread_mutex_init(&shareMutex[i], NULL);
+		}
+
+		threadRunning = false;
+		stopping = false;
+		waiters = 0;
+		maxConcurrent = OB_DOWNLOAD_DEFAULT_MAX_CONCURRENT;
+
+		share = curl_share_init();
+		if(share){
+			curl_share_setopt(share, CURLSHOPT_LOCKFUNC, _ob_share_lock);
+			curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, _ob_share_unlock);
+			curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+			curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+			curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+		}
+
+		multi = curl_multi_init();
+		if(!multi){
+			startError = "Failed to initialize cURL.";
+			std::cout << "[DownloadManager] " << startError << std::endl;
+			return;
+		}
+
+		curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
+		int err = pthread_create(&transferThread, NULL, _ob_download_thread, this);
+		if(err != 0){
+			startError = "Failed to start the transfer thread: " + std::string(strerror(err));
+			std::cout << "[DownloadManager] " << startError << std::endl;
+			return;
+		}
+
+		threadRunning = true;
+	}
+
+	DownloadManager::~DownloadManager(){
+		pthread_mutex_lock(&mmutex);
+		stopping = true;
+		pthread_mutex_unlock(&mmutex);
+
+		if(threadRunning){
+#if LIBCURL_VERSION_NUM >= 0x074400
+			curl_multi_wakeup(multi);
+#endif
+
+			void* _stat;
+			pthread_join(transferThread, &_stat);
+		}
+
+		pthread_mutex_lock(&mmutex);
+
+		// Anything still outstanding is cancelled
+		for(std::map<CURL*, shared_ptr<struct _ob_download_request>>::iterator it = active.begin(); it != active.end(); ++it){
+			shared_ptr<struct _ob_download_request> req = it->second;
+
+			curl_multi_remove_handle(multi, req->easy);
+			curl_easy_cleanup(req->easy);
+			req->easy = NULL;
+
+			if(req->headerList){
+				curl_slist_free_all(req->headerList);
+				req->headerList = NULL;
+			}
+
+			failRequest(req, "Cancelled.");
+		}
+		for(std::deque<shared_ptr<struct _ob_download_request>>::iterator it = pending.begin(); it != pending.end(); ++it){
+			failRequest(*it, "Cancelled.");
+		}
+		active.clear();
+		pending.clear();
+		// Nothing is left to call these on
+		completed.clear();
+
+		// Callers woken above still need the mutex to return from wait
+		while(waiters > 0){
+			pthread_cond_wait(&waitersCond, &mmutex);
+		}
+
+		pthread_mutex_unlock(&mmutex);
+
+		if(multi){
+			curl_multi_cleanup(multi);
+		}
+		if(share){
+			curl_share_cleanup(share);
+		}
+
+		for(int i = 0; i < CURL_LOCK_DATA_LAST; i++){
+			pthread_mutex_destroy(&shareMutex[i]);
+		}
+		pthread_cond_destroy(&waitersCond);
+		pthread_mutex_destroy(&mmutex);
+	}
+
+	void DownloadManager::_ob_share_lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr){
+		(void)handle;
+		(void)access;
+
+		DownloadManager* dm = (DownloadManager*)userptr;
+		pthread_mutex_lock(&dm->shareMutex[data]);
+	}
+
+	void DownloadManager::_ob_share_unlock(CURL* handle, curl_lock_data data, void* userptr){
+		(void)handle;
+
+		DownloadManager* dm = (DownloadManager*)userptr;
+		pthread_mutex_unlock(&dm->shareMutex[data]);
+	}
+
+	size_t DownloadManager::_ob_download_write_data(void* ptr, size_t size, size_t nmemb, struct _ob_download_request* req){
+		size_t n = size * nmemb;
+
+		char* tmp = (char*)realloc(req->data, req->size + n);
+		if(!tmp){
+			std::cout << "[DownloadManager] Failed to allocate memory." << std::endl;
+			return 0;
+		}
+
+		req->data = tmp;
+		memcpy(req->data + req->size, ptr, n);
+		req->size += n;
+
+		return n;
+	}
+
+	size_t DownloadManager::_ob_download_header_data(char* buffer, size_t size, size_t nitems, struct _ob_download_request* req){
+		size_t n = size * nitems;
+		std::string line(buffer, n);
+
+		// A new status line means a redirect was followed, forget the last response's headers
+		if(ob_str_startsWith(line, "HTTP/")){
+			req->responseHeaders.clear();
+			return n;
+		}
+
+		size_t colon = line.find(':');
+		if(colon == std::string::npos){
+			return n;
+		}
+
+		std::string name = line.substr(0, colon);
+		std::string value = line.substr(colon + 1);
+		trim(name);
+		trim(value);
+
+		std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+		req->responseHeaders[name] = value;
+
+		return n;
+	}
+
+	void DownloadManager::submit(shared_ptr<struct _ob_download_request> req){
+		if(!req){
+			return;
+		}
+
+		pthread_mutex_lock(&mmutex);
+
+		if(!threadRunning){
+			failRequest(req, startError);
+			pthread_mutex_unlock(&mmutex);
+			return;
+		}
+
+		pending.push_back(req);
+		pthread_mutex_unlock(&mmutex);
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+		curl_multi_wakeup(multi);
+#endif
+	}
+
+	void DownloadManager::perform(shared_ptr<struct _ob_download_request> req){
+		if(!req){
+			return;
+		}
+
+		submit(req);
+		wait(req);
+	}
+
+	void DownloadManager::wait(shared_ptr<struct _ob_download_request> req){
+		if(!req){
+			return;
+		}
+
+		pthread_mutex_lock(&mmutex);
+
+		waiters++;
+		while(!req->done){
+			pthread_cond_wait(&req->cond, &mmutex);
+		}
+		waiters--;
+
+		if(waiters == 0 && stopping){
+			pthread_cond_broadcast(&waitersCond);
+		}
+
+		pthread_mutex_unlock(&mmutex);
+	}
+
+	void DownloadManager::tick(){
+		pthread_mutex_lock(&mmutex);
+		std::deque<shared_ptr<struct _ob_download_request>> toDispatch;
+		toDispatch.swap(completed);
+		pthread_mutex_unlock(&mmutex);
+
+		for(std::deque<shared_ptr<struct _ob_download_request>>::iterator it = toDispatch.begin(); it != toDispatch.end(); ++it){
+			shared_ptr<struct _ob_download_request> req = *it;
+			req->callback(req, req->ud);
+		}
+	}
+
+	int DownloadManager::getMaxConcurrent(){
+		pthread_mutex_lock(&mmutex);
+		int maxC = maxConcurrent;
+		pthread_mutex_unlock(&mmutex);
+
+		return maxC;
+	}
+
+	void DownloadManager::setMaxConcurrent(int maxConcurrent){
+		if(maxConcurrent < 1){
+			maxConcurrent = 1;
+		}
+
+		pthread_mutex_lock(&mmutex);
+		this->maxConcurrent = maxConcurrent;
+		pthread_mutex_unlock(&mmutex);
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+		if(multi){
+			curl_multi_wakeup(multi);
+		}
+#endif
+	}
+
+	int DownloadManager::getOutstandingCount(){
+		pthread_mutex_lock(&mmutex);
+		int count = pending.size() + active.size();
+		pthread_mutex_unlock(&mmutex);
+
+		return count;
+	}
+
+	void DownloadManager::failRequest(shared_ptr<struct _ob_download_request> req, std::string error){
+		req->ok = false;
+		req->error = error;
+		req->done = true;
+		pthread_cond_broadcast(&req->cond);
+
+		if(req->callback){
+			completed.push_back(req);
+		}
+	}
+
+	void DownloadManager::startTransfer(shared_ptr<struct _ob_download_request> req){
+		CURL* easy = curl_easy_init();
+		if(!easy){
+			failRequest(req, "Failed to initialize cURL.");
+			return;
+		}
+
+		curl_easy_setopt(easy, CURLOPT_URL, req->url.c_str());
+		curl_easy_setopt(easy, CURLOPT_NOPROGRESS, 1L);
+		curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+		curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+		if(req->protocols != 0){
+#if LIBCURL_VERSION_NUM >= 0x075500
+			std::string protocols = _ob_download_protocols_str(req->protocols);
+			curl_easy_setopt(easy, CURLOPT_PROTOCOLS_STR, protocols.c_str());
+			curl_easy_setopt(easy, CURLOPT_REDIR_PROTOCOLS_STR, protocols.c_str());
+#else
+			curl_easy_setopt(easy, CURLOPT_PROTOCOLS, req->protocols);
+			curl_easy_setopt(easy, CURLOPT_REDIR_PROTOCOLS, req->protocols);
+#endif
+		}
+		curl_easy_setopt(easy, CURLOPT_DEFAULT_PROTOCOL, "https");
+		curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, _ob_download_write_data);
+		curl_easy_setopt(easy, CURLOPT_WRITEDATA, req.get());
+		curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, _ob_download_header_data);
+		curl_easy_setopt(easy, CURLOPT_HEADERDATA, req.get());
+
+		// Reuse connections, multiplexing over HTTP/2 where the server allows it
+		curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+		curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+		if(share){
+			curl_easy_setopt(easy, CURLOPT_SHARE, share);
+		}
+
+		for(std::vector<std::string>::iterator it = req->headers.begin(); it != req->headers.end(); ++it){
+			req->headerList = curl_slist_append(req->headerList, it->c_str());
+		}
+		if(req->headerList){
+			curl_easy_setopt(easy, CURLOPT_HTTPHEADER, req->headerList);
+		}
+
+		if(req->post){
+			curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, (long)req->postData.size());
+			curl_easy_setopt(easy, CURLOPT_POSTFIELDS, req->postData.c_str());
+		}
+
+		req->easy = easy;
+		active[easy] = req;
+
+		curl_multi_add_handle(multi, easy);
+	}
+
+	void DownloadManager::finishTransfer(CURL* easy, CURLcode result){
+		std::map<CURL*, shared_ptr<struct _ob_download_request>>::iterator it = active.find(easy);
+		if(it == active.end()){
+			return;
+		}
+
+		shared_ptr<struct _ob_download_request> req = it->second;
+		active.erase(it);
+
+		curl_multi_remove_handle(multi, easy);
+
+		curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &req->responseCode);
+
+		if(result == CURLE_OK){
+			req->ok = true;
+		}else{
+			req->ok = false;
+			req->error = std::string(curl_easy_strerror(result));
+		}
+
+		curl_easy_cleanup(easy);
+		req->easy = NULL;
+
+		if(req->headerList){
+			curl_slist_free_all(req->headerList);
+			req->headerList = NULL;
+		}
+
+		req->done = true;
+		pthread_cond_broadcast(&req->cond);
+
+		if(req->callback){
+			completed.push_back(req);
+		}
+	}
+
+	void DownloadManager::transferLoop(){
+		while(true){
+			pthread_mutex_lock(&mmutex);
+
+			if(stopping){
+				pthread_mutex_unlock(&mmutex);
+				return;
+			}
+
+			while((int)active.size() < maxConcurrent && !pending.empty()){
+				shared_ptr<struct _ob_download_request> req = pending.front();
+				pending.pop_front();
+
+				startTransfer(req);
+			}
+
+			pthread_mutex_unlock(&mmutex);
+
+			int running = 0;
+			curl_multi_perform(multi, &running);
+
+			int msgsLeft = 0;
+			CURLMsg* msg;
+			while((msg = curl_multi_info_read(multi, &msgsLeft))){
+				if(msg->msg == CURLMSG_DONE){
+					CURL* easy = msg->easy_handle;
+					CURLcode result = msg->data.result;
+
+					pthread_mutex_lock(&mmutex);
+					finishTransfer(easy, result);
+					pthread_mutex_unlock(&mmutex);
+				}
+			}
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+			// Woken early by curl_multi_wakeup when there's new work
+			curl_multi_poll(multi, NULL, 0, 1000, NULL);
+#else
+			int numfds = 0;
+			curl_multi_wait(multi, NULL, 0, 50, &numfds);
+#endif
+		}
+	}
+}
+
+#endif
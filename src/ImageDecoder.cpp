@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "ImageDecoder.h"
+
+#if HAVE_SDL2
+
+#include "AssetLocator.h"
+#include "WorkerPool.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+namespace OB{
+	_ob_decoded_image::_ob_decoded_image(){
+		width = 0;
+		height = 0;
+		pixels = NULL;
+	}
+
+	_ob_decoded_image::~_ob_decoded_image(){
+		if(pixels){
+			free(pixels);
+		}
+	}
+
+	struct _ob_image_decode_job{
+		ImageDecoder* decoder;
+		std::string url;
+		shared_ptr<AssetResponse> resp;
+	};
+
+	static void _ob_image_decode_job_fnc(void* ud){
+		struct _ob_image_decode_job* job = (struct _ob_image_decode_job*)ud;
+
+		job->decoder->decodeJob(job->url, job->resp);
+
+		delete job;
+	}
+
+	ImageDecoder::ImageDecoder(shared_ptr<WorkerPool> pool){
+		this->pool = pool;
+
+		pthread_mutex_init(&mmutex, NULL);
+		pthread_cond_init(&idleCond, NULL);
+
+		decodedSize = 0;
+		maxDecodedSize = OB_IMAGEDECODER_DEFAULT_MAX_DECODED;
+		outstanding = 0;
+
+		// SDL_image initializes loaders lazily otherwise, which
+		// isn't safe with several threads decoding at once
+		IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+	}
+
+	ImageDecoder::~ImageDecoder(){
+		// Jobs still queued point at us
+		pthread_mutex_lock(&mmutex);
+		while(outstanding > 0){
+			pthread_cond_wait(&idleCond, &mmutex);
+		}
+		pthread_mutex_unlock(&mmutex);
+
+		IMG_Quit();
+
+		pthread_cond_destroy(&idleCond);
+		pthread_mutex_destroy(&mmutex);
+	}
+
+	shared_ptr<struct _ob_decoded_image> ImageDecoder::decode(const char* data, size_t size, std::string& error){
+		if(!data || size == 0){
+			error = "No data.";
+			return NULL;
+		}
+		if(size > INT_MAX){
+			error = "Image too large.";
+			return NULL;
+		}
+
+		SDL_RWops* rw = SDL_RWFromConstMem(data, (int)size);
+		if(!rw){
+			error = std::string(SDL_GetError());
+			return NULL;
+		}
+
+		// Frees rw
+		SDL_Surface* surf = IMG_Load_RW(rw, 1);
+		if(!surf){
+			error = std::string(IMG_GetError());
+			return NULL;
+		}
+
+		SDL_Surface* conv = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_ARGB8888, 0);
+		SDL_FreeSurface(surf);
+		if(!conv){
+			error = std::string(SDL_GetError());
+			return NULL;
+		}
+
+		shared_ptr<struct _ob_decoded_image> img = make_shared<struct _ob_decoded_image>();
+		img->width = conv->w;
+		img->height = conv->h;
+
+		size_t rowSize = (size_t)conv->w * 4;
+		img->pixels = (unsigned char*)malloc(rowSize * conv->h);
+		if(!img->pixels){
+			SDL_FreeSurface(conv);
+
+			error = "Out of memory.";
+			return NULL;
+		}
+
+		if(SDL_MUSTLOCK(conv)){
+			SDL_LockSurface(conv);
+		}
+
+		for(int y = 0; y < conv->h; y++){
+			memcpy(img->pixels + rowSize * y, (unsigned char*)conv->pixels + (size_t)conv->pitch * y, rowSize);
+		}
+
+		if(SDL_MUSTLOCK(conv)){
+			SDL_UnlockSurface(conv);
+		}
+
+		SDL_FreeSurface(conv);
+
+		return img;
+	}
+
+	void ImageDecoder::request(std::string url, shared_ptr<AssetResponse> resp){
+		if(!resp){
+			return;
+		}
+
+		pthread_mutex_lock(&mmutex);
+
+		if(decoding.count(url) != 0 || decoded.count(url) != 0 || failed.count(url) != 0){
+			pthread_mutex_unlock(&mmutex);
+			return;
+		}
+
+		decoding.insert(url);
+		outstanding++;
+
+		pthread_mutex_unlock(&mmutex);
+
+		struct _ob_image_decode_job* job = new struct _ob_image_decode_job;
+		job->decoder = this;
+		job->url = url;
+		job->resp = resp;
+
+		pool->enqueue(_ob_image_decode_job_fnc, job);
+	}
+
+	void ImageDecoder::decodeJob(std::string url, shared_ptr<AssetResponse> resp){
+		std::string error;
+		shared_ptr<struct _ob_decoded_image> img = decode(resp->getData(), resp->getSize(), error);
+
+		pthread_mutex_lock(&mmutex);
+
+		decoding.erase(url);
+
+		if(stale.erase(url) == 0){
+			if(img){
+				decodedOrder.push_back(url);
+
+				struct _ob_decoded_entry entry;
+				entry.img = img;
+				entry.orderPos = --decodedOrder.end();
+				decoded.emplace(url, entry);
+
+				decodedSize += (size_t)img->width * img->height * 4;
+
+				trimDecoded();
+			}else{
+				failed.insert(url);
+			}
+		}
+
+		outstanding--;
+		if(outstanding == 0){
+			pthread_cond_broadcast(&idleCond);
+		}
+
+		pthread_mutex_unlock(&mmutex);
+	}
+
+	shared_ptr<struct _ob_decoded_image> ImageDecoder::take(std::string url){
+		shared_ptr<struct _ob_decoded_image> img;
+
+		pthread_mutex_lock(&mmutex);
+
+		std::map<std::string, struct _ob_decoded_entry>::iterator it = decoded.find(url);
+		if(it != decoded.end()){
+			img = it->second.img;
+			eraseDecoded(it);
+		}
+
+		pthread_mutex_unlock(&mmutex);
+
+		return img;
+	}
+
+	bool ImageDecoder::isDecoding(std::string url){
+		pthread_mutex_lock(&mmutex);
+		bool isDec = decoding.count(url) != 0;
+		pthread_mutex_unlock(&mmutex);
+
+		return isDec;
+	}
+
+	bool ImageDecoder::hasFailed(std::string url){
+		pthread_mutex_lock(&mmutex);
+		bool hasF = failed.count(url) != 0;
+		pthread_mutex_unlock(&mmutex);
+
+		return hasF;
+	}
+
+	void ImageDecoder::forget(std::string url){
+		pthread_mutex_lock(&mmutex);
+
+		if(decoding.count(url) != 0){
+			stale.insert(url);
+		}
+
+		std::map<std::string, struct _ob_decoded_entry>::iterator it = decoded.find(url);
+		if(it != decoded.end()){
+			eraseDecoded(it);
+		}
+
+		failed.erase(url);
+
+		pthread_mutex_unlock(&mmutex);
+	}
+
+	size_t ImageDecoder::getDecodedSize(){
+		pthread_mutex_lock(&mmutex);
+		size_t siz = decodedSize;
+		pthread_mutex_unlock(&mmutex);
+
+		return siz;
+	}
+
+	size_t ImageDecoder::getMaxDecodedSize(){
+		pthread_mutex_lock(&mmutex);
+		size_t siz = maxDecodedSize;
+		pthread_mutex_unlock(&mmutex);
+
+		return siz;
+	}
+
+	void ImageDecoder::setMaxDecodedSize(size_t maxSize){
+		pthread_mutex_lock(&mmutex);
+		maxDecodedSize = maxSize;
+		trimDecoded();
+		pthread_mutex_unlock(&mmutex);
+	}
+
+	void ImageDecoder::eraseDecoded(std::map<std::string, struct _ob_decoded_entry>::iterator it){
+		shared_ptr<struct _ob_decoded_image> img = it->second.img;
+		decodedSize -= (size_t)img->width * img->height * 4;
+
+		decodedOrder.erase(it->second.orderPos);
+		decoded.erase(it);
+	}
+
+	void ImageDecoder::trimDecoded(){
+		// Nobody took these in time, they're decoded again if asked for
+		while(decodedSize > maxDecodedSize && decodedOrder.size() > 1){
+			std::map<std::string, struct _ob_decoded_entry>::iterator it = decoded.find(decodedOrder.front());
+			if(it == decoded.end()){
+				decodedOrder.pop_front();
+				continue;
+			}
+
+			eraseDecoded(it);
+		}
+	}
+}
+
+#endif
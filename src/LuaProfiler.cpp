@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "LuaProfiler.h"
+
+#include "OBEngine.h"
+
+#include <fstream>
+#include <vector>
+
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+namespace OB{
+	// Address used as the registry key for the active profiler
+	static char _ob_luaprofiler_key;
+
+	static void _ob_luaprofiler_hook(lua_State* L, lua_Debug* ar){
+		(void)ar;
+
+		lua_rawgetp(L, LUA_REGISTRYINDEX, &_ob_luaprofiler_key);
+		LuaProfiler* prof = (LuaProfiler*)lua_touserdata(L, -1);
+		lua_pop(L, 1);
+
+		if(prof){
+			prof->sample(L);
+		}
+	}
+
+	static void* _ob_luaprofiler_timer(void* vprof){
+		LuaProfiler* prof = (LuaProfiler*)vprof;
+		prof->timerLoop();
+
+		pthread_exit(NULL);
+		return NULL;
+	}
+
+	LuaProfiler::LuaProfiler(OBEngine* eng){
+		this->eng = eng;
+
+		running = false;
+		sampleDue = false;
+		sampleInterval = OB_LUAPROFILER_DEFAULT_INTERVAL;
+		sampleCount = 0;
+
+		pthread_mutex_init(&mmutex, NULL);
+	}
+
+	LuaProfiler::~LuaProfiler(){
+		stop();
+
+		pthread_mutex_destroy(&mmutex);
+	}
+
+	bool LuaProfiler::start(){
+		if(running){
+			return true;
+		}
+
+		lua_State* gL = eng->getGlobalLuaState();
+		if(!gL){
+			return false;
+		}
+
+		lua_pushlightuserdata(gL, this);
+		lua_rawsetp(gL, LUA_REGISTRYINDEX, &_ob_luaprofiler_key);
+
+		sampleDue = false;
+		running = true;
+
+		// New threads inherit the hook of the state they are created from
+		Lua::set_hook_all(eng, _ob_luaprofiler_hook, LUA_MASKCOUNT, OB_LUAPROFILER_HOOK_COUNT);
+
+		if(pthread_create(&timerThread, NULL, _ob_luaprofiler_timer, this) != 0){
+			running = false;
+
+			Lua::set_hook_all(eng, NULL, 0, 0);
+
+			lua_pushnil(gL);
+			lua_rawsetp(gL, LUA_REGISTRYINDEX, &_ob_luaprofiler_key);
+
+			return false;
+		}
+
+		return true;
+	}
+
+	void LuaProfiler::stop(){
+		if(!running){
+			return;
+		}
+
+		running = false;
+
+		void* _stat;
+		pthread_join(timerThread, &_stat);
+
+		Lua::set_hook_all(eng, NULL, 0, 0);
+
+		lua_State* gL = eng->getGlobalLuaState();
+		if(gL){
+			lua_pushnil(gL);
+			lua_rawsetp(gL, LUA_REGISTRYINDEX, &_ob_luaprofiler_key);
+		}
+
+		sampleDue = false;
+	}
+
+	bool LuaProfiler::isRunning(){
+		return running;
+	}
+
+	unsigned int LuaProfiler::getSampleInterval(){
+		return sampleInterval;
+	}
+
+	void LuaProfiler::setSampleInterval(unsigned int interval){
+		if(interval == 0){
+			interval = 1;
+		}
+		sampleInterval = interval;
+	}
+
+	void LuaProfiler::reset(){
+		pthread_mutex_lock(&mmutex);
+		stacks.clear();
+		sampleCount = 0;
+		pthread_mutex_unlock(&mmutex);
+	}
+
+	ob_uint64 LuaProfiler::getSampleCount(){
+		pthread_mutex_lock(&mmutex);
+		ob_uint64 count = sampleCount;
+		pthread_mutex_unlock(&mmutex);
+
+		return count;
+	}
+
+	std::string LuaProfiler::getFoldedStacks(){
+		std::string out = "";
+
+		pthread_mutex_lock(&mmutex);
+		for(std::map<std::string, ob_uint64>::iterator it = stacks.begin(); it != stacks.end(); ++it){
+			out = out + it->first + " " + std::to_string(it->second) + "\n";
+		}
+		pthread_mutex_unlock(&mmutex);
+
+		return out;
+	}
+
+	bool LuaProfiler::dumpFoldedStacks(std::string path){
+		std::ofstream out(path.c_str(), std::ios::out | std::ios::trunc);
+		if(!out.is_open()){
+			return false;
+		}
+
+		out << getFoldedStacks();
+		out.close();
+
+		return !out.fail();
+	}
+
+	void LuaProfiler::sample(lua_State* L){
+		if(!sampleDue.exchange(false)){
+			return;
+		}
+
+		std::vector<std::string> frames;
+
+		lua_Debug ar;
+		int level = 0;
+		while(level < OB_LUAPROFILER_MAX_DEPTH && lua_getstack(L, level, &ar)){
+			if(!lua_getinfo(L, "Sn", &ar)){
+				break;
+			}
+
+			std::string frame;
+
+			if(ar.what && std::string(ar.what) == "C"){
+				frame = "[C]:";
+				frame = frame + (ar.name ? ar.name : "?");
+			}else{
+				std::string source = ar.source ? ar.source : "?";
+				if(source.length() > 0 && (source[0] == '@' || source[0] == '=')){
+					// Chunk names are "@" + GetFullName()
+					source = source.substr(1);
+				}else{
+					source = ar.short_src;
+				}
+
+				if(ar.what && std::string(ar.what) == "main"){
+					frame = source + ":<main>";
+				}else{
+					frame = source + ":" + (ar.name ? ar.name : "?") + ":" + std::to_string(ar.linedefined);
+				}
+			}
+
+			frames.push_back(frame);
+			level++;
+		}
+
+		if(frames.empty()){
+			return;
+		}
+
+		// Folded stacks are ordered root to leaf
+		std::string folded = "";
+		for(std::vector<std::string>::reverse_iterator it = frames.rbegin(); it != frames.rend(); ++it){
+			if(!folded.empty()){
+				folded = folded + ";";
+			}
+			folded = folded + *it;
+		}
+
+		pthread_mutex_lock(&mmutex);
+		stacks[folded]++;
+		sampleCount++;
+		pthread_mutex_unlock(&mmutex);
+	}
+
+	void LuaProfiler::timerLoop(){
+		while(running){
+			usleep(sampleInterval);
+
+			sampleDue = true;
+		}
+	}
+}
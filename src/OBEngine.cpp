@@ -35,8 +35,10 @@
 #include <string>
 
 #include "instance/Lighting.h"
+#include "instance/Actor.h"
 
 #include "type/Type.h"
+#include "type/Event.h"
 #include "type/Color3.h"
 
 #ifndef _MSC_VER
@@ -61,6 +63,10 @@ namespace OB{
 
 		logger = make_shared<OBLogger>(this);
 
+		luaAllocator = make_shared<Lua::LuaAllocator>();
+
+		eventQueue = make_shared<Type::EventQueue>();
+
 		ClassFactory::registerCoreClasses();
 
 		initialized = false;
@@ -73,6 +79,7 @@ namespace OB{
 		startHeight = 480;
 		vsync = false;
 		resizable = false;
+		workerThreads = WorkerPool::getDefaultNumThreads();
 
 		globalState = NULL;
 
@@ -98,12 +105,27 @@ namespace OB{
 
 		renderUtils = NULL;
 
+#if HAVE_BULLET_MT
+		bulletTaskSched = NULL;
+#endif
+
 #if HAVE_ENET
 		enet_initialize();
 #endif
+
+#if HAVE_CURL
+		// Not thread safe, so do it before anything else touches cURL
+		curl_global_init(CURL_GLOBAL_DEFAULT);
+#endif
 	}
 
 	OBEngine::~OBEngine(){
+		// Its hooks and timer thread use the Lua states, which go with luaAllocator
+		if(luaProfiler){
+			luaProfiler->stop();
+			luaProfiler = NULL;
+		}
+
 		// Assumptions like this are bad, oh well.
 #if HAVE_ENET
 		enet_deinitialize();
@@ -114,6 +136,27 @@ namespace OB{
 			SDL_DestroyWindow(sdl_window);
 		}
 #endif
+
+#if HAVE_BULLET_MT
+		if(bulletTaskSched){
+			if(btGetTaskScheduler() == bulletTaskSched){
+				btSetTaskScheduler(btGetSequentialTaskScheduler());
+			}
+			delete bulletTaskSched;
+		}
+#endif
+
+#if HAVE_SDL2
+		// Waits for its jobs, so it has to go before the worker pool
+		imageDecoder = NULL;
+#endif
+
+#if HAVE_CURL
+		// Has to go before curl_global_cleanup
+		downloadManager = NULL;
+
+		curl_global_cleanup();
+#endif
 	}
 
 	shared_ptr<TaskScheduler> OBEngine::getTaskScheduler(){
@@ -331,12 +374,33 @@ namespace OB{
 		secondaryTaskSched = make_shared<TaskScheduler>(this);
 		secondaryTaskSched->SetSortsTasks(false);
 
+#if HAVE_CURL
+		downloadManager = make_shared<DownloadManager>();
+#endif
+
 		assetLocator = make_shared<AssetLocator>(this);
+		if(!assetCacheDir.empty()){
+			assetLocator->setDiskCacheDirectory(assetCacheDir);
+		}
 
 		pluginManager = make_shared<PluginManager>(this);
 
+		workerPool = make_shared<WorkerPool>(workerThreads);
+
+#if HAVE_SDL2
+		imageDecoder = make_shared<ImageDecoder>(workerPool);
+#endif
+
+#if HAVE_BULLET_MT
+		// Must be installed from the main thread
+		bulletTaskSched = new BulletTaskScheduler(workerPool);
+		btSetTaskScheduler(bulletTaskSched);
+#endif
+
 		globalState = OB::Lua::initGlobal(this);
 
+		luaProfiler = make_shared<LuaProfiler>(this);
+
 		dm = make_shared<Instance::DataModel>(this);
 		dm->initServices();
 
@@ -422,6 +486,18 @@ namespace OB{
 #endif
 
 		taskSched->tick();
+
+#if HAVE_CURL
+		downloadManager->tick();
+#endif
+
+		assetLocator->tick();
+
+		eventQueue->dispatchDeferred();
+
+		// Sync point for Actors running on worker threads
+		Instance::Actor::syncAll(this);
+
 		dm->tick();
 
 		if(!doRendering){
@@ -584,6 +660,18 @@ namespace OB{
 		return assetLocator;
 	}
 
+#if HAVE_CURL
+	shared_ptr<DownloadManager> OBEngine::getDownloadManager(){
+		return downloadManager;
+	}
+#endif
+
+#if HAVE_SDL2
+	shared_ptr<ImageDecoder> OBEngine::getImageDecoder(){
+		return imageDecoder;
+	}
+#endif
+
 	shared_ptr<PluginManager> OBEngine::getPluginManager(){
 		return pluginManager;
 	}
@@ -592,6 +680,49 @@ namespace OB{
 		return logger;
 	}
 
+	shared_ptr<LuaProfiler> OBEngine::getLuaProfiler(){
+		return luaProfiler;
+	}
+
+	shared_ptr<Lua::LuaAllocator> OBEngine::getLuaAllocator(){
+		return luaAllocator;
+	}
+
+	shared_ptr<Type::EventQueue> OBEngine::getEventQueue(){
+		return eventQueue;
+	}
+
+	shared_ptr<WorkerPool> OBEngine::getWorkerPool(){
+		return workerPool;
+	}
+
+	int OBEngine::getWorkerThreads(){
+		return workerThreads;
+	}
+
+	void OBEngine::setWorkerThreads(int numThreads){
+		if(numThreads < 0){
+			numThreads = 0;
+		}
+		workerThreads = numThreads;
+
+		if(workerPool){
+			workerPool->setNumThreads(numThreads);
+		}
+	}
+
+	std::string OBEngine::getAssetCacheDirectory(){
+		return assetCacheDir;
+	}
+
+	void OBEngine::setAssetCacheDirectory(std::string dir){
+		assetCacheDir = dir;
+
+		if(assetLocator){
+			assetLocator->setDiskCacheDirectory(dir);
+		}
+	}
+
 	OBInputEventReceiver* OBEngine::getInputEventReceiver(){
 		return eventReceiver;
 	}
@@ -462,11 +462,11 @@ namespace OB{
 								break;
 							}
 							case irr::EMIE_MOUSE_WHEEL: {
-								uis->input_mouseWheel(make_shared<Type::Vector2>(0, evt.MouseInput.Wheel));
+								uis->input_mouseWheel(make_pooled<Type::Vector2>(0, evt.MouseInput.Wheel));
 								break;
 							}
 							case irr::EMIE_MOUSE_MOVED: {
-								uis->input_mouseMoved(make_shared<Type::Vector2>(evt.MouseInput.X, evt.MouseInput.Y), NULL);
+								uis->input_mouseMoved(make_pooled<Type::Vector2>(evt.MouseInput.X, evt.MouseInput.Y), NULL);
 								break;
 							}
 						}
@@ -974,7 +974,7 @@ namespace OB{
 						break;
 					}
 					case SDL_MOUSEMOTION: {
-						uis->input_mouseMoved(make_shared<Type::Vector2>(evt.motion.x, evt.motion.y), make_shared<Type::Vector2>(evt.motion.xrel, evt.motion.yrel));
+						uis->input_mouseMoved(make_pooled<Type::Vector2>(evt.motion.x, evt.motion.y), make_pooled<Type::Vector2>(evt.motion.xrel, evt.motion.yrel));
 						break;
 					}
 					case SDL_MOUSEBUTTONDOWN: {
@@ -1032,7 +1032,7 @@ namespace OB{
 						uis->input_mouseButton(mbtn, false);
 					}
 					case SDL_MOUSEWHEEL: {
-						uis->input_mouseWheel(make_shared<Type::Vector2>(evt.wheel.x, evt.wheel.y));
+						uis->input_mouseWheel(make_pooled<Type::Vector2>(evt.wheel.x, evt.wheel.y));
 						break;
 					}
 				}
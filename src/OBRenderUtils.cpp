@@ -55,6 +55,8 @@ namespace OB{
 		irrDriv = irrDev->getVideoDriver();
 		irrSceneMgr = irrDev->getSceneManager();
 
+		textureCache = make_shared<TextureCache>(make_shared<IrrlichtTextureDriver>(eng, irrDriv));
+
 		cached2DMode = false;
 	}
 
@@ -89,6 +91,18 @@ namespace OB{
 		return false;
 	}
 
+	shared_ptr<TextureCache> OBRenderUtils::getTextureCache(){
+		return textureCache;
+	}
+
+	irr::video::ITexture* OBRenderUtils::acquireTexture(std::string url, int flags, bool& pending){
+		return (irr::video::ITexture*)textureCache->acquire(url, flags, pending);
+	}
+
+	void OBRenderUtils::releaseTexture(irr::video::ITexture* tex){
+		textureCache->release(tex);
+	}
+
 	// STATIC FUNCTIONS
 
 #if HAVE_SDL2
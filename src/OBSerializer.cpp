@@ -104,7 +104,7 @@ namespace OB{
 		if(eng){
 			shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 			if(assetLoc){
-				assetLoc->loadAssetSync(loadURI, false, true);
+				assetLoc->loadAssetSync(loadURI, true);
 				shared_ptr<AssetResponse> resp = assetLoc->getAsset(loadURI, false);
 				if(resp){
 					return LoadModelFromMemory_XML(resp->getData(), resp->getSize());
@@ -150,7 +150,7 @@ namespace OB{
 		if(eng){
 			shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 			if(assetLoc){
-				assetLoc->loadAssetSync(loadURI, false, true);
+				assetLoc->loadAssetSync(loadURI, true);
 				shared_ptr<AssetResponse> resp = assetLoc->getAsset(loadURI, false);
 				if(resp){
 					return LoadFromMemory_XML(resp->getData(), resp->getSize());
@@ -279,7 +279,7 @@ namespace OB{
 		if(eng){
 			shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 			if(assetLoc){
-				assetLoc->loadAssetSync(loadURI, false, true);
+				assetLoc->loadAssetSync(loadURI, true);
 				shared_ptr<AssetResponse> resp = assetLoc->getAsset(loadURI, false);
 				if(resp){
 					return LoadModelFromMemory_binary(resp->getData(), resp->getSize());
@@ -300,7 +300,7 @@ namespace OB{
 		if(eng){
 			shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 			if(assetLoc){
-				assetLoc->loadAssetSync(loadURI, false, true);
+				assetLoc->loadAssetSync(loadURI, true);
 				shared_ptr<AssetResponse> resp = assetLoc->getAsset(loadURI, false);
 				if(resp){
 					return LoadFromMemory_binary(resp->getData(), resp->getSize());
@@ -351,7 +351,7 @@ namespace OB{
 			if(eng){
 				shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 				if(assetLoc){
-					assetLoc->loadAssetSync(loadURI, false, true);
+					assetLoc->loadAssetSync(loadURI, true);
 					shared_ptr<AssetResponse> resp = assetLoc->getAsset(loadURI, false);
 					if(resp){
 						return LoadModelFromMemory(resp->getData(), resp->getSize());
@@ -380,7 +380,7 @@ namespace OB{
 			if(eng){
 				shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 				if(assetLoc){
-					assetLoc->loadAssetSync(loadURI, false, true);
+					assetLoc->loadAssetSync(loadURI, true);
 					shared_ptr<AssetResponse> resp = assetLoc->getAsset(loadURI, false);
 					if(resp){
 						return LoadFromMemory(resp->getData(), resp->getSize());
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "TextureCache.h"
+
+#include "OBEngine.h"
+#include "AssetLocator.h"
+#include "ImageDecoder.h"
+
+namespace OB{
+	TextureDriver::~TextureDriver(){}
+
+	bool _ob_texture_key::operator<(const struct _ob_texture_key& other) const{
+		if(flags != other.flags){
+			return flags < other.flags;
+		}
+		return url < other.url;
+	}
+
+	TextureCache::TextureCache(shared_ptr<TextureDriver> driver){
+		this->driver = driver;
+
+		textureMemory = 0;
+		hits = 0;
+		misses = 0;
+		evictions = 0;
+	}
+
+	// Textures still held are left to the driver
+	TextureCache::~TextureCache(){}
+
+	void* TextureCache::acquire(std::string url, int flags, bool& pending){
+		pending = false;
+
+		if(url.empty()){
+			return NULL;
+		}
+
+		struct _ob_texture_key key;
+		key.url = url;
+		key.flags = flags;
+
+		std::map<struct _ob_texture_key, struct _ob_texture_entry>::iterator it = textures.find(key);
+		if(it != textures.end()){
+			hits++;
+			it->second.refs++;
+			return it->second.tex;
+		}
+
+		void* tex = driver->createTexture(url, flags, pending);
+		if(!tex){
+			return NULL;
+		}
+
+		misses++;
+
+		struct _ob_texture_entry entry;
+		entry.tex = tex;
+		entry.memory = driver->getTextureMemory(tex);
+		entry.refs = 1;
+
+		textures[key] = entry;
+		keys[tex] = key;
+		textureMemory += entry.memory;
+
+		return tex;
+	}
+
+	void TextureCache::release(void* tex){
+		if(!tex){
+			return;
+		}
+
+		std::map<void*, struct _ob_texture_key>::iterator ki = keys.find(tex);
+		if(ki == keys.end()){
+			return;
+		}
+
+		std::map<struct _ob_texture_key, struct _ob_texture_entry>::iterator it = textures.find(ki->second);
+		if(it == textures.end()){
+			keys.erase(ki);
+			return;
+		}
+
+		it->second.refs--;
+		if(it->second.refs > 0){
+			return;
+		}
+
+		textureMemory -= it->second.memory;
+		evictions++;
+
+		textures.erase(it);
+		keys.erase(ki);
+
+		driver->destroyTexture(tex);
+	}
+
+	size_t TextureCache::getTextureCount(){
+		return textures.size();
+	}
+
+	size_t TextureCache::getTextureMemory(){
+		return textureMemory;
+	}
+
+	ob_uint64 TextureCache::getHits(){
+		return hits;
+	}
+
+	ob_uint64 TextureCache::getMisses(){
+		return misses;
+	}
+
+	ob_uint64 TextureCache::getEvictions(){
+		return evictions;
+	}
+
+#if HAVE_IRRLICHT
+	IrrlichtTextureDriver::IrrlichtTextureDriver(OBEngine* eng, irr::video::IVideoDriver* irrDriv){
+		this->eng = eng;
+		this->irrDriv = irrDriv;
+	}
+
+	IrrlichtTextureDriver::~IrrlichtTextureDriver(){}
+
+	void* IrrlichtTextureDriver::createTexture(std::string url, int flags, bool& pending){
+		pending = false;
+
+		shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
+		if(!assetLoc || !irrDriv){
+			return NULL;
+		}
+
+		irr::video::IImage* irrImg = NULL;
+
+#if HAVE_SDL2
+		// Backs irrImg, so it has to outlive the upload
+		shared_ptr<struct _ob_decoded_image> img;
+
+		shared_ptr<ImageDecoder> imgDec = eng->getImageDecoder();
+		if(imgDec){
+			img = imgDec->take(url);
+			if(img){
+				irrImg = irrDriv->createImageFromData(irr::video::ECF_A8R8G8B8, irr::core::dimension2d<irr::u32>(img->width, img->height), img->pixels, true, false);
+			}else if(imgDec->isDecoding(url)){
+				pending = true;
+				return NULL;
+			}else if(!imgDec->hasFailed(url)){
+				shared_ptr<AssetResponse> resp = assetLoc->getAsset(url);
+				if(resp){
+					imgDec->request(url, resp);
+					pending = true;
+				}
+				return NULL;
+			}
+			// Otherwise SDL_image can't read it, see if Irrlicht can
+		}
+#endif
+
+		if(!irrImg){
+			shared_ptr<AssetResponse> resp = assetLoc->getAsset(url);
+			if(resp){
+				irr::io::IReadFile* irf = resp->toIReadFile();
+				if(irf){
+					irrImg = irrDriv->createImageFromFile(irf);
+					irf->drop();
+				}
+			}
+		}
+
+		if(!irrImg){
+			return NULL;
+		}
+
+		// The cache tells textures apart, the names only have to be unique
+		std::string texName = url + "#" + std::to_string(flags);
+
+		bool mipMaps = irrDriv->getTextureCreationFlag(irr::video::ETCF_CREATE_MIP_MAPS);
+		irrDriv->setTextureCreationFlag(irr::video::ETCF_CREATE_MIP_MAPS, (flags & OB_TEXTURE_MIPMAPS) != 0);
+
+		irr::video::ITexture* tex = irrDriv->addTexture(irr::io::path(texName.c_str()), irrImg);
+
+		irrDriv->setTextureCreationFlag(irr::video::ETCF_CREATE_MIP_MAPS, mipMaps);
+
+		irrImg->drop();
+
+		return tex;
+	}
+
+	void IrrlichtTextureDriver::destroyTexture(void* tex){
+		irrDriv->removeTexture((irr::video::ITexture*)tex);
+	}
+
+	size_t IrrlichtTextureDriver::getTextureMemory(void* tex){
+		irr::video::ITexture* irrTex = (irr::video::ITexture*)tex;
+
+		irr::core::dimension2d<irr::u32> siz = irrTex->getSize();
+		size_t mem = (size_t)siz.Width * siz.Height * (irr::video::IImage::getBitsPerPixelFromFormat(irrTex->getColorFormat()) / 8);
+
+		// A full mip chain adds a third
+		if(irrTex->hasMipMaps()){
+			mem += mem / 3;
+		}
+
+		return mem;
+	}
+#endif
+}
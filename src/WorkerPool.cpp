@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "WorkerPool.h"
+
+#include <thread>
+
+namespace OB{
+	struct _ob_worker_start{
+		WorkerPool* pool;
+		int idx;
+	};
+
+	void* _ob_worker_thread(void* vstart){
+		struct _ob_worker_start* start = (struct _ob_worker_start*)vstart;
+		WorkerPool* pool = start->pool;
+		int idx = start->idx;
+		delete start;
+
+		pool->workerLoop(idx);
+
+		pthread_exit(NULL);
+		return NULL;
+	}
+
+	WorkerPool::WorkerPool(int numThreads){
+		pthread_mutex_init(&mmutex, NULL);
+		pthread_cond_init(&workCond, NULL);
+		pthread_cond_init(&doneCond, NULL);
+
+		numActive = 0;
+		stopping = false;
+		batch = NULL;
+
+		setNumThreads(numThreads);
+	}
+
+	WorkerPool::~WorkerPool(){
+		pthread_mutex_lock(&mmutex);
+		stopping = true;
+		pthread_cond_broadcast(&workCond);
+		pthread_mutex_unlock(&mmutex);
+
+		for(std::vector<pthread_t>::size_type i = 0; i < threads.size(); i++){
+			void* _stat;
+			pthread_join(threads[i], &_stat);
+		}
+
+		pthread_cond_destroy(&doneCond);
+		pthread_cond_destroy(&workCond);
+		pthread_mutex_destroy(&mmutex);
+	}
+
+	int WorkerPool::getNumThreads(){
+		return numActive;
+	}
+
+	void WorkerPool::setNumThreads(int numThreads){
+		if(numThreads < 0){
+			numThreads = 0;
+		}
+
+		pthread_mutex_lock(&mmutex);
+
+		while((int)threads.size() < numThreads){
+			struct _ob_worker_start* start = new struct _ob_worker_start;
+			start->pool = this;
+			start->idx = threads.size();
+
+			pthread_t thread;
+			if(pthread_create(&thread, NULL, _ob_worker_thread, start) != 0){
+				delete start;
+				numThreads = threads.size();
+				break;
+			}
+			threads.push_back(thread);
+		}
+
+		numActive = numThreads;
+
+		pthread_cond_broadcast(&workCond);
+		pthread_mutex_unlock(&mmutex);
+
+		// Jobs queued while there were no workers
+		if(numThreads == 0){
+			pthread_mutex_lock(&mmutex);
+			std::deque<struct _ob_worker_job> pending;
+			pending.swap(jobs);
+			pthread_mutex_unlock(&mmutex);
+
+			for(std::deque<struct _ob_worker_job>::iterator it = pending.begin(); it != pending.end(); ++it){
+				it->fnc(it->ud);
+			}
+		}
+	}
+
+	void WorkerPool::enqueue(ob_worker_fnc fnc, void* ud){
+		pthread_mutex_lock(&mmutex);
+		if(numActive == 0){
+			pthread_mutex_unlock(&mmutex);
+
+			fnc(ud);
+			return;
+		}
+
+		struct _ob_worker_job job;
+		job.fnc = fnc;
+		job.ud = ud;
+		jobs.push_back(job);
+
+		pthread_cond_signal(&workCond);
+		pthread_mutex_unlock(&mmutex);
+	}
+
+	void WorkerPool::runChunks(struct _ob_worker_batch* b){
+		while(true){
+			int iBegin = b->next.fetch_add(b->grainSize);
+			if(iBegin >= b->iEnd){
+				return;
+			}
+
+			int iEnd = iBegin + b->grainSize;
+			if(iEnd > b->iEnd){
+				iEnd = b->iEnd;
+			}
+
+			b->fnc(b->ud, iBegin, iEnd);
+		}
+	}
+
+	void WorkerPool::parallelFor(int iBegin, int iEnd, int grainSize, ob_parallel_for_fnc fnc, void* ud){
+		if(iBegin >= iEnd){
+			return;
+		}
+		if(grainSize < 1){
+			grainSize = 1;
+		}
+
+		pthread_mutex_lock(&mmutex);
+		if(numActive == 0 || batch != NULL || iEnd - iBegin <= grainSize){
+			pthread_mutex_unlock(&mmutex);
+
+			fnc(ud, iBegin, iEnd);
+			return;
+		}
+
+		struct _ob_worker_batch b;
+		b.fnc = fnc;
+		b.ud = ud;
+		b.iEnd = iEnd;
+		b.grainSize = grainSize;
+		b.next = iBegin;
+		b.users = 0;
+
+		batch = &b;
+		pthread_cond_broadcast(&workCond);
+		pthread_mutex_unlock(&mmutex);
+
+		runChunks(&b);
+
+		// Every chunk has been taken, wait for the ones still running
+		pthread_mutex_lock(&mmutex);
+		batch = NULL;
+		while(b.users > 0){
+			pthread_cond_wait(&doneCond, &mmutex);
+		}
+		pthread_mutex_unlock(&mmutex);
+	}
+
+	int WorkerPool::getDefaultNumThreads(){
+		int hwThreads = std::thread::hardware_concurrency();
+		if(hwThreads <= 1){
+			return 0;
+		}
+		return hwThreads - 1;
+	}
+
+	void WorkerPool::workerLoop(int idx){
+		pthread_mutex_lock(&mmutex);
+
+		while(!stopping){
+			if(idx >= numActive){
+				pthread_cond_wait(&workCond, &mmutex);
+				continue;
+			}
+
+			if(batch && batch->next < batch->iEnd){
+				struct _ob_worker_batch* b = batch;
+				b->users++;
+				pthread_mutex_unlock(&mmutex);
+
+				runChunks(b);
+
+				pthread_mutex_lock(&mmutex);
+				b->users--;
+				if(b->users == 0){
+					pthread_cond_broadcast(&doneCond);
+				}
+				continue;
+			}
+
+			if(!jobs.empty()){
+				struct _ob_worker_job job = jobs.front();
+				jobs.pop_front();
+				pthread_mutex_unlock(&mmutex);
+
+				job.fnc(job.ud);
+
+				pthread_mutex_lock(&mmutex);
+				continue;
+			}
+
+			pthread_cond_wait(&workCond, &mmutex);
+		}
+
+		pthread_mutex_unlock(&mmutex);
+	}
+}
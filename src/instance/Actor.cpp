@@ -0,0 +1,733 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "instance/Actor.h"
+
+#include "OBEngine.h"
+#include "OBException.h"
+#include <algorithm>
+
+namespace OB{
+	namespace Instance{
+		DEFINE_CLASS(Actor, true, false, Instance){
+			registerLuaClass(eng, LuaClassName, register_lua_metamethods, register_lua_methods, register_lua_property_getters, register_lua_property_setters, register_lua_events);
+		}
+
+		// Actors with a running worker, only touched from the main thread
+		static std::vector<weak_ptr<Actor>> _ob_actors;
+
+		// Registry key for the Actor* of an actor Lua state
+		static char _ob_actor_key;
+
+		static void* _ob_actor_worker(void* vactor){
+			Actor* actor = (Actor*)vactor;
+			actor->workerLoop();
+
+			pthread_exit(NULL);
+			return NULL;
+		}
+
+		/*
+		 * Values crossing into an Actor are limited to what an
+		 * isolated state can represent without engine types.
+		 */
+		static void _ob_actor_push_var(lua_State* L, shared_ptr<Type::VarWrapper> var){
+			if(!var){
+				lua_pushnil(L);
+				return;
+			}
+
+			switch(var->type){
+				case Type::TYPE_INT:
+				case Type::TYPE_DOUBLE:
+				case Type::TYPE_FLOAT:
+				case Type::TYPE_LONG:
+				case Type::TYPE_UNSIGNED_LONG:
+				case Type::TYPE_BOOL:
+				case Type::TYPE_STRING: {
+					var->wrap_lua(L);
+					break;
+				}
+				default: {
+					lua_pushnil(L);
+					break;
+				}
+			}
+		}
+
+		static bool _ob_actor_is_primitive(shared_ptr<Type::VarWrapper> var){
+			switch(var->type){
+				case Type::TYPE_INT:
+				case Type::TYPE_DOUBLE:
+				case Type::TYPE_FLOAT:
+				case Type::TYPE_LONG:
+				case Type::TYPE_UNSIGNED_LONG:
+				case Type::TYPE_BOOL:
+				case Type::TYPE_STRING: {
+					return true;
+				}
+				default: {
+					return false;
+				}
+			}
+		}
+
+		// Errors on anything but primitives, before any C++ objects are made
+		static void _ob_actor_check_value(lua_State* L, int idx){
+			switch(lua_type(L, idx)){
+				case LUA_TNONE:
+				case LUA_TNIL:
+				case LUA_TNUMBER:
+				case LUA_TBOOLEAN:
+				case LUA_TSTRING: {
+					return;
+				}
+			}
+
+			luaL_argerror(L, idx, "only nil, boolean, number and string values can leave an actor");
+		}
+
+		static shared_ptr<Type::VarWrapper> _ob_actor_to_var(lua_State* L, int idx){
+			switch(lua_type(L, idx)){
+				case LUA_TNONE:
+				case LUA_TNIL: {
+					return make_shared<Type::VarWrapper>((void*)NULL, Type::TYPE_NULL);
+				}
+				case LUA_TNUMBER: {
+					return make_shared<Type::VarWrapper>(lua_tonumber(L, idx));
+				}
+				case LUA_TBOOLEAN: {
+					return make_shared<Type::VarWrapper>((bool)lua_toboolean(L, idx));
+				}
+				case LUA_TSTRING: {
+					return make_shared<Type::VarWrapper>(std::string(lua_tostring(L, idx)));
+				}
+			}
+
+			return make_shared<Type::VarWrapper>((void*)NULL, Type::TYPE_NULL);
+		}
+
+		static shared_ptr<BitStream> _ob_actor_pack(lua_State* L, int first){
+			int top = lua_gettop(L);
+			int count = top >= first ? top - first + 1 : 0;
+
+			for(int i = first; i <= top; i++){
+				_ob_actor_check_value(L, i);
+			}
+
+			shared_ptr<BitStream> bs = make_shared<BitStream>();
+
+			bs->writeInt(count);
+			for(int i = first; i <= top; i++){
+				bs->writeVar(_ob_actor_to_var(L, i));
+			}
+
+			return bs;
+		}
+
+		static Actor* _ob_actor_get(lua_State* L){
+			lua_rawgetp(L, LUA_REGISTRYINDEX, &_ob_actor_key);
+			Actor* actor = (Actor*)lua_touserdata(L, -1);
+			lua_pop(L, 1);
+
+			return actor;
+		}
+
+		// Raises an error in any script still running once the Actor is asked to stop
+		static void _ob_actor_stop_hook(lua_State* L, lua_Debug* ar){
+			(void)ar;
+
+			if(_ob_actor_get(L)->isStopRequested()){
+				// Every instruction from here on fails, so pcall can't keep the script going
+				lua_sethook(L, _ob_actor_stop_hook, LUA_MASKCOUNT, 1);
+				luaL_error(L, "Actor stopped");
+			}
+		}
+
+		static std::string _ob_actor_concat(lua_State* L){
+			std::string output = "";
+
+			int n = lua_gettop(L);
+
+			lua_getglobal(L, "tostring");
+			for(int i = 1; i <= n; i++){
+				lua_pushvalue(L, -1);
+				lua_pushvalue(L, i);
+				lua_call(L, 1, 1);
+
+				const char* s = lua_tostring(L, -1);
+				if(s == NULL){
+					luaL_error(L, LUA_QL("tostring") " must return a string");
+				}
+
+				if(i > 1){
+					output = output + "\t";
+				}
+				output = output + std::string(s);
+
+				lua_pop(L, 1);
+			}
+			lua_pop(L, 1);
+
+			return output;
+		}
+
+		static int _ob_actor_lua_print(lua_State* L){
+			_ob_actor_get(L)->postLog(_ob_actor_concat(L), OLL_None);
+			return 0;
+		}
+
+		static int _ob_actor_lua_warn(lua_State* L){
+			_ob_actor_get(L)->postLog(_ob_actor_concat(L), OLL_Warning);
+			return 0;
+		}
+
+		static int _ob_actor_lua_send(lua_State* L){
+			std::string topic = std::string(luaL_checkstring(L, 1));
+
+			_ob_actor_get(L)->postMessage(topic, _ob_actor_pack(L, 2));
+			return 0;
+		}
+
+		static int _ob_actor_lua_receive(lua_State* L){
+			luaL_checkstring(L, 1);
+			luaL_checktype(L, 2, LUA_TFUNCTION);
+
+			// Handlers live in registry["actor_handlers"][topic]
+			lua_getfield(L, LUA_REGISTRYINDEX, "actor_handlers");
+			lua_pushvalue(L, 1);
+			if(lua_rawget(L, -2) != LUA_TTABLE){
+				lua_pop(L, 1);
+				lua_newtable(L);
+				lua_pushvalue(L, 1);
+				lua_pushvalue(L, -2);
+				lua_rawset(L, -4);
+			}
+
+			lua_pushvalue(L, 2);
+			lua_rawseti(L, -2, lua_rawlen(L, -2) + 1);
+
+			lua_pop(L, 2);
+			return 0;
+		}
+
+		static int _ob_actor_lua_get(lua_State* L){
+			std::string path = std::string(luaL_checkstring(L, 1));
+			std::string prop = std::string(luaL_checkstring(L, 2));
+
+			_ob_actor_push_var(L, _ob_actor_get(L)->readSnapshot(path, prop));
+			return 1;
+		}
+
+		static int _ob_actor_lua_set(lua_State* L){
+			std::string path = std::string(luaL_checkstring(L, 1));
+			std::string prop = std::string(luaL_checkstring(L, 2));
+			_ob_actor_check_value(L, 3);
+
+			shared_ptr<BitStream> bs = make_shared<BitStream>();
+			bs->writeVar(_ob_actor_to_var(L, 3));
+
+			_ob_actor_get(L)->postWrite(path, prop, bs);
+			return 0;
+		}
+
+		Actor::Actor(OBEngine* eng) : Instance(eng){
+			Name = ClassName;
+
+			MessageReceived = make_shared<Type::Event>("MessageReceived");
+
+			workerRunning = false;
+			stopRequested = false;
+
+			ancestryAware = true;
+
+			aL = NULL;
+			snapshotGen = 0;
+
+			pthread_mutex_init(&mmutex, NULL);
+			pthread_cond_init(&workCond, NULL);
+			pthread_cond_init(&snapCond, NULL);
+		}
+
+		Actor::~Actor(){
+			stopWorker();
+
+			pthread_cond_destroy(&snapCond);
+			pthread_cond_destroy(&workCond);
+			pthread_mutex_destroy(&mmutex);
+		}
+
+		shared_ptr<Instance> Actor::cloneImpl(){
+			shared_ptr<Actor> act = make_shared<Actor>(eng);
+			act->Archivable = Archivable;
+			act->Name = Name;
+			act->ParentLocked = ParentLocked;
+
+			return act;
+		}
+
+		void Actor::initState(){
+			allocator = make_shared<Lua::LuaAllocator>();
+			aL = lua_newstate(Lua::LuaAllocator::l_alloc, allocator.get());
+
+			lua_sethook(aL, _ob_actor_stop_hook, LUA_MASKCOUNT, OB_ACTOR_HOOK_COUNT);
+
+			luaL_requiref(aL, "_G", luaopen_base, 1);
+			luaL_requiref(aL, LUA_COLIBNAME, luaopen_coroutine, 1);
+			luaL_requiref(aL, LUA_TABLIBNAME, luaopen_table, 1);
+			luaL_requiref(aL, LUA_STRLIBNAME, luaopen_string, 1);
+			luaL_requiref(aL, LUA_MATHLIBNAME, luaopen_math, 1);
+			luaL_requiref(aL, LUA_UTF8LIBNAME, luaopen_utf8, 1);
+			lua_pop(aL, 6);
+
+			lua_pushlightuserdata(aL, this);
+			lua_rawsetp(aL, LUA_REGISTRYINDEX, &_ob_actor_key);
+
+			lua_newtable(aL);
+			lua_setfield(aL, LUA_REGISTRYINDEX, "actor_handlers");
+
+			// No filesystem access from actors
+			lua_pushnil(aL);
+			lua_setglobal(aL, "dofile");
+			lua_pushnil(aL);
+			lua_setglobal(aL, "loadfile");
+
+			luaL_Reg mainlib[] = {
+				{"print", _ob_actor_lua_print},
+				{"warn", _ob_actor_lua_warn},
+				{NULL, NULL}
+			};
+			lua_pushglobaltable(aL);
+			luaL_setfuncs(aL, mainlib, 0);
+			lua_pop(aL, 1);
+
+			lua_newtable(aL);
+			luaL_Reg actorlib[] = {
+				{"send", _ob_actor_lua_send},
+				{"receive", _ob_actor_lua_receive},
+				{"get", _ob_actor_lua_get},
+				{"set", _ob_actor_lua_set},
+				{NULL, NULL}
+			};
+			luaL_setfuncs(aL, actorlib, 0);
+			lua_setglobal(aL, "actor");
+		}
+
+		void Actor::startWorker(){
+			if(workerRunning){
+				return;
+			}
+
+			initState();
+
+			stopRequested = false;
+			workerRunning = true;
+
+			if(pthread_create(&workerThread, NULL, _ob_actor_worker, this) != 0){
+				workerRunning = false;
+
+				lua_close(aL);
+				aL = NULL;
+
+				eng->getLogger()->log("Failed to start the worker thread of " + GetFullName(), OLL_Error);
+				return;
+			}
+
+			_ob_actors.push_back(dynamic_pointer_cast<Actor>(shared_from_this()));
+		}
+
+		void Actor::stopWorker(){
+			if(!workerRunning){
+				return;
+			}
+
+			pthread_mutex_lock(&mmutex);
+			stopRequested = true;
+			pthread_cond_broadcast(&workCond);
+			pthread_cond_broadcast(&snapCond);
+			pthread_mutex_unlock(&mmutex);
+
+			// The stop hook breaks out of whatever script is running
+			void* _stat;
+			pthread_join(workerThread, &_stat);
+
+			workerRunning = false;
+
+			lua_close(aL);
+			aL = NULL;
+		}
+
+		void Actor::ancestryUpdated(){
+			shared_ptr<DataModel> dm = eng->getDataModel();
+			if(!dm || !IsDescendantOf(dm)){
+				stopWorker();
+			}
+		}
+
+		bool Actor::isStopRequested(){
+			return stopRequested;
+		}
+
+		void Actor::runSource(std::string chunkName, std::string source){
+			struct _ob_actor_job job;
+			job.isScript = true;
+			job.name = chunkName;
+			job.source = source;
+
+			pthread_mutex_lock(&mmutex);
+			inbox.push_back(job);
+			pthread_cond_signal(&workCond);
+			pthread_mutex_unlock(&mmutex);
+
+			startWorker();
+		}
+
+		void Actor::SendMessage(std::string topic, std::vector<shared_ptr<Type::VarWrapper>> args){
+			shared_ptr<BitStream> bs = make_shared<BitStream>();
+
+			bs->writeInt(args.size());
+			for(std::vector<shared_ptr<Type::VarWrapper>>::size_type i = 0; i != args.size(); i++){
+				shared_ptr<Type::VarWrapper> arg = args[i];
+				if(arg && _ob_actor_is_primitive(arg)){
+					bs->writeVar(arg);
+				}else{
+					bs->writeVar(make_shared<Type::VarWrapper>((void*)NULL, Type::TYPE_NULL));
+				}
+			}
+
+			struct _ob_actor_job job;
+			job.isScript = false;
+			job.name = topic;
+			job.args = bs;
+
+			pthread_mutex_lock(&mmutex);
+			inbox.push_back(job);
+			pthread_cond_signal(&workCond);
+			pthread_mutex_unlock(&mmutex);
+		}
+
+		void Actor::workerLoop(){
+			pthread_mutex_lock(&mmutex);
+			while(!stopRequested){
+				if(inbox.empty()){
+					pthread_cond_wait(&workCond, &mmutex);
+					continue;
+				}
+
+				struct _ob_actor_job job = inbox.front();
+				inbox.pop_front();
+
+				pthread_mutex_unlock(&mmutex);
+				runJob(job);
+				pthread_mutex_lock(&mmutex);
+			}
+			pthread_mutex_unlock(&mmutex);
+		}
+
+		void Actor::runJob(struct _ob_actor_job job){
+			lua_State* L = aL;
+
+			if(job.isScript){
+				int s = luaL_loadbuffer(L, job.source.c_str(), job.source.size(), job.name.c_str());
+				if(s == LUA_OK){
+					s = lua_pcall(L, 0, 0, 0);
+				}
+				if(s != LUA_OK){
+					postLog(std::string(lua_tostring(L, -1)), OLL_Error);
+					lua_pop(L, 1);
+				}
+				return;
+			}
+
+			// Decode once, then call every handler for this topic
+			std::vector<shared_ptr<Type::VarWrapper>> args;
+			int count = job.args->readInt();
+			for(int i = 0; i < count; i++){
+				args.push_back(job.args->readVar(eng));
+			}
+
+			lua_getfield(L, LUA_REGISTRYINDEX, "actor_handlers");
+			lua_pushstring(L, job.name.c_str());
+			if(lua_rawget(L, -2) == LUA_TTABLE){
+				lua_Integer n = lua_rawlen(L, -1);
+				for(lua_Integer i = 1; i <= n; i++){
+					lua_rawgeti(L, -1, i);
+					for(std::vector<shared_ptr<Type::VarWrapper>>::size_type j = 0; j != args.size(); j++){
+						_ob_actor_push_var(L, args[j]);
+					}
+					if(lua_pcall(L, args.size(), 0, 0) != LUA_OK){
+						postLog(std::string(lua_tostring(L, -1)), OLL_Error);
+						lua_pop(L, 1);
+					}
+				}
+			}
+			lua_pop(L, 2);
+		}
+
+		void Actor::postMessage(std::string topic, shared_ptr<BitStream> args){
+			struct _ob_actor_out out;
+			out.isLog = false;
+			out.logLevel = OLL_None;
+			out.topic = topic;
+			out.args = args;
+
+			pthread_mutex_lock(&mmutex);
+			outbox.push_back(out);
+			pthread_mutex_unlock(&mmutex);
+		}
+
+		void Actor::postLog(std::string message, OBLogLevel logLevel){
+			struct _ob_actor_out out;
+			out.isLog = true;
+			out.logLevel = logLevel;
+			out.topic = message;
+
+			pthread_mutex_lock(&mmutex);
+			outbox.push_back(out);
+			pthread_mutex_unlock(&mmutex);
+		}
+
+		void Actor::postWrite(std::string path, std::string prop, shared_ptr<BitStream> val){
+			struct _ob_actor_write wr;
+			wr.path = path;
+			wr.prop = prop;
+			wr.val = val;
+
+			pthread_mutex_lock(&mmutex);
+			writes.push_back(wr);
+			pthread_mutex_unlock(&mmutex);
+		}
+
+		shared_ptr<Type::VarWrapper> Actor::readSnapshot(std::string path, std::string prop){
+			std::string key = path + "\n" + prop;
+
+			shared_ptr<Type::VarWrapper> val;
+
+			pthread_mutex_lock(&mmutex);
+			std::map<std::string, shared_ptr<Type::VarWrapper>>::iterator it = snapshot.find(key);
+			if(it != snapshot.end()){
+				val = it->second;
+			}else{
+				// Not watched yet, wait for the next sync to fill it in
+				watched.insert(key);
+
+				ob_uint64 gen = snapshotGen;
+				while(!stopRequested && snapshotGen == gen){
+					pthread_cond_wait(&snapCond, &mmutex);
+				}
+
+				it = snapshot.find(key);
+				if(it != snapshot.end()){
+					val = it->second;
+				}
+			}
+			pthread_mutex_unlock(&mmutex);
+
+			return val;
+		}
+
+		shared_ptr<Instance> Actor::resolvePath(std::string path){
+			shared_ptr<Instance> cur = shared_from_this();
+
+			if(path.empty()){
+				return cur;
+			}
+
+			std::vector<std::string> parts;
+			size_t start = 0;
+			size_t dot;
+			while((dot = path.find('.', start)) != std::string::npos){
+				parts.push_back(path.substr(start, dot - start));
+				start = dot + 1;
+			}
+			parts.push_back(path.substr(start));
+
+			std::vector<std::string>::size_type i = 0;
+
+			if(parts.size() > 0 && (parts[0] == "game" || parts[0] == "Game")){
+				cur = eng->getDataModel();
+				i = 1;
+			}
+
+			for(; i < parts.size() && cur; i++){
+				cur = cur->FindFirstChild(parts[i], false);
+			}
+
+			return cur;
+		}
+
+		void Actor::sync(){
+			std::vector<struct _ob_actor_out> toDeliver;
+			std::vector<struct _ob_actor_write> toApply;
+			std::set<std::string> keys;
+
+			pthread_mutex_lock(&mmutex);
+			toDeliver.swap(outbox);
+			toApply.swap(writes);
+			keys = watched;
+			pthread_mutex_unlock(&mmutex);
+
+			for(std::vector<struct _ob_actor_write>::size_type i = 0; i != toApply.size(); i++){
+				struct _ob_actor_write wr = toApply[i];
+
+				shared_ptr<Instance> inst = resolvePath(wr.path);
+				if(!inst){
+					eng->getLogger()->log("Actor write to missing instance", wr.path, OLL_Warning);
+					continue;
+				}
+
+				try{
+					inst->setProperty(wr.prop, wr.val->readVar(eng));
+				}catch(OBException* ex){
+					eng->getLogger()->log(ex->getMessage(), OLL_Error);
+					delete ex;
+				}
+			}
+
+			for(std::vector<struct _ob_actor_out>::size_type i = 0; i != toDeliver.size(); i++){
+				struct _ob_actor_out out = toDeliver[i];
+
+				if(out.isLog){
+					eng->getLogger()->log(out.topic, out.logLevel);
+					continue;
+				}
+
+				std::vector<shared_ptr<Type::VarWrapper>> args;
+				args.push_back(make_shared<Type::VarWrapper>(out.topic));
+
+				int count = out.args->readInt();
+				for(int j = 0; j < count; j++){
+					args.push_back(out.args->readVar(eng));
+				}
+
+				MessageReceived->Fire(eng, args);
+			}
+
+			if(keys.empty()){
+				return;
+			}
+
+			// Read everything before taking the lock, the worker only ever sees a whole snapshot
+			std::map<std::string, shared_ptr<Type::VarWrapper>> nSnapshot;
+			for(std::set<std::string>::iterator it = keys.begin(); it != keys.end(); ++it){
+				std::string key = *it;
+				size_t sep = key.find('\n');
+
+				shared_ptr<Type::VarWrapper> val = make_shared<Type::VarWrapper>((void*)NULL, Type::TYPE_NULL);
+
+				shared_ptr<Instance> inst = resolvePath(key.substr(0, sep));
+				if(inst){
+					try{
+						shared_ptr<Type::VarWrapper> pval = inst->getProperty(key.substr(sep + 1));
+						if(pval && _ob_actor_is_primitive(pval)){
+							val = pval;
+						}
+					}catch(OBException* ex){
+						delete ex;
+					}
+				}
+
+				nSnapshot[key] = val;
+			}
+
+			pthread_mutex_lock(&mmutex);
+			snapshot.swap(nSnapshot);
+			snapshotGen++;
+			pthread_cond_broadcast(&snapCond);
+			pthread_mutex_unlock(&mmutex);
+		}
+
+		void Actor::syncAll(OBEngine* eng){
+			if(_ob_actors.empty()){
+				return;
+			}
+
+			// sync can fire events, which may start more actors
+			std::vector<weak_ptr<Actor>> actors = _ob_actors;
+
+			for(std::vector<weak_ptr<Actor>>::size_type i = 0; i != actors.size(); i++){
+				shared_ptr<Actor> act = actors[i].lock();
+				if(act && act->eng == eng){
+					act->sync();
+				}
+			}
+
+			_ob_actors.erase(std::remove_if(_ob_actors.begin(), _ob_actors.end(), [](weak_ptr<Actor> wa){
+						return wa.expired();
+					}), _ob_actors.end());
+		}
+
+		int Actor::lua_SendMessage(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<Actor> act = dynamic_pointer_cast<Actor>(inst)){
+				std::string topic = std::string(luaL_checkstring(L, 2));
+
+				std::vector<shared_ptr<Type::VarWrapper>> args;
+
+				int nargs = lua_gettop(L);
+				for(int i = 3; i <= nargs; i++){
+					switch(lua_type(L, i)){
+						case LUA_TNUMBER: {
+							args.push_back(make_shared<Type::VarWrapper>(lua_tonumber(L, i)));
+							break;
+						}
+						case LUA_TBOOLEAN: {
+							args.push_back(make_shared<Type::VarWrapper>((bool)lua_toboolean(L, i)));
+							break;
+						}
+						case LUA_TSTRING: {
+							args.push_back(make_shared<Type::VarWrapper>(std::string(lua_tostring(L, i))));
+							break;
+						}
+						default: {
+							args.push_back(make_shared<Type::VarWrapper>((void*)NULL, Type::TYPE_NULL));
+							break;
+						}
+					}
+				}
+
+				act->SendMessage(topic, args);
+				return 0;
+			}
+
+			return luaL_error(L, COLONERR, "SendMessage");
+		}
+
+		void Actor::register_lua_methods(lua_State* L){
+			Instance::register_lua_methods(L);
+
+			luaL_Reg methods[] = {
+				{"SendMessage", lua_SendMessage},
+				{NULL, NULL}
+			};
+			luaL_setfuncs(L, methods, 0);
+		}
+
+		void Actor::register_lua_events(lua_State* L){
+			Instance::register_lua_events(L);
+
+			luaL_Reg events[] = {
+				{"MessageReceived", WRAP_EVT(Actor, MessageReceived)},
+				{NULL, NULL}
+			};
+			luaL_setfuncs(L, events, 0);
+		}
+	}
+}
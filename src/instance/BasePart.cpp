@@ -21,6 +21,7 @@
 
 #include "instance/NetworkReplicator.h"
 #include "instance/NetworkServer.h"
+#include "instance/Workspace.h"
 
 namespace OB{
 	namespace Instance{
@@ -32,20 +33,34 @@ namespace OB{
 			Name = ClassName;
 
 			Anchored = true;
-			Color = make_shared<Type::Color3>(163/255, 162/255, 165/255);
+			Color = make_pooled<Type::Color3>(163/255, 162/255, 165/255);
 			CanCollide = false;
 			Locked = false;
 			Transparency = 0;
-			Position = make_shared<Type::Vector3>(0, 0, 0);
-			Rotation = make_shared<Type::Vector3>(0, 0, 0);
+			Position = make_pooled<Type::Vector3>(0, 0, 0);
+			Rotation = make_pooled<Type::Vector3>(0, 0, 0);
+
+#if HAVE_BULLET
+			physWorld = NULL;
+			rigidBody = NULL;
+
+			ancestryAware = true;
+#endif
 		}
 
-		BasePart::~BasePart(){}
+		BasePart::~BasePart(){
+#if HAVE_BULLET
+			leavePhysicsWorld();
+#endif
+		}
 
 		void BasePart::setAnchored(bool anchored){
 			if(anchored != Anchored){
 				Anchored = anchored;
 
+#if HAVE_BULLET
+				updatePhysicsFlags();
+#endif
 				REPLICATE_PROPERTY_CHANGE(Anchored);
 				propertyChanged("Anchored");
 			}
@@ -57,7 +72,7 @@ namespace OB{
 
 		void BasePart::setColor(shared_ptr<Type::Color3> color){
 			if(!color){
-				shared_ptr<Type::Color3> col3 = make_shared<Type::Color3>();
+				shared_ptr<Type::Color3> col3 = make_pooled<Type::Color3>();
 				if(!col3->equals(Color)){
 					Color = col3;
 
@@ -84,6 +99,9 @@ namespace OB{
 			if(cancollide != CanCollide){
 				CanCollide = cancollide;
 
+#if HAVE_BULLET
+				updatePhysicsFlags();
+#endif
 				REPLICATE_PROPERTY_CHANGE(CanCollide);
 				propertyChanged("CanCollide");
 			}
@@ -121,11 +139,14 @@ namespace OB{
 
 		void BasePart::setPosition(shared_ptr<Type::Vector3> position){
 			if(position == NULL){
-				shared_ptr<Type::Vector3> vec3 = make_shared<Type::Vector3>(0, 0, 0);
+				shared_ptr<Type::Vector3> vec3 = make_pooled<Type::Vector3>(0, 0, 0);
 				if(!vec3->equals(Position)){
 					Position = vec3;
 
 					updatePosition();
+#if HAVE_BULLET
+					updatePhysicsTransform();
+#endif
 					REPLICATE_PROPERTY_CHANGE(Position);
 					propertyChanged("Position");
 				}
@@ -134,6 +155,9 @@ namespace OB{
 					Position = position;
 
 					updatePosition();
+#if HAVE_BULLET
+					updatePhysicsTransform();
+#endif
 					REPLICATE_PROPERTY_CHANGE(Position);
 					propertyChanged("Position");
 				}
@@ -146,11 +170,14 @@ namespace OB{
 
 		void BasePart::setRotation(shared_ptr<Type::Vector3> rotation){
 			if(rotation == NULL){
-				shared_ptr<Type::Vector3> vec3 = make_shared<Type::Vector3>(0, 0, 0);
+				shared_ptr<Type::Vector3> vec3 = make_pooled<Type::Vector3>(0, 0, 0);
 				if(!vec3->equals(Rotation)){
 					Rotation = vec3;
 
 					updateRotation();
+#if HAVE_BULLET
+					updatePhysicsTransform();
+#endif
 					REPLICATE_PROPERTY_CHANGE(Rotation);
 					propertyChanged("Rotation");
 				}
@@ -159,6 +186,9 @@ namespace OB{
 					Rotation = rotation;
 
 					updateRotation();
+#if HAVE_BULLET
+					updatePhysicsTransform();
+#endif
 					REPLICATE_PROPERTY_CHANGE(Rotation);
 					propertyChanged("Rotation");
 				}
@@ -187,6 +217,198 @@ namespace OB{
 #endif
 		}
 
+		void BasePart::ancestryUpdated(){
+#if HAVE_BULLET
+			btDiscreteDynamicsWorld* world = NULL;
+
+			shared_ptr<Instance> anc = Parent;
+			while(anc){
+				if(shared_ptr<Workspace> ws = dynamic_pointer_cast<Workspace>(anc)){
+					world = ws->getDynamicsWorld();
+					break;
+				}
+				anc = anc->getParent();
+			}
+
+			if(world != physWorld){
+				leavePhysicsWorld();
+
+				if(world){
+					enterPhysicsWorld(world);
+				}
+			}
+#endif
+		}
+
+#if HAVE_BULLET
+		shared_ptr<btCollisionShape> BasePart::getCollisionShape(){
+			return NULL;
+		}
+
+		double BasePart::getMass(){
+			return 1;
+		}
+
+		btRigidBody* BasePart::getRigidBody(){
+			return rigidBody;
+		}
+
+		btTransform BasePart::getBulletTransform(){
+			btQuaternion rot;
+			// Same rotation order Irrlicht uses: X, then Y, then Z
+			rot.setEulerZYX(Rotation->getZ() * SIMD_RADS_PER_DEG, Rotation->getY() * SIMD_RADS_PER_DEG, Rotation->getX() * SIMD_RADS_PER_DEG);
+
+			return btTransform(rot, Position->toBulletVector3());
+		}
+
+		void BasePart::enterPhysicsWorld(btDiscreteDynamicsWorld* world){
+			collisionShape = getCollisionShape();
+			if(!collisionShape){
+				return;
+			}
+
+			physWorld = world;
+
+			btRigidBody::btRigidBodyConstructionInfo info(0, NULL, collisionShape.get());
+			info.m_startWorldTransform = getBulletTransform();
+
+			rigidBody = new btRigidBody(info);
+			rigidBody->setUserPointer(this);
+
+			updatePhysicsFlags();
+		}
+
+		void BasePart::leavePhysicsWorld(){
+			if(rigidBody){
+				if(physWorld){
+					physWorld->removeRigidBody(rigidBody);
+				}
+				delete rigidBody;
+				rigidBody = NULL;
+			}
+
+			collisionShape = NULL;
+			physWorld = NULL;
+		}
+
+		void BasePart::updatePhysicsFlags(){
+			if(!rigidBody){
+				return;
+			}
+
+			// Filters can only be changed by adding the body again
+			if(rigidBody->isInWorld()){
+				physWorld->removeRigidBody(rigidBody);
+			}
+
+			btScalar mass = 0;
+			btVector3 inertia(0, 0, 0);
+
+			int flags = rigidBody->getCollisionFlags();
+			if(Anchored){
+				/* Kinematic rather than static, so an anchored part
+				   that gets moved wakes what rests on it. It's only
+				   awake while it moves, an awake kinematic body keeps
+				   everything touching it from sleeping. */
+				flags &= ~btCollisionObject::CF_STATIC_OBJECT;
+				flags |= btCollisionObject::CF_KINEMATIC_OBJECT;
+
+				rigidBody->setLinearVelocity(btVector3(0, 0, 0));
+				rigidBody->setAngularVelocity(btVector3(0, 0, 0));
+			}else{
+				flags &= ~(btCollisionObject::CF_STATIC_OBJECT | btCollisionObject::CF_KINEMATIC_OBJECT);
+
+				mass = getMass();
+				collisionShape->calculateLocalInertia(mass, inertia);
+			}
+			rigidBody->setCollisionFlags(flags);
+			rigidBody->setMassProps(mass, inertia);
+			rigidBody->updateInertiaTensor();
+			rigidBody->activate(true);
+
+			if(CanCollide){
+				physWorld->addRigidBody(rigidBody, OB_PHYS_GROUP_COLLIDE, OB_PHYS_GROUP_COLLIDE | OB_PHYS_GROUP_QUERY);
+			}else{
+				physWorld->addRigidBody(rigidBody, OB_PHYS_GROUP_NOCOLLIDE, OB_PHYS_GROUP_QUERY);
+			}
+
+			if(!Anchored){
+				rigidBody->activate(true);
+			}
+		}
+
+		void BasePart::updatePhysicsShape(){
+			if(!rigidBody){
+				return;
+			}
+
+			shared_ptr<btCollisionShape> shape = getCollisionShape();
+			if(!shape){
+				leavePhysicsWorld();
+				return;
+			}
+
+			physWorld->removeRigidBody(rigidBody);
+
+			collisionShape = shape;
+			rigidBody->setCollisionShape(collisionShape.get());
+
+			updatePhysicsFlags();
+		}
+
+		void BasePart::updatePhysicsTransform(){
+			if(!rigidBody){
+				return;
+			}
+
+			rigidBody->setWorldTransform(getBulletTransform());
+			rigidBody->setInterpolationWorldTransform(rigidBody->getWorldTransform());
+
+			// Keep spatial queries right before the next step
+			physWorld->updateSingleAabb(rigidBody);
+
+			// An anchored part wakes what it was moved into or away from
+			rigidBody->activate(true);
+		}
+
+		void BasePart::physicsMoved(){
+			if(!rigidBody){
+				return;
+			}
+
+			const btTransform& trans = rigidBody->getWorldTransform();
+			const btVector3& origin = trans.getOrigin();
+
+			btScalar yaw, pitch, roll;
+			trans.getBasis().getEulerZYX(yaw, pitch, roll);
+
+			// Read everything first, a Changed handler may destroy us
+			shared_ptr<Type::Vector3> pos = make_pooled<Type::Vector3>(origin.x(), origin.y(), origin.z());
+			shared_ptr<Type::Vector3> rot = make_pooled<Type::Vector3>(roll * SIMD_DEGS_PER_RAD, pitch * SIMD_DEGS_PER_RAD, yaw * SIMD_DEGS_PER_RAD);
+
+			bool posChanged = !pos->equals(Position);
+			bool rotChanged = !rot->equals(Rotation);
+
+			if(posChanged){
+				Position = pos;
+				updatePosition();
+			}
+			if(rotChanged){
+				Rotation = rot;
+				updateRotation();
+			}
+
+			if(posChanged){
+				REPLICATE_PROPERTY_CHANGE(Position);
+				propertyChanged("Position");
+			}
+			if(rotChanged){
+				REPLICATE_PROPERTY_CHANGE(Rotation);
+				propertyChanged("Rotation");
+			}
+		}
+#endif
+
 #if HAVE_ENET
 		void BasePart::replicateProperties(shared_ptr<NetworkReplicator> peer){
 			Instance::replicateProperties(peer);
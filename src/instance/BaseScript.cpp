@@ -23,6 +23,7 @@
 #include "instance/NetworkServer.h"
 
 #include "instance/RunService.h"
+#include "instance/Actor.h"
 
 namespace OB{
 	namespace Instance{
@@ -54,6 +55,12 @@ namespace OB{
 				std::string strSource = getSource();
 
 				if(strSource.size() > 0){
+					// Scripts under an Actor run on the Actor's own state
+					if(shared_ptr<Actor> act = dynamic_pointer_cast<Actor>(FindFirstAncestorOfClass("Actor"))){
+						act->runSource("@" + GetFullName(), strSource);
+						return;
+					}
+
 					lua_State* gL = getEngine()->getGlobalLuaState();
 					if(!gL){
 						return;
@@ -38,7 +38,7 @@ namespace OB{
 
 			fov = 70.0f;
 
-			CFrame = make_shared<Type::CFrame>(make_shared<Type::Vector3>(0, 30, -40), make_shared<Type::Vector3>(0, 5, 0));
+			CFrame = make_shared<Type::CFrame>(make_pooled<Type::Vector3>(0, 30, -40), make_pooled<Type::Vector3>(0, 5, 0));
 #if HAVE_IRRLICHT
 			irr::IrrlichtDevice* irrDev = eng->getIrrlichtDevice();
 			if (irrDev){
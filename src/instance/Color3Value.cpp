@@ -31,7 +31,7 @@ namespace OB{
 		Color3Value::Color3Value(OBEngine* eng) : BaseValue(eng){
 			Name = ClassName;
 
-			Value = make_shared<Type::Color3>(0, 0, 0);
+			Value = make_pooled<Type::Color3>(0, 0, 0);
 		}
 
 		Color3Value::~Color3Value(){}
@@ -42,7 +42,7 @@ namespace OB{
 
 		void Color3Value::setValue(shared_ptr<Type::Color3> value){
 			if(!value){
-				value = make_shared<Type::Color3>();
+				value = make_pooled<Type::Color3>();
 			}
 			if(!Value->equals(value)){
 				Value = value;
@@ -49,10 +49,10 @@ namespace OB{
 			return AssetLoadFailed;
 		}
 
-		void ContentProvider::Preload(std::string url){
+		void ContentProvider::Preload(std::string url, Enum::AssetPriority priority){
 			shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 
-			assetLoc->loadAsset(url);
+			assetLoc->loadAsset(url, priority);
 		}
 
 		void ContentProvider::Load(std::string url){
@@ -61,15 +61,17 @@ namespace OB{
 			assetLoc->loadAssetSync(url);
 		}
 
-		char* ContentProvider::GetAsset(std::string url){
+		shared_ptr<AssetResponse> ContentProvider::GetAsset(std::string url){
 			shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 
+			// The returned response pins the data against eviction
+			// for as long as the caller holds it
 			shared_ptr<AssetResponse> resp = assetLoc->getAsset(url);
 			if(resp){
 				char* dat = resp->getData();
 				int siz = resp->getSize();
 				if(dat && siz > 0){
-					return dat;
+					return resp;
 				}
 			}
 
@@ -80,19 +82,243 @@ namespace OB{
 			return "ContentProvider";
 		}
 
+		static Enum::AssetPriority _ob_contentprovider_check_priority(lua_State* L, int idx, Enum::AssetPriority defaultPriority){
+			if(lua_isnoneornil(L, idx)){
+				return defaultPriority;
+			}
+
+			shared_ptr<Type::LuaEnumItem> item = Type::checkLuaEnumItem(L, idx, Enum::LuaAssetPriority);
+			if(!item){
+				return defaultPriority;
+			}
+
+			return (Enum::AssetPriority)item->getValue();
+		}
+
 		int ContentProvider::lua_Preload(lua_State* L){
 			shared_ptr<Instance> inst = checkInstance(L, 1, false);
 
 			if(shared_ptr<ContentProvider> cp = dynamic_pointer_cast<ContentProvider>(inst)){
 				std::string urlStr = std::string(luaL_checkstring(L, 2));
+				Enum::AssetPriority priority = _ob_contentprovider_check_priority(L, 3, Enum::AssetPriority::Default);
 
-				cp->Preload(urlStr);
+				cp->Preload(urlStr, priority);
 				return 0;
 			}
 
 			return luaL_error(L, COLONERR, "Preload");
 		}
 
+		struct _ob_contentprovider_preload_waiter{
+			lua_State* L;
+			// Registry reference keeping L alive while it's parked
+			int ref;
+			OBEngine* eng;
+			std::string manifestURL;
+			Enum::AssetPriority priority;
+
+			// Result, pushed when the coroutine is resumed
+			bool ok;
+			int loaded;
+			int failed;
+		};
+
+		static void _ob_contentprovider_free_waiter(struct _ob_contentprovider_preload_waiter* waiter){
+			luaL_unref(waiter->L, LUA_REGISTRYINDEX, waiter->ref);
+			delete waiter;
+		}
+
+		// Pushes the result of PreloadAsync for _ob_contentprovider_preload_continue
+		static int _ob_contentprovider_push_preload_result(lua_State* L, void* ud){
+			struct _ob_contentprovider_preload_waiter* waiter = (struct _ob_contentprovider_preload_waiter*)ud;
+
+			lua_pushboolean(L, waiter->ok);
+			if(waiter->ok){
+				lua_pushinteger(L, waiter->loaded);
+				lua_pushinteger(L, waiter->failed);
+			}else{
+				lua_pushfstring(L, "Failed to load preload manifest '%s'", waiter->manifestURL.c_str());
+				lua_pushnil(L);
+			}
+
+			_ob_contentprovider_free_waiter(waiter);
+			return 3;
+		}
+
+		static void _ob_contentprovider_wake(struct _ob_contentprovider_preload_waiter* waiter){
+			if(!Lua::resume_later(waiter->L, _ob_contentprovider_push_preload_result, waiter)){
+				_ob_contentprovider_free_waiter(waiter);
+			}
+		}
+
+		// Runs in the resumed coroutine, ctx is the top of the stack when it yielded
+		static int _ob_contentprovider_preload_continue(lua_State* L, int status, lua_KContext ctx){
+			(void)status;
+
+			if(!lua_toboolean(L, (int)ctx + 1)){
+				lua_pushvalue(L, (int)ctx + 2);
+				return lua_error(L);
+			}
+
+			lua_pushvalue(L, (int)ctx + 2);
+			lua_pushvalue(L, (int)ctx + 3);
+			return 2;
+		}
+
+		static void _ob_contentprovider_preload_done(shared_ptr<struct _ob_preload_batch> batch, void* ud){
+			struct _ob_contentprovider_preload_waiter* waiter = (struct _ob_contentprovider_preload_waiter*)ud;
+
+			waiter->ok = true;
+			waiter->loaded = batch->loaded;
+			waiter->failed = batch->failed;
+
+			_ob_contentprovider_wake(waiter);
+		}
+
+		/*
+		 * Preloads everything listed in the waiter's manifest, which
+		 * must already be loaded. Returns NULL if it isn't, otherwise
+		 * the batch, which calls _ob_contentprovider_preload_done
+		 * unless it's already empty.
+		 */
+		static shared_ptr<struct _ob_preload_batch> _ob_contentprovider_preload_manifest(struct _ob_contentprovider_preload_waiter* waiter){
+			shared_ptr<AssetLocator> assetLoc = waiter->eng->getAssetLocator();
+
+			shared_ptr<AssetResponse> resp = assetLoc->getAsset(waiter->manifestURL, false);
+			if(!resp || !resp->getData()){
+				return NULL;
+			}
+
+			std::vector<struct _ob_preload_entry> entries = AssetLocator::parseManifest(resp->getData(), resp->getSize(), waiter->priority);
+			return assetLoc->preload(entries, _ob_contentprovider_preload_done, waiter);
+		}
+
+		// The manifest of a parked PreloadAsync is done loading
+		static void _ob_contentprovider_manifest_done(shared_ptr<struct _ob_preload_batch> batch, void* ud){
+			(void)batch;
+
+			struct _ob_contentprovider_preload_waiter* waiter = (struct _ob_contentprovider_preload_waiter*)ud;
+
+			shared_ptr<struct _ob_preload_batch> contents = _ob_contentprovider_preload_manifest(waiter);
+			if(!contents){
+				waiter->ok = false;
+				_ob_contentprovider_wake(waiter);
+				return;
+			}
+
+			if(contents->remaining.empty()){
+				_ob_contentprovider_preload_done(contents, waiter);
+			}
+		}
+
+		int ContentProvider::lua_PreloadAsync(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<ContentProvider> cp = dynamic_pointer_cast<ContentProvider>(inst)){
+				Enum::AssetPriority priority = _ob_contentprovider_check_priority(L, 3, Enum::AssetPriority::Default);
+
+				shared_ptr<AssetLocator> assetLoc = cp->getEngine()->getAssetLocator();
+				std::vector<struct _ob_preload_entry> entries;
+
+				bool isManifest = lua_type(L, 2) == LUA_TSTRING;
+
+				if(isManifest){
+					// URL of a manifest, loaded like any other preloaded asset
+					struct _ob_preload_entry entry;
+					entry.url = std::string(lua_tostring(L, 2));
+					entry.size = 0;
+					entry.priority = priority;
+
+					entries.push_back(entry);
+				}else{
+					luaL_checktype(L, 2, LUA_TTABLE);
+
+					// Each item is a URL, or a table with Url, Size and Priority
+					lua_Integer len = luaL_len(L, 2);
+					for(lua_Integer i = 1; i <= len; i++){
+						lua_rawgeti(L, 2, i);
+
+						struct _ob_preload_entry entry;
+						entry.size = 0;
+						entry.priority = priority;
+
+						if(lua_type(L, -1) == LUA_TTABLE){
+							lua_getfield(L, -1, "Url");
+							entry.url = std::string(luaL_checkstring(L, -1));
+							lua_pop(L, 1);
+
+							lua_getfield(L, -1, "Size");
+							if(!lua_isnil(L, -1)){
+								lua_Number siz = luaL_checknumber(L, -1);
+								if(siz > 0){
+									entry.size = (size_t)siz;
+								}
+							}
+							lua_pop(L, 1);
+
+							lua_getfield(L, -1, "Priority");
+							entry.priority = _ob_contentprovider_check_priority(L, lua_gettop(L), priority);
+							lua_pop(L, 1);
+						}else{
+							entry.url = std::string(luaL_checkstring(L, -1));
+						}
+
+						lua_pop(L, 1);
+
+						entries.push_back(entry);
+					}
+				}
+
+				if(!lua_isyieldable(L)){
+					return luaL_error(L, "attempt to yield from outside a coroutine");
+				}
+
+				struct _ob_contentprovider_preload_waiter* waiter = new struct _ob_contentprovider_preload_waiter;
+				waiter->L = L;
+				waiter->ref = LUA_NOREF;
+				waiter->eng = cp->getEngine();
+				waiter->priority = priority;
+				waiter->ok = true;
+				waiter->loaded = 0;
+				waiter->failed = 0;
+
+				shared_ptr<struct _ob_preload_batch> batch;
+				if(isManifest){
+					waiter->manifestURL = entries[0].url;
+
+					batch = assetLoc->preload(entries, _ob_contentprovider_manifest_done, waiter);
+					if(batch->remaining.empty()){
+						// The manifest was already loaded, or can't be
+						batch = _ob_contentprovider_preload_manifest(waiter);
+						if(!batch){
+							delete waiter;
+							return luaL_error(L, "Failed to load preload manifest '%s'", lua_tostring(L, 2));
+						}
+					}
+				}else{
+					batch = assetLoc->preload(entries, _ob_contentprovider_preload_done, waiter);
+				}
+
+				if(batch->remaining.empty()){
+					// Everything was already loaded
+					delete waiter;
+
+					lua_pushinteger(L, batch->loaded);
+					lua_pushinteger(L, batch->failed);
+					return 2;
+				}
+
+				// Nothing else may refer to L, like a dropped coroutine.wrap
+				lua_pushthread(L);
+				waiter->ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+				// The TaskScheduler resumes us with the counts once the batch is done
+				return lua_yieldk(L, 0, lua_gettop(L), _ob_contentprovider_preload_continue);
+			}
+
+			return luaL_error(L, COLONERR, "PreloadAsync");
+		}
+
 		int ContentProvider::lua_Load(lua_State* L){
 			shared_ptr<Instance> inst = checkInstance(L, 1, false);
 
@@ -112,13 +338,14 @@ namespace OB{
 			if(shared_ptr<ContentProvider> cp = dynamic_pointer_cast<ContentProvider>(inst)){
 				std::string urlStr = std::string(luaL_checkstring(L, 2));
 
-				char* strAsset = cp->GetAsset(urlStr);
-				if(strAsset == NULL){
+				// Hold on to the response, so it can't be evicted while it's copied
+				shared_ptr<AssetResponse> resp = cp->getEngine()->getAssetLocator()->getAsset(urlStr);
+				if(!resp || !resp->getData() || resp->getSize() == 0){
 					lua_pushnil(L);
 					return 1;
 				}
 
-				lua_pushstring(L, strAsset);
+				lua_pushlstring(L, resp->getData(), resp->getSize());
 				return 1;
 			}
 
@@ -140,11 +367,120 @@ namespace OB{
 			return 1;
 		}
 
+		int ContentProvider::lua_getCacheMemoryUsage(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<ContentProvider> cp = dynamic_pointer_cast<ContentProvider>(inst)){
+				OBEngine* eng = Lua::getEngine(L);
+				shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
+
+				lua_pushnumber(L, assetLoc->getCacheSize());
+				return 1;
+			}
+
+			lua_pushnil(L);
+			return 1;
+		}
+
+		int ContentProvider::lua_getCacheMemoryBudget(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<ContentProvider> cp = dynamic_pointer_cast<ContentProvider>(inst)){
+				OBEngine* eng = Lua::getEngine(L);
+				shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
+
+				lua_pushnumber(L, assetLoc->getCacheBudget());
+				return 1;
+			}
+
+			lua_pushnil(L);
+			return 1;
+		}
+
+		int ContentProvider::lua_setCacheMemoryBudget(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<ContentProvider> cp = dynamic_pointer_cast<ContentProvider>(inst)){
+				double newV = luaL_checknumber(L, 2);
+				if(newV < 0){
+					newV = 0;
+				}
+
+				OBEngine* eng = Lua::getEngine(L);
+				shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
+
+				assetLoc->setCacheBudget((size_t)newV);
+			}
+
+			return 0;
+		}
+
+		int ContentProvider::lua_getCacheHitCount(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<ContentProvider> cp = dynamic_pointer_cast<ContentProvider>(inst)){
+				OBEngine* eng = Lua::getEngine(L);
+				shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
+
+				lua_pushnumber(L, assetLoc->getCacheHits());
+				return 1;
+			}
+
+			lua_pushnil(L);
+			return 1;
+		}
+
+		int ContentProvider::lua_getCacheMissCount(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<ContentProvider> cp = dynamic_pointer_cast<ContentProvider>(inst)){
+				OBEngine* eng = Lua::getEngine(L);
+				shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
+
+				lua_pushnumber(L, assetLoc->getCacheMisses());
+				return 1;
+			}
+
+			lua_pushnil(L);
+			return 1;
+		}
+
+		int ContentProvider::lua_getCacheEvictionCount(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<ContentProvider> cp = dynamic_pointer_cast<ContentProvider>(inst)){
+				OBEngine* eng = Lua::getEngine(L);
+				shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
+
+				lua_pushnumber(L, assetLoc->getCacheEvictions());
+				return 1;
+			}
+
+			lua_pushnil(L);
+			return 1;
+		}
+
+		int ContentProvider::lua_getPreloadProgress(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<ContentProvider> cp = dynamic_pointer_cast<ContentProvider>(inst)){
+				OBEngine* eng = Lua::getEngine(L);
+				shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
+
+				lua_pushnumber(L, assetLoc->getPreloadProgress());
+				return 1;
+			}
+
+			lua_pushnil(L);
+			return 1;
+		}
+
 		void ContentProvider::register_lua_methods(lua_State* L){
 			Instance::register_lua_methods(L);
 
 			luaL_Reg methods[] = {
 				{"Preload", lua_Preload},
+				{"PreloadAsync", lua_PreloadAsync},
 				{"Load", lua_Load},
 				{"GetAsset", lua_GetAsset},
 				{NULL, NULL}
@@ -157,6 +493,12 @@ namespace OB{
 
 			luaL_Reg properties[] = {
 				{"RequestQueueSize", Instance::lua_readOnlyProperty},
+				{"CacheMemoryUsage", Instance::lua_readOnlyProperty},
+				{"CacheMemoryBudget", lua_setCacheMemoryBudget},
+				{"CacheHitCount", Instance::lua_readOnlyProperty},
+				{"CacheMissCount", Instance::lua_readOnlyProperty},
+				{"CacheEvictionCount", Instance::lua_readOnlyProperty},
+				{"PreloadProgress", Instance::lua_readOnlyProperty},
 				{NULL, NULL}
 			};
 			luaL_setfuncs(L, properties, 0);
@@ -167,6 +509,12 @@ namespace OB{
 
 			luaL_Reg properties[] = {
 				{"RequestQueueSize", lua_getRequestQueueSize},
+				{"CacheMemoryUsage", lua_getCacheMemoryUsage},
+				{"CacheMemoryBudget", lua_getCacheMemoryBudget},
+				{"CacheHitCount", lua_getCacheHitCount},
+				{"CacheMissCount", lua_getCacheMissCount},
+				{"CacheEvictionCount", lua_getCacheEvictionCount},
+				{"PreloadProgress", lua_getPreloadProgress},
 				{NULL, NULL}
 			};
 			luaL_setfuncs(L, properties, 0);
@@ -63,11 +63,11 @@ namespace OB{
 			if(irr::IrrlichtDevice* irrDev = getEngine()->getIrrlichtDevice()){
 				if(irr::video::IVideoDriver* irrDriv = irrDev->getVideoDriver()){
 					irr::core::rect<irr::s32> vpR = irrDriv->getViewPort();
-					return make_shared<Type::Vector2>(vpR.UpperLeftCorner.X, vpR.UpperLeftCorner.Y);
+					return make_pooled<Type::Vector2>(vpR.UpperLeftCorner.X, vpR.UpperLeftCorner.Y);
 				}
 			}
 #endif
-			return make_shared<Type::Vector2>(0, 0);
+			return make_pooled<Type::Vector2>(0, 0);
 		}
 
 		shared_ptr<Type::Vector2> CoreGui::getAbsoluteSize(){
@@ -75,11 +75,11 @@ namespace OB{
 			if(irr::IrrlichtDevice* irrDev = getEngine()->getIrrlichtDevice()){
 				if(irr::video::IVideoDriver* irrDriv = irrDev->getVideoDriver()){
 					irr::core::rect<irr::s32> vpR = irrDriv->getViewPort();
-					return make_shared<Type::Vector2>(vpR.getWidth(), vpR.getHeight());
+					return make_pooled<Type::Vector2>(vpR.getWidth(), vpR.getHeight());
 				}
 			}
 #endif
-			return make_shared<Type::Vector2>(0, 0);
+			return make_pooled<Type::Vector2>(0, 0);
 		}
 
 		void CoreGui::render(){
@@ -56,6 +56,9 @@ namespace OB{
 			netId = OB_NETID_DATAMODEL;
 			netIdStartIdx = (rand() % (101 - OB_NETID_START)) + OB_NETID_START;
 			netIdNextIdx = netIdStartIdx;
+
+			ticking = false;
+			tickablesDirty = false;
 		}
 
 		DataModel::~DataModel(){}
@@ -78,6 +81,72 @@ namespace OB{
 			eng->shutdown();
 		}
 
+		void DataModel::tick(){
+			ticking = true;
+
+			size_t count = tickables.size();
+			for(size_t i = 0; i < count; i++){
+				// Keeps the Instance alive if it removes itself
+				shared_ptr<Instance> inst = tickables[i].lock();
+				if(inst){
+					inst->tick();
+				}else{
+					// Removed, or destroyed without being removed
+					tickablesDirty = true;
+				}
+			}
+
+			ticking = false;
+
+			if(tickablesDirty){
+				size_t kept = 0;
+				for(size_t i = 0; i < tickables.size(); i++){
+					if(!tickables[i].expired()){
+						tickables[kept++] = tickables[i];
+					}
+				}
+				tickables.resize(kept);
+
+				tickablesDirty = false;
+			}
+		}
+
+		void DataModel::addTickable(shared_ptr<Instance> inst){
+			if(!inst){
+				return;
+			}
+
+			tickables.push_back(inst);
+		}
+
+		void DataModel::removeTickable(shared_ptr<Instance> inst){
+			if(!inst){
+				return;
+			}
+
+			for(size_t i = 0; i < tickables.size(); i++){
+				if(!tickables[i].owner_before(inst) && !inst.owner_before(tickables[i])){
+					if(ticking){
+						tickables[i].reset();
+						tickablesDirty = true;
+					}else{
+						tickables.erase(tickables.begin() + i);
+					}
+					return;
+				}
+			}
+		}
+
+		size_t DataModel::getTickableCount(){
+			size_t count = 0;
+			for(size_t i = 0; i < tickables.size(); i++){
+				if(!tickables[i].expired()){
+					count++;
+				}
+			}
+			return count;
+		}
+
 		void DataModel::initServices(){
 			shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
 
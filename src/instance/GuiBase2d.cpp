@@ -77,11 +77,11 @@ namespace OB{
 		}
 
 		shared_ptr<Type::Vector2> GuiBase2d::getAbsolutePosition(){
-			return make_shared<Type::Vector2>();
+			return make_pooled<Type::Vector2>();
 		}
 
 		shared_ptr<Type::Vector2> GuiBase2d::getAbsoluteSize(){
-			return make_shared<Type::Vector2>();
+			return make_pooled<Type::Vector2>();
 		}
 
 		int GuiBase2d::lua_getAbsolutePosition(lua_State* L){
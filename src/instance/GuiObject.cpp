@@ -59,13 +59,13 @@ namespace OB{
 			Name = ClassName;
 
 			Active = false;
-			BackgroundColor3 = make_shared<Type::Color3>();
+			BackgroundColor3 = make_pooled<Type::Color3>();
 			BackgroundTransparency = 0;
 			BorderColor3 = BackgroundColor3;
 			BorderSizePixel = 1;
 			BorderMode = Enum::BorderMode::Outline;
 			ClipsDescendants = true;
-			Position = make_shared<Type::UDim2>(0, 100, 0, 100);
+			Position = make_pooled<Type::UDim2>(0, 100, 0, 100);
 			Size = Position;
 			Visible = true;
 			ZIndex = 1;
@@ -123,16 +123,14 @@ namespace OB{
 		}
 
 		shared_ptr<Type::Vector2> GuiObject::getAbsolutePosition(){
-			shared_ptr<Type::Vector2> seed = make_shared<Type::Vector2>(0, 0);
-			shared_ptr<Type::UDim> pX = Position->getX();
-			shared_ptr<Type::UDim> pY = Position->getY();
+			shared_ptr<Type::Vector2> seed = make_pooled<Type::Vector2>(0, 0);
 
 			if(Parent){// Sanity check, really.
 				if(shared_ptr<GuiBase2d> pgo = dynamic_pointer_cast<GuiBase2d>(Parent)){
 					shared_ptr<Type::Vector2> pap = pgo->getAbsolutePosition();
 					shared_ptr<Type::Vector2> pas = pgo->getAbsoluteSize();
-					seed->x = pap->getX() + pX->getOffset() + (pX->getScale() * pas->getX());
-					seed->y = pap->getY() + pY->getOffset() + (pY->getScale() * pas->getY());
+					seed->x = pap->getX() + Position->getXOffset() + (Position->getXScale() * pas->getX());
+					seed->y = pap->getY() + Position->getYOffset() + (Position->getYScale() * pas->getY());
 				}
 			}
 
@@ -140,15 +138,13 @@ namespace OB{
 		}
 
 		shared_ptr<Type::Vector2> GuiObject::getAbsoluteSize(){
-			shared_ptr<Type::Vector2> seed = make_shared<Type::Vector2>(0, 0);
-			shared_ptr<Type::UDim> sX = Size->getX();
-			shared_ptr<Type::UDim> sY = Size->getY();
+			shared_ptr<Type::Vector2> seed = make_pooled<Type::Vector2>(0, 0);
 
 			if(Parent){// Sanity check, really.
 				if(shared_ptr<GuiBase2d> pgo = dynamic_pointer_cast<GuiBase2d>(Parent)){
 					shared_ptr<Type::Vector2> pas = pgo->getAbsoluteSize();
-					seed->x = sX->getOffset() + (pas->getX() * sX->getScale());
-					seed->y = sY->getOffset() + (pas->getY() * sY->getScale());
+					seed->x = Size->getXOffset() + (pas->getX() * Size->getXScale());
+					seed->y = Size->getYOffset() + (pas->getY() * Size->getYScale());
 				}
 			}
 
@@ -323,7 +319,7 @@ namespace OB{
 				if(backgroundColor3){
 					BackgroundColor3 = backgroundColor3;
 				}else{
-					BackgroundColor3 = make_shared<Type::Color3>();
+					BackgroundColor3 = make_pooled<Type::Color3>();
 				}
 
 				REPLICATE_PROPERTY_CHANGE(BackgroundColor3);
@@ -353,7 +349,7 @@ namespace OB{
 				if(borderColor3){
 					BorderColor3 = borderColor3;
 				}else{
-					BorderColor3 = make_shared<Type::Color3>();
+					BorderColor3 = make_pooled<Type::Color3>();
 				}
 
 				REPLICATE_PROPERTY_CHANGE(BorderColor3);
@@ -409,7 +405,7 @@ namespace OB{
 				if(position){
 					Position = position;
 				}else{
-					Position = make_shared<Type::UDim2>();
+					Position = make_pooled<Type::UDim2>();
 				}
 
 				REPLICATE_PROPERTY_CHANGE(Position);
@@ -426,7 +422,7 @@ namespace OB{
 				if(size){
 					Size = size;
 				}else{
-					Size = make_shared<Type::UDim2>();
+					Size = make_pooled<Type::UDim2>();
 				}
 
 				REPLICATE_PROPERTY_CHANGE(Size);
@@ -29,11 +29,40 @@
 #include <uuid/uuid.h>
 #endif
 
-#include "AssetLocator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+
+#include "OBEngine.h"
+#include "DownloadManager.h"
 #include "OBException.h"
+#include "utility.h"
 
 namespace OB{
 	namespace Instance{
+#if HAVE_CURL
+		// Hands a request to its callback, then frees it
+		static void _ob_httpservice_complete_request(struct _ob_http_request* hreq){
+			if(hreq->callback){
+				hreq->callback(hreq->req, hreq->ud);
+			}
+
+			if(hreq->L){
+				luaL_unref(hreq->L, LUA_REGISTRYINDEX, hreq->threadRef);
+			}
+
+			delete hreq;
+		}
+
+		// Fails a request whose HttpService is gone
+		static void _ob_httpservice_fail_request(struct _ob_http_request* hreq){
+			hreq->req->ok = false;
+			hreq->req->error = "Cancelled.";
+
+			_ob_httpservice_complete_request(hreq);
+		}
+#endif
+
 		DEFINE_CLASS(HttpService, false, isDataModel, Instance){
 			registerLuaClass(eng, LuaClassName, register_lua_metamethods, register_lua_methods, register_lua_property_getters, register_lua_property_setters, register_lua_events);
 		}
@@ -41,9 +70,28 @@ namespace OB{
 	    HttpService::HttpService(OBEngine* eng) : Instance(eng){
 			Name = ClassName;
 			netId = OB_NETID_HTTPSERVICE;
+
+			maxPerHost = OB_HTTP_DEFAULT_MAX_PER_HOST;
+
+			pthread_mutex_init(&cacheMutex, NULL);
+			cacheSize = 0;
+			cacheBudget = OB_HTTP_CACHE_DEFAULT_BUDGET;
 		}
 
-	    HttpService::~HttpService(){}
+	    HttpService::~HttpService(){
+#if HAVE_CURL
+			// Requests still waiting for a slot will never get one
+			for(std::map<std::string, std::deque<struct _ob_http_request*> >::iterator it = hostQueue.begin(); it != hostQueue.end(); ++it){
+				std::deque<struct _ob_http_request*>& queue = it->second;
+				for(std::deque<struct _ob_http_request*>::iterator qit = queue.begin(); qit != queue.end(); ++qit){
+					_ob_httpservice_fail_request(*qit);
+				}
+			}
+			hostQueue.clear();
+#endif
+
+			pthread_mutex_destroy(&cacheMutex);
+		}
 
 		std::string HttpService::fixedSerializedID(){
 		    return "HttpService";
@@ -53,146 +101,372 @@ namespace OB{
 			return NULL;
 		}
 
-		std::string HttpService::GetAsync(std::string url, bool nocache){
-			(void)nocache;
 #if HAVE_CURL
+		static std::string _ob_httpservice_content_type(int contentType){
+			switch(contentType){
+				case 0:
+					return "Content-Type: application/xml";
+				case 1:
+					return "Content-Type: application/x-www-form-urlencoded";
+				case 2:
+					return "Content-Type: text/plain";
+				case 3:
+					return "Content-Type: text/xml";
+				default:
+					return "Content-Type: application/json";
+			}
+		}
 
-			struct _ob_curl_body* body = new struct _ob_curl_body;
-			body->size = 0;
-			body->data = NULL;
+		/*
+		 * Returns the number of seconds a response may be served
+		 * from the cache, from its Cache-Control header or, failing
+		 * that, its Expires header. 0 or less means it may not be
+		 * cached at all.
+		 */
+		static ob_int64 _ob_httpservice_lifetime(shared_ptr<struct _ob_download_request> req){
+			ob_int64 age = 0;
+			std::map<std::string, std::string>::iterator it = req->responseHeaders.find("age");
+			if(it != req->responseHeaders.end()){
+				age = strtoll(it->second.c_str(), NULL, 10);
+			}
 
-			CURL* curl;
-			CURLcode res;
+			it = req->responseHeaders.find("cache-control");
+			if(it != req->responseHeaders.end()){
+				std::string cc = it->second;
+				std::transform(cc.begin(), cc.end(), cc.begin(), ::tolower);
 
-			curl = curl_easy_init();
-			if(curl){
-				long curl_protos = CURLPROTO_FTP | CURLPROTO_FTPS | CURLPROTO_GOPHER | CURLPROTO_HTTP | CURLPROTO_HTTPS;
-						
-				curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-				curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1);
-				curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
-				curl_easy_setopt(curl, CURLOPT_PROTOCOLS, curl_protos);
-				curl_easy_setopt(curl, CURLOPT_DEFAULT_PROTOCOL, "https");
-				curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, AssetLocator::_ob_assetlocator_write_data);
-				curl_easy_setopt(curl, CURLOPT_WRITEDATA, body);
-
-				res = curl_easy_perform(curl);
-				if(res != CURLE_OK){
-					std::cout << "[HttpService] cURL Error: " << curl_easy_strerror(res) << std::endl;
-
-					curl_easy_cleanup(curl);
-
-					if(body->data){
-						delete[] body->data;
+				ob_int64 maxAge = -1;
+
+				size_t pos = 0;
+				while(pos < cc.size()){
+					size_t comma = cc.find(',', pos);
+					if(comma == std::string::npos){
+						comma = cc.size();
 					}
 
-					delete body;
+					std::string directive = cc.substr(pos, comma - pos);
+					size_t first = directive.find_first_not_of(" \t");
+					if(first != std::string::npos){
+						directive = directive.substr(first, directive.find_last_not_of(" \t") - first + 1);
+
+						if(directive == "no-store" || directive == "no-cache"){
+							return 0;
+						}
+						if(directive.compare(0, 8, "max-age=") == 0){
+							maxAge = strtoll(directive.c_str() + 8, NULL, 10);
+						}
+					}
 
-					throw new OBException("A cURL error occurred");
+					pos = comma + 1;
 				}
 
-				curl_easy_cleanup(curl);
-			}else{
-				throw new OBException("Failed to initialize cURL.");
+				if(maxAge >= 0){
+					return maxAge - age;
+				}
+			}
+
+			it = req->responseHeaders.find("expires");
+			if(it != req->responseHeaders.end()){
+				time_t expires = curl_getdate(it->second.c_str(), NULL);
+				if(expires > 0){
+					return (ob_int64)expires - (ob_int64)time(NULL);
+				}
 			}
 
-			if(body->data){
-				std::string retStr = std::string(body->data);
+			return 0;
+		}
 
-				delete[] body->data;
-				delete body;
+		// Called from DownloadManager::tick when a request started by HttpService::request is done
+		static void _ob_httpservice_request_done(shared_ptr<struct _ob_download_request> req, void* ud){
+			(void)req;
 
-				return retStr;
+			struct _ob_http_request* hreq = (struct _ob_http_request*)ud;
+
+			shared_ptr<HttpService> hs = dynamic_pointer_cast<HttpService>(hreq->svc.lock());
+			if(!hs){
+				_ob_httpservice_fail_request(hreq);
+				return;
+			}
+
+			hs->finishRequest(hreq);
+
+			_ob_httpservice_complete_request(hreq);
+		}
+
+		void HttpService::request(shared_ptr<struct _ob_download_request> req, bool cacheable, ob_download_fnc callback, void* ud, lua_State* L){
+			struct _ob_http_request* hreq = new struct _ob_http_request;
+			hreq->svc = shared_from_this();
+			hreq->host = getHost(req->url);
+			hreq->cacheable = cacheable;
+			hreq->req = req;
+			hreq->callback = callback;
+			hreq->ud = ud;
+
+			hreq->L = L;
+			hreq->threadRef = LUA_NOREF;
+			if(L){
+				lua_pushthread(L);
+				hreq->threadRef = luaL_ref(L, LUA_REGISTRYINDEX);
+			}
+
+			if(hostActive[hreq->host] < maxPerHost){
+				startRequest(hreq);
 			}else{
-				delete body;
-				return "";
+				hostQueue[hreq->host].push_back(hreq);
 			}
-#else
-			(void)url;
-			throw new OBException("No cURL support.");
-#endif
 		}
 
-		std::string HttpService::PostAsync(std::string url, std::string data, int contentType){
-#if HAVE_CURL
+		void HttpService::startRequest(struct _ob_http_request* hreq){
+			hostActive[hreq->host]++;
 
-			struct _ob_curl_body* body = new struct _ob_curl_body;
-			body->size = 0;
-			body->data = NULL;
+			hreq->req->callback = _ob_httpservice_request_done;
+			hreq->req->ud = hreq;
 
-			CURL* curl;
-			CURLcode res;
+			eng->getDownloadManager()->submit(hreq->req);
+		}
 
-			curl = curl_easy_init();
-			if(curl){
-				struct curl_slist* chunk = NULL;
-
-				switch(contentType){
-					case 0:
-						chunk = curl_slist_append(chunk, "Content-Type: application/xml");
-						break;
-					case 1:
-						chunk = curl_slist_append(chunk, "Content-Type: application/x-www-form-urlencoded");
-						break;
-					case 2:
-						chunk = curl_slist_append(chunk, "Content-Type: text/plain");
-						break;
-					case 3:
-						chunk = curl_slist_append(chunk, "Content-Type: text/xml");
-						break;
-					default:
-						chunk = curl_slist_append(chunk, "Content-Type: application/json");
-				}
+		void HttpService::finishRequest(struct _ob_http_request* hreq){
+			if(hreq->cacheable){
+				storeResponse(hreq->req);
+			}
 
-				res = curl_easy_setopt(curl, CURLOPT_HTTPHEADER, chunk);
-				if(res != CURLE_OK){
-					std::cout << "[HttpService] cURL Error: " << curl_easy_strerror(res) << std::endl;
-				}
-				
-				long curl_protos = CURLPROTO_HTTP | CURLPROTO_HTTPS;
-						
-				curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-				curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data.c_str());
-				curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1);
-				curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
-				curl_easy_setopt(curl, CURLOPT_PROTOCOLS, curl_protos);
-				curl_easy_setopt(curl, CURLOPT_DEFAULT_PROTOCOL, "https");
-				curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, AssetLocator::_ob_assetlocator_write_data);
-				curl_easy_setopt(curl, CURLOPT_WRITEDATA, body);
-
-				res = curl_easy_perform(curl);
-				if(res != CURLE_OK){
-					std::cout << "[HttpService] cURL Error: " << curl_easy_strerror(res) << std::endl;
-
-					curl_easy_cleanup(curl);
-
-					if(body->data){
-						delete[] body->data;
-					}
+			std::string host = hreq->host;
+
+			std::map<std::string, int>::iterator it = hostActive.find(host);
+			if(it != hostActive.end()){
+				it->second--;
+			}
+
+			// Hand the freed slots to requests waiting on the same host
+			std::map<std::string, std::deque<struct _ob_http_request*> >::iterator qit = hostQueue.find(host);
+			while(qit != hostQueue.end() && !qit->second.empty() && hostActive[host] < maxPerHost){
+				struct _ob_http_request* next = qit->second.front();
+				qit->second.pop_front();
+
+				startRequest(next);
+			}
+			if(qit != hostQueue.end() && qit->second.empty()){
+				hostQueue.erase(qit);
+			}
+
+			it = hostActive.find(host);
+			if(it != hostActive.end() && it->second <= 0){
+				hostActive.erase(it);
+			}
+		}
+
+		void HttpService::storeResponse(shared_ptr<struct _ob_download_request> req){
+			if(!req->ok || req->responseCode != 200){
+				return;
+			}
+
+			ob_int64 lifetime = _ob_httpservice_lifetime(req);
+			if(lifetime <= 0){
+				return;
+			}
+
+			pthread_mutex_lock(&cacheMutex);
 
-					delete body;
+			if(req->size > cacheBudget){
+				pthread_mutex_unlock(&cacheMutex);
+				return;
+			}
+
+			std::map<std::string, struct _ob_http_cache_entry>::iterator it = cache.find(req->url);
+			if(it != cache.end()){
+				cacheSize -= it->second.body.size();
+				cacheLRU.erase(it->second.lruIt);
+				cache.erase(it);
+			}
+
+			cacheLRU.push_front(req->url);
+
+			struct _ob_http_cache_entry& entry = cache[req->url];
+			if(req->data){
+				entry.body = std::string(req->data, req->size);
+			}
+			entry.expires = currentTimeMillis() + (ob_uint64)lifetime * 1000;
+			entry.lruIt = cacheLRU.begin();
+
+			cacheSize += entry.body.size();
 
-					throw new OBException("A cURL error occurred");
+			trimCache();
+
+			pthread_mutex_unlock(&cacheMutex);
+		}
+#endif
+
+		bool HttpService::getCachedResponse(std::string url, std::string& body){
+			pthread_mutex_lock(&cacheMutex);
+
+			std::map<std::string, struct _ob_http_cache_entry>::iterator it = cache.find(url);
+			if(it == cache.end()){
+				pthread_mutex_unlock(&cacheMutex);
+				return false;
+			}
+
+			if(it->second.expires <= currentTimeMillis()){
+				cacheSize -= it->second.body.size();
+				cacheLRU.erase(it->second.lruIt);
+				cache.erase(it);
+
+				pthread_mutex_unlock(&cacheMutex);
+				return false;
+			}
+
+			cacheLRU.splice(cacheLRU.begin(), cacheLRU, it->second.lruIt);
+			body = it->second.body;
+
+			pthread_mutex_unlock(&cacheMutex);
+			return true;
+		}
+
+		void HttpService::trimCache(){
+			while(cacheSize > cacheBudget && !cacheLRU.empty()){
+				std::map<std::string, struct _ob_http_cache_entry>::iterator it = cache.find(cacheLRU.back());
+				if(it != cache.end()){
+					cacheSize -= it->second.body.size();
+					cache.erase(it);
 				}
+				cacheLRU.pop_back();
+			}
+		}
 
-				curl_easy_cleanup(curl);
+		size_t HttpService::getCacheSize(){
+			pthread_mutex_lock(&cacheMutex);
+			size_t siz = cacheSize;
+			pthread_mutex_unlock(&cacheMutex);
+
+			return siz;
+		}
+
+		size_t HttpService::getCacheBudget(){
+			pthread_mutex_lock(&cacheMutex);
+			size_t budget = cacheBudget;
+			pthread_mutex_unlock(&cacheMutex);
+
+			return budget;
+		}
+
+		void HttpService::setCacheBudget(size_t budget){
+			pthread_mutex_lock(&cacheMutex);
+			cacheBudget = budget;
+			trimCache();
+			pthread_mutex_unlock(&cacheMutex);
+		}
+
+		void HttpService::clearCache(){
+			pthread_mutex_lock(&cacheMutex);
+			cache.clear();
+			cacheLRU.clear();
+			cacheSize = 0;
+			pthread_mutex_unlock(&cacheMutex);
+		}
+
+		int HttpService::getMaxRequestsPerHost(){
+			return maxPerHost;
+		}
+
+		void HttpService::setMaxRequestsPerHost(int maxPerHost){
+			if(maxPerHost < 1){
+				maxPerHost = 1;
+			}
+			this->maxPerHost = maxPerHost;
+		}
+
+		std::string HttpService::getHost(std::string url){
+			size_t start = url.find("://");
+			if(start == std::string::npos){
+				start = 0;
 			}else{
+				start += 3;
+			}
+
+			size_t end = url.find_first_of("/?#", start);
+			std::string host;
+			if(end == std::string::npos){
+				host = url.substr(start);
+			}else{
+				host = url.substr(start, end - start);
+			}
+
+			// Drop any credentials
+			size_t at = host.rfind('@');
+			if(at != std::string::npos){
+				host = host.substr(at + 1);
+			}
+
+			std::transform(host.begin(), host.end(), host.begin(), ::tolower);
+			return host;
+		}
+
+		std::string HttpService::GetAsync(std::string url, bool nocache){
+			if(!nocache){
+				std::string body;
+				if(getCachedResponse(url, body)){
+					return body;
+				}
+			}
+
+#if HAVE_CURL
+			shared_ptr<DownloadManager> dm = eng->getDownloadManager();
+			if(!dm){
 				throw new OBException("Failed to initialize cURL.");
 			}
 
-			if(body->data){
-				std::string retStr = std::string(body->data);
+			shared_ptr<struct _ob_download_request> req = make_shared<struct _ob_download_request>();
+			req->url = url;
+			req->protocols = CURLPROTO_FTP | CURLPROTO_FTPS | CURLPROTO_GOPHER | CURLPROTO_HTTP | CURLPROTO_HTTPS;
 
-				delete[] body->data;
-				delete body;
+			dm->perform(req);
 
-				return retStr;
-			}else{
-				delete body;
-				return "";
+			if(!req->ok){
+				std::cout << "[HttpService] cURL Error: " << req->error << std::endl;
+
+				throw new OBException("A cURL error occurred");
 			}
+
+			storeResponse(req);
+
+			if(req->data){
+				return std::string(req->data, req->size);
+			}
+			return "";
+#else
+			throw new OBException("No cURL support.");
+#endif
+		}
+
+		std::string HttpService::PostAsync(std::string url, std::string data, int contentType){
+#if HAVE_CURL
+			shared_ptr<DownloadManager> dm = eng->getDownloadManager();
+			if(!dm){
+				throw new OBException("Failed to initialize cURL.");
+			}
+
+			shared_ptr<struct _ob_download_request> req = make_shared<struct _ob_download_request>();
+			req->url = url;
+			req->protocols = CURLPROTO_HTTP | CURLPROTO_HTTPS;
+			req->post = true;
+			req->postData = data;
+			req->headers.push_back(_ob_httpservice_content_type(contentType));
+
+			dm->perform(req);
+
+			if(!req->ok){
+				std::cout << "[HttpService] cURL Error: " << req->error << std::endl;
+
+				throw new OBException("A cURL error occurred");
+			}
+
+			if(req->data){
+				return std::string(req->data, req->size);
+			}
+			return "";
 #else
 			(void)url;
+			(void)data;
+			(void)contentType;
 			throw new OBException("No cURL support.");
 #endif
 		}
@@ -278,5 +552,137 @@ namespace OB{
 				return guidString;
 			}
 		}
+
+#if HAVE_CURL
+		// Pushes a finished request for _ob_httpservice_continue
+		static int _ob_httpservice_push_response(lua_State* L, void* ud){
+			shared_ptr<struct _ob_download_request>* reqp = (shared_ptr<struct _ob_download_request>*)ud;
+			shared_ptr<struct _ob_download_request> req = *reqp;
+			delete reqp;
+
+			if(req->ok){
+				lua_pushboolean(L, true);
+				if(req->data){
+					lua_pushlstring(L, req->data, req->size);
+				}else{
+					lua_pushstring(L, "");
+				}
+			}else{
+				lua_pushboolean(L, false);
+				lua_pushfstring(L, "A cURL error occurred: %s", req->error.c_str());
+			}
+
+			return 2;
+		}
+
+		// Called from the engine tick once a request made by GetAsync or PostAsync is done
+		static void _ob_httpservice_request_finished(shared_ptr<struct _ob_download_request> req, void* ud){
+			shared_ptr<struct _ob_download_request>* reqp = new shared_ptr<struct _ob_download_request>(req);
+			if(!Lua::resume_later((lua_State*)ud, _ob_httpservice_push_response, reqp)){
+				delete reqp;
+			}
+		}
+
+		// Runs in the resumed coroutine, so a failed request raises the error in the calling script
+		static int _ob_httpservice_continue(lua_State* L, int status, lua_KContext ctx){
+			(void)status;
+			(void)ctx;
+
+			if(!lua_toboolean(L, -2)){
+				return lua_error(L);
+			}
+			return 1;
+		}
+
+		static int _ob_httpservice_yield(lua_State* L, shared_ptr<HttpService> hs, shared_ptr<struct _ob_download_request> req, bool cacheable){
+			hs->request(req, cacheable, _ob_httpservice_request_finished, L, L);
+
+			// The TaskScheduler resumes us with the response
+			return lua_yieldk(L, 0, 0, _ob_httpservice_continue);
+		}
+#endif
+
+		int HttpService::lua_GetAsync(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<HttpService> hs = dynamic_pointer_cast<HttpService>(inst)){
+				std::string url = std::string(luaL_checkstring(L, 2));
+				bool nocache = lua_toboolean(L, 3);
+
+				if(!nocache){
+					std::string body;
+					if(hs->getCachedResponse(url, body)){
+						lua_pushlstring(L, body.c_str(), body.size());
+						return 1;
+					}
+				}
+
+#if HAVE_CURL
+				if(!hs->getEngine()->getDownloadManager()){
+					return luaL_error(L, "Failed to initialize cURL.");
+				}
+				if(!lua_isyieldable(L)){
+					return luaL_error(L, "attempt to yield from outside a coroutine");
+				}
+
+				shared_ptr<struct _ob_download_request> req = make_shared<struct _ob_download_request>();
+				req->url = url;
+				req->protocols = CURLPROTO_FTP | CURLPROTO_FTPS | CURLPROTO_GOPHER | CURLPROTO_HTTP | CURLPROTO_HTTPS;
+
+				return _ob_httpservice_yield(L, hs, req, true);
+#else
+				return luaL_error(L, "No cURL support.");
+#endif
+			}
+
+			return luaL_error(L, COLONERR, "GetAsync");
+		}
+
+		int HttpService::lua_PostAsync(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<HttpService> hs = dynamic_pointer_cast<HttpService>(inst)){
+				std::string url = std::string(luaL_checkstring(L, 2));
+				size_t dataLen = 0;
+				const char* data = luaL_checklstring(L, 3, &dataLen);
+				int contentType = (int)luaL_optinteger(L, 4, -1);
+
+#if HAVE_CURL
+				if(!hs->getEngine()->getDownloadManager()){
+					return luaL_error(L, "Failed to initialize cURL.");
+				}
+				if(!lua_isyieldable(L)){
+					return luaL_error(L, "attempt to yield from outside a coroutine");
+				}
+
+				shared_ptr<struct _ob_download_request> req = make_shared<struct _ob_download_request>();
+				req->url = url;
+				req->protocols = CURLPROTO_HTTP | CURLPROTO_HTTPS;
+				req->post = true;
+				req->postData = std::string(data, dataLen);
+				req->headers.push_back(_ob_httpservice_content_type(contentType));
+
+				return _ob_httpservice_yield(L, hs, req, false);
+#else
+				(void)url;
+				(void)data;
+				(void)contentType;
+				return luaL_error(L, "No cURL support.");
+#endif
+			}
+
+			return luaL_error(L, COLONERR, "PostAsync");
+		}
+
+		void HttpService::register_lua_methods(lua_State* L){
+			Instance::register_lua_methods(L);
+
+			luaL_Reg methods[] = {
+				{"GetAsync", lua_GetAsync},
+				{"PostAsync", lua_PostAsync},
+				{NULL, NULL}
+			};
+			luaL_setfuncs(L, methods, 0);
+		}
 	}
 }
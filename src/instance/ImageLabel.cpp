@@ -38,7 +38,7 @@ namespace OB{
 			Name = ClassName;
 
 			Image = "";
-			ImageColor3 = make_shared<Type::Color3>(255, 255, 255);
+			ImageColor3 = make_pooled<Type::Color3>(255, 255, 255);
 			ImageTransparency = 1;
 
 			img_needs_updating = false;
@@ -48,7 +48,17 @@ namespace OB{
 #endif
 		}
 
-		ImageLabel::~ImageLabel(){}
+		ImageLabel::~ImageLabel(){
+#if HAVE_IRRLICHT
+			if(img){
+				shared_ptr<OBRenderUtils> renderUtils = eng->getRenderUtils();
+				if(renderUtils){
+					renderUtils->releaseTexture(img);
+				}
+				img = NULL;
+			}
+#endif
+		}
 
 		shared_ptr<Instance> ImageLabel::cloneImpl(){
 			shared_ptr<ImageLabel> imgLbl = make_shared<ImageLabel>(eng);
@@ -71,7 +81,8 @@ namespace OB{
 			imgLbl->ImageTransparency = ImageTransparency;
 
 #if HAVE_IRRLICHT
-			imgLbl->img = img;
+			// Gets its own reference to the texture
+			imgLbl->img_needs_updating = !Image.empty();
 #endif
 
 			return imgLbl;
@@ -79,19 +90,25 @@ namespace OB{
 
 		void ImageLabel::updateImage(){
 #if HAVE_IRRLICHT
-			shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
-			if(assetLoc){
-				shared_ptr<AssetResponse> resp = assetLoc->getAsset(Image);
-				if(resp){
-					irr::io::IReadFile* irf = resp->toIReadFile();
-					if(irf){
-						irr::IrrlichtDevice* irrDev = eng->getIrrlichtDevice();
-						if(irrDev){
-							irr::video::IVideoDriver* irrDriv = irrDev->getVideoDriver();
-							if(irrDriv){
-								img = irrDriv->getTexture(irf);
-							}
-						}
+			shared_ptr<OBRenderUtils> renderUtils = eng->getRenderUtils();
+			if(renderUtils){
+				// Acquired before the old one is released, in case they're the same
+				bool pending = false;
+				irr::video::ITexture* newImg = renderUtils->acquireTexture(Image, 0, pending);
+
+				renderUtils->releaseTexture(img);
+				img = newImg;
+
+				// Still decoding, try again next frame
+				img_needs_updating = pending;
+
+				// The asset was evicted before it could be decoded,
+				// assetLoaded picks it up again once it's reloaded
+				if(!newImg && !pending && !Image.empty()){
+					shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
+					if(assetLoc){
+						shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
+						assetLoc->requireAsset(Image, sharedThis, Enum::AssetPriority::UI);
 					}
 				}
 			}
@@ -105,12 +122,9 @@ namespace OB{
 				if(!Image.empty()){
 					shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 					if(assetLoc){
-						if(assetLoc->hasAsset(Image)){
-						    img_needs_updating = true;
-						}else{
-							shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
-							assetLoc->addWaitingInstance(sharedThis);
-							assetLoc->loadAsset(Image);
+						shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
+						if(assetLoc->requireAsset(Image, sharedThis, Enum::AssetPriority::UI)){
+							img_needs_updating = true;
 						}
 					}
 				}
@@ -129,7 +143,7 @@ namespace OB{
 				if(imageColor3){
 					ImageColor3 = imageColor3;
 				}else{
-					ImageColor3 = make_shared<Type::Color3>();
+					ImageColor3 = make_pooled<Type::Color3>();
 				}
 
 				REPLICATE_PROPERTY_CHANGE(ImageColor3);
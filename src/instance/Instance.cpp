@@ -56,9 +56,25 @@ namespace OB{
 			ChildRemoved = make_shared<Type::Event>("ChildRemoved");
 			DescendantAdded = make_shared<Type::Event>("DescendantAdded");
 			DescendantRemoving = make_shared<Type::Event>("DescendantRemoving");
+
+			descendantListeners = 0;
+			ancestryListeners = 0;
+
+			tickable = false;
+			ancestryAware = false;
+			ancestryDependents = 0;
+
+			AncestryChanged->setListenerHook(ancestryListenersChanged, this);
+			DescendantAdded->setListenerHook(descendantListenersChanged, this);
+			DescendantRemoving->setListenerHook(descendantListenersChanged, this);
 		}
 
 		Instance::~Instance(){
+			// Lua may still hold these events after we're gone
+			AncestryChanged->setListenerHook(NULL, NULL);
+			DescendantAdded->setListenerHook(NULL, NULL);
+			DescendantRemoving->setListenerHook(NULL, NULL);
+
 			if(netId >= OB_NETID_START){
 				shared_ptr<DataModel> dm = eng->getDataModel();
 				if(dm){
@@ -273,6 +289,25 @@ namespace OB{
 			return fullName;
 		}
 
+		shared_ptr<Type::Event> Instance::GetPropertyChangedSignal(std::string property){
+			std::map<std::string, shared_ptr<Type::Event>>::iterator it = propertyChangedSignals.find(property);
+			if(it != propertyChangedSignals.end()){
+				return it->second;
+			}
+
+			if(property != "Parent"){
+				std::map<std::string, _PropertyInfo> props = getProperties();
+				if(props.find(property) == props.end()){
+					return NULL;
+				}
+			}
+
+			shared_ptr<Type::Event> evt = make_shared<Type::Event>(property + "Changed");
+			propertyChangedSignals[property] = evt;
+
+			return evt;
+		}
+
 		bool Instance::IsA(std::string name){
 			return OB::ClassFactory::isA(shared_from_this(), name);
 		}
@@ -563,19 +598,19 @@ namespace OB{
 							setProperty(name, make_shared<Type::VarWrapper>(propVal.as_float()));
 						}
 						if(stype == "Color3"){
-							setProperty(name, make_shared<Type::VarWrapper>(make_shared<Type::Color3>(propVal.as_string())));
+							setProperty(name, make_shared<Type::VarWrapper>(make_pooled<Type::Color3>(propVal.as_string())));
 						}
 						if(stype == "Vector2"){
-							setProperty(name, make_shared<Type::VarWrapper>(make_shared<Type::Vector2>(propVal.as_string())));
+							setProperty(name, make_shared<Type::VarWrapper>(make_pooled<Type::Vector2>(propVal.as_string())));
 						}
 						if(stype == "Vector3"){
-							setProperty(name, make_shared<Type::VarWrapper>(make_shared<Type::Vector3>(propVal.as_string())));
+							setProperty(name, make_shared<Type::VarWrapper>(make_pooled<Type::Vector3>(propVal.as_string())));
 						}
 						if(stype == "UDim"){
-							setProperty(name, make_shared<Type::VarWrapper>(make_shared<Type::UDim>(propVal.as_string())));
+							setProperty(name, make_shared<Type::VarWrapper>(make_pooled<Type::UDim>(propVal.as_string())));
 						}
 						if(stype == "UDim2"){
-							setProperty(name, make_shared<Type::VarWrapper>(make_shared<Type::UDim2>(propVal.as_string())));
+							setProperty(name, make_shared<Type::VarWrapper>(make_pooled<Type::UDim2>(propVal.as_string())));
 						}
 						if(stype == "Instance"){
 							if(serializer){
@@ -685,9 +720,7 @@ namespace OB{
 			return make_shared<Type::VarWrapper>();
 		}
 
-		void Instance::tick(){
-			tickChildren();
-		}
+		void Instance::tick(){}
 
 		void Instance::preRender(){
 			std::vector<shared_ptr<Instance>> kids = GetChildren();
@@ -769,18 +802,78 @@ namespace OB{
 
 			// Item get
 			lua_pushstring(L, "__index");
-			lua_pushcfunction(L, lua_index);
+			buildLuaIndexTable(L, lua_gettop(L) - 1);
+			lua_pushcclosure(L, lua_index, 1);
 			lua_rawset(L, -3);
 
 			// Item set
 			lua_pushstring(L, "__newindex");
-			lua_pushcfunction(L, lua_newindex);
+			lua_getfield(L, -2, "__propertysetters");
+			lua_pushcclosure(L, lua_newindex, 1);
 			lua_rawset(L, -3);
 
 			lua_pop(L, 1);
 		}
 
+		/*
+		 * Entry in the flattened __index table of an Instance class,
+		 * stored as full userdata so it is owned by the table.
+		 */
+		enum _ob_lua_index_kind{
+			OB_LUA_INDEX_GETTER,
+			OB_LUA_INDEX_METHOD,
+			OB_LUA_INDEX_EVENT
+		};
+
+		struct _ob_lua_index_entry{
+			_ob_lua_index_kind kind;
+			lua_CFunction fnc;
+		};
+
+		static void _ob_lua_index_add(lua_State* L, int metatable, const char* tableName, _ob_lua_index_kind kind){
+			// Expects the index table on top of the stack
+			lua_getfield(L, metatable, tableName);
+			lua_pushnil(L);
+			while(lua_next(L, -2) != 0){
+				if(lua_type(L, -2) == LUA_TSTRING && lua_iscfunction(L, -1)){
+					lua_CFunction fnc = lua_tocfunction(L, -1);
+
+					lua_pushvalue(L, -2);
+					struct _ob_lua_index_entry* entry = (struct _ob_lua_index_entry*)lua_newuserdata(L, sizeof(struct _ob_lua_index_entry));
+					entry->kind = kind;
+					entry->fnc = fnc;
+					lua_rawset(L, -6);
+				}
+				lua_pop(L, 1);
+			}
+			lua_pop(L, 1);
+		}
+
+		void Instance::buildLuaIndexTable(lua_State* L, int metatable){
+			metatable = lua_absindex(L, metatable);
+
+			lua_newtable(L);
+
+			// Later entries win, so add in reverse order of precedence
+			_ob_lua_index_add(L, metatable, "__events", OB_LUA_INDEX_EVENT);
+			_ob_lua_index_add(L, metatable, "__methods", OB_LUA_INDEX_METHOD);
+			_ob_lua_index_add(L, metatable, "__propertygetters", OB_LUA_INDEX_GETTER);
+		}
+
 		void Instance::propertyChanged(std::string property){
+			if(!propertyChangedSignals.empty()){
+				std::map<std::string, shared_ptr<Type::Event>>::iterator it = propertyChangedSignals.find(property);
+				if(it != propertyChangedSignals.end()){
+					// Hold on to it in case a listener drops the last reference
+					shared_ptr<Type::Event> propEvt = it->second;
+					propEvt->Fire(eng);
+				}
+			}
+
+			if(!Changed->hasListeners()){
+				return;
+			}
+
 			std::vector<shared_ptr<Type::VarWrapper>> args = std::vector<shared_ptr<Type::VarWrapper>>({make_shared<Type::VarWrapper>(property)});
 
 			Changed->Fire(eng, args);
@@ -806,11 +899,32 @@ namespace OB{
 				return;
 			}
 
+			int ownDependents = ancestryDependents + (needsAncestryUpdates() ? 1 : 0);
+
 			if(Parent){
+				if(ancestryListeners > 0){
+					Parent->adjustAncestryListeners(-ancestryListeners);
+				}
+				if(ownDependents > 0){
+					Parent->adjustAncestryDependents(-ownDependents);
+				}
 				Parent->removeChild(shared_from_this());
 			}
 			Parent = parent;
+
+			int ownDescListeners = DescendantAdded->getListenerCount() + DescendantRemoving->getListenerCount();
+			int newDescListeners = ownDescListeners + (Parent ? Parent->descendantListeners : 0);
+			if(newDescListeners != descendantListeners){
+				adjustDescendantListeners(newDescListeners - descendantListeners);
+			}
+
 			if(Parent){
+				if(ancestryListeners > 0){
+					Parent->adjustAncestryListeners(ancestryListeners);
+				}
+				if(ownDependents > 0){
+					Parent->adjustAncestryDependents(ownDependents);
+				}
 				Parent->addChild(shared_from_this());
 
 #ifdef HAVE_ENET
@@ -852,10 +966,76 @@ namespace OB{
 #endif
 			}
 
-			fireAncestryChanged(std::vector<shared_ptr<Type::VarWrapper>>({make_shared<Type::VarWrapper>(std::enable_shared_from_this<Instance>::shared_from_this()), make_shared<Type::VarWrapper>(Parent)}));
+			notifyAncestryUpdated();
+
+			if(ancestryListeners > 0){
+				fireAncestryChanged(std::vector<shared_ptr<Type::VarWrapper>>({make_shared<Type::VarWrapper>(std::enable_shared_from_this<Instance>::shared_from_this()), make_shared<Type::VarWrapper>(Parent)}));
+			}
 			propertyChanged("Parent");
 		}
 
+		void Instance::ancestryUpdated(){}
+
+		void Instance::updateTickRegistration(){
+			shared_ptr<DataModel> dm;
+
+			shared_ptr<Instance> anc = Parent;
+			while(anc){
+				dm = dynamic_pointer_cast<DataModel>(anc);
+				if(dm){
+					break;
+				}
+				anc = anc->getParent();
+			}
+
+			shared_ptr<DataModel> oldDM = tickDataModel.lock();
+			if(dm == oldDM){
+				return;
+			}
+
+			if(oldDM){
+				oldDM->removeTickable(std::enable_shared_from_this<Instance>::shared_from_this());
+			}
+
+			tickDataModel = dm;
+
+			if(dm){
+				dm->addTickable(std::enable_shared_from_this<Instance>::shared_from_this());
+			}
+		}
+
+		void Instance::notifyAncestryUpdated(){
+			if(tickable){
+				updateTickRegistration();
+			}
+
+			ancestryUpdated();
+
+			// Nothing further down cares
+			if(ancestryDependents == 0){
+				return;
+			}
+
+			for(std::vector<shared_ptr<Instance>>::size_type i = 0; i < children.size(); i++){
+				shared_ptr<Instance> kid = children[i];
+				if(kid && (kid->ancestryDependents > 0 || kid->needsAncestryUpdates())){
+					kid->notifyAncestryUpdated();
+				}
+			}
+		}
+
+		bool Instance::needsAncestryUpdates(){
+			return tickable || ancestryAware;
+		}
+
+		void Instance::adjustAncestryDependents(int delta){
+			ancestryDependents += delta;
+
+			if(Parent){
+				Parent->adjustAncestryDependents(delta);
+			}
+		}
+
 		std::string Instance::toString(){
 			return Name;
 		}
@@ -868,7 +1048,11 @@ namespace OB{
 			return Parent;
 		}
 
-		void Instance::fireAncestryChanged(std::vector<shared_ptr<Type::VarWrapper>> args){
+		void Instance::fireAncestryChanged(const std::vector<shared_ptr<Type::VarWrapper>>& args){
+			if(ancestryListeners == 0){
+				return;
+			}
+
 			AncestryChanged->Fire(eng, args);
 
 			for(std::vector<shared_ptr<Instance>>::size_type i = 0; i != children.size(); i++){
@@ -879,7 +1063,12 @@ namespace OB{
 			}
 		}
 
-		void Instance::fireDescendantAdded(std::vector<shared_ptr<Type::VarWrapper>> args){
+		void Instance::fireDescendantAdded(const std::vector<shared_ptr<Type::VarWrapper>>& args){
+			// Nobody here or further up is listening
+			if(descendantListeners == 0){
+				return;
+			}
+
 			DescendantAdded->Fire(eng, args);
 
 			if(Parent){
@@ -887,7 +1076,11 @@ namespace OB{
 			}
 		}
 
-		void Instance::fireDescendantRemoving(std::vector<shared_ptr<Type::VarWrapper>> args){
+		void Instance::fireDescendantRemoving(const std::vector<shared_ptr<Type::VarWrapper>>& args){
+			if(descendantListeners == 0){
+				return;
+			}
+
 			DescendantRemoving->Fire(eng, args);
 
 			if(Parent){
@@ -895,14 +1088,48 @@ namespace OB{
 			}
 		}
 
+		void Instance::adjustDescendantListeners(int delta){
+			descendantListeners += delta;
+
+			for(std::vector<shared_ptr<Instance>>::size_type i = 0; i != children.size(); i++){
+				shared_ptr<Instance> kid = children[i];
+				if(kid){
+					kid->adjustDescendantListeners(delta);
+				}
+			}
+		}
+
+		void Instance::adjustAncestryListeners(int delta){
+			ancestryListeners += delta;
+
+			if(Parent){
+				Parent->adjustAncestryListeners(delta);
+			}
+		}
+
+		void Instance::descendantListenersChanged(Type::Event* evt, int delta, void* ud){
+			(void)evt;
+
+			Instance* inst = (Instance*)ud;
+			inst->adjustDescendantListeners(delta);
+		}
+
+		void Instance::ancestryListenersChanged(Type::Event* evt, int delta, void* ud){
+			(void)evt;
+
+			Instance* inst = (Instance*)ud;
+			inst->adjustAncestryListeners(delta);
+		}
+
 		void Instance::removeChild(shared_ptr<Instance> kid){
 			if(kid){
 				children.erase(std::remove(children.begin(), children.end(), kid));
 
-
-				std::vector<shared_ptr<Type::VarWrapper>> args = std::vector<shared_ptr<Type::VarWrapper>>({make_shared<Type::VarWrapper>(kid)});
-				ChildRemoved->Fire(eng, args);
-				fireDescendantRemoving(args);
+				if(ChildRemoved->hasListeners() || descendantListeners > 0){
+					std::vector<shared_ptr<Type::VarWrapper>> args = std::vector<shared_ptr<Type::VarWrapper>>({make_shared<Type::VarWrapper>(kid)});
+					ChildRemoved->Fire(eng, args);
+					fireDescendantRemoving(args);
+				}
 			}
 		}
 
@@ -910,9 +1137,11 @@ namespace OB{
 			if(kid){
 				children.push_back(kid);
 
-				std::vector<shared_ptr<Type::VarWrapper>> args = std::vector<shared_ptr<Type::VarWrapper>>({make_shared<Type::VarWrapper>(kid)});
-				ChildAdded->Fire(eng, args);
-				fireDescendantAdded(args);
+				if(ChildAdded->hasListeners() || descendantListeners > 0){
+					std::vector<shared_ptr<Type::VarWrapper>> args = std::vector<shared_ptr<Type::VarWrapper>>({make_shared<Type::VarWrapper>(kid)});
+					ChildAdded->Fire(eng, args);
+					fireDescendantAdded(args);
+				}
 			}
 		}
 
@@ -951,6 +1180,7 @@ namespace OB{
 				{"FindFirstChildWhichIsA", lua_FindFirstChildWhichIsA},
 				{"GetChildren", lua_GetChildren},
 				{"GetFullName", lua_GetFullName},
+				{"GetPropertyChangedSignal", lua_GetPropertyChangedSignal},
 				{"IsA", lua_IsA},
 				{"IsAncestorOf", lua_IsAncestorOf},
 				{"IsDescendantOf", lua_IsDescendantOf},
@@ -1029,87 +1259,66 @@ namespace OB{
 		}
 
 		int Instance::lua_newindex(lua_State* L){
-			shared_ptr<Instance> inst = checkInstance(L, 1, false);
-			if(!inst){
-				return 0;
-			}
-
 			const char* name = luaL_checkstring(L, 2);
-			lua_getmetatable(L, 1);// -3
-			lua_getfield(L, -1, "__propertysetters");// -2
-			lua_getfield(L, -1, name);// -1
-			if (lua_iscfunction(L, -1)){
-				lua_remove(L, -2);
-				lua_remove(L, -2);
 
-				lua_pushvalue(L, 1);
-				lua_pushvalue(L, 3);
-				lua_call(L, 2, 0);
+			lua_pushvalue(L, 2);
+			if(lua_rawget(L, lua_upvalueindex(1)) == LUA_TFUNCTION){
+				lua_CFunction fnc = lua_tocfunction(L, -1);
+				lua_pop(L, 1);
 
-				return 0;
-			}else{
-				lua_pop(L, 3);
+				if(fnc){
+					// Setters take the Instance and the new value
+					lua_remove(L, 2);
+					fnc(L);
 
-				return luaL_error(L, "attempt to index '%s' (a nil value)", name);
+					return 0;
+				}
+			}else{
+				lua_pop(L, 1);
 			}
 
-			return 0;
-		}
-
-		int Instance::lua_index(lua_State* L){
 			shared_ptr<Instance> inst = checkInstance(L, 1, false);
 			if(!inst){
 				return 0;
 			}
 
-			const char* name = luaL_checkstring(L, 2);
+			return luaL_error(L, "attempt to index '%s' (a nil value)", name);
+		}
 
-			lua_getmetatable(L, 1);// -3
-			lua_getfield(L, -1, "__propertygetters");// -2
-			lua_getfield(L, -1, name);// -1
-			if(lua_iscfunction(L, -1)){
-				lua_remove(L, -2);
-				lua_remove(L, -2);
+		int Instance::lua_index(lua_State* L){
+			const char* name = luaL_checkstring(L, 2);
 
-				lua_pushvalue(L, 1);
-				lua_call(L, 1, 1);
-				return 1;
-			}else{
-				lua_pop(L, 2);
-				// Check methods
-				lua_getfield(L, -1, "__methods");// -2
-				lua_getfield(L, -1, name);// -1
-				if(lua_iscfunction(L, -1)){
-					lua_remove(L, -2);
-					lua_remove(L, -3);
+			lua_pushvalue(L, 2);
+			lua_rawget(L, lua_upvalueindex(1));
+			struct _ob_lua_index_entry* entry = (struct _ob_lua_index_entry*)lua_touserdata(L, -1);
+			lua_pop(L, 1);
 
-					return 1;
-				}else{
-					lua_pop(L, 2);
-					// Check events
-					lua_getfield(L, -1, "__events");// -2
-					lua_getfield(L, -1, name);// -1
-					if(lua_iscfunction(L, -1)){
-						lua_remove(L, -2);
-						lua_remove(L, -3);
-
-						lua_pushvalue(L, 1);
-						lua_call(L, 1, 1);
+			if(entry){
+				switch(entry->kind){
+					case OB_LUA_INDEX_METHOD: {
+						lua_pushcfunction(L, entry->fnc);
 						return 1;
-					}else{
-						lua_pop(L, 3);
-
-						shared_ptr<Instance> kiddie = inst->FindFirstChild(name, false);
-						if(kiddie){
-							return kiddie->wrap_lua(L);
-						}
-
-						return luaL_error(L, "attempt to index '%s' (a nil value)", name);
+					}
+					case OB_LUA_INDEX_GETTER:
+					case OB_LUA_INDEX_EVENT: {
+						// Getters and event wrappers only take the Instance
+						lua_settop(L, 1);
+						return entry->fnc(L);
 					}
 				}
 			}
 
-			return 0;
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+			if(!inst){
+				return 0;
+			}
+
+			shared_ptr<Instance> kiddie = inst->FindFirstChild(name, false);
+			if(kiddie){
+				return kiddie->wrap_lua(L);
+			}
+
+			return luaL_error(L, "attempt to index '%s' (a nil value)", name);
 		}
 
 		int Instance::lua_eq(lua_State* L){
@@ -1482,6 +1691,22 @@ namespace OB{
 			return luaL_error(L, COLONERR, "GetFullName");
 		}
 
+		int Instance::lua_GetPropertyChangedSignal(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(inst){
+				const char* property = luaL_checkstring(L, 2);
+
+				shared_ptr<Type::Event> evt = inst->GetPropertyChangedSignal(property);
+				if(!evt){
+					return luaL_error(L, "%s is not a valid property name.", property);
+				}
+				return evt->wrap_lua(L);
+			}
+
+			return luaL_error(L, COLONERR, "GetPropertyChangedSignal");
+		}
+
 		int Instance::lua_IsA(lua_State* L){
 			shared_ptr<Instance> inst = checkInstance(L, 1, false);
 
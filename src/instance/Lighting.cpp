@@ -136,7 +136,7 @@ namespace OB{
 
 		void Lighting::setSkyColor(shared_ptr<Type::Color3> skyColor){
 			if(skyColor == NULL){
-				shared_ptr<Type::Color3> col3 = make_shared<Type::Color3>();
+				shared_ptr<Type::Color3> col3 = make_pooled<Type::Color3>();
 				if(!col3->equals(SkyColor)){
 					SkyColor = col3;
 
@@ -233,7 +233,7 @@ namespace OB{
 
 		void Lighting::setFogColor(shared_ptr<Type::Color3> fogColor){
 			if(fogColor == NULL){
-				shared_ptr<Type::Color3> col3 = make_shared<Type::Color3>();
+				shared_ptr<Type::Color3> col3 = make_pooled<Type::Color3>();
 				if(!col3->equals(FogColor)){
 					FogColor = col3;
 
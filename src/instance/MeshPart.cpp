@@ -71,7 +71,8 @@ namespace OB{
 				if(!Mesh.empty()){
 					shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 					if(assetLoc){
-						if(assetLoc->hasAsset(Mesh)){
+						shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
+						if(assetLoc->requireAsset(Mesh, sharedThis, Enum::AssetPriority::Near)){
 							updateMesh();
 							shared_ptr<Instance> parInst = Parent;
 							if(parInst){
@@ -82,10 +83,6 @@ namespace OB{
 									}
 								}
 							}
-						}else{
-							shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
-							assetLoc->addWaitingInstance(sharedThis);
-							assetLoc->loadAsset(Mesh);
 						}
 					}
 				}
@@ -104,6 +101,11 @@ namespace OB{
 			shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 			if(assetLoc){
 				shared_ptr<AssetResponse> resp = assetLoc->getAsset(Mesh);
+				if(!resp){
+					// Evicted since it was requested, load it again
+					shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
+					assetLoc->requireAsset(Mesh, sharedThis, Enum::AssetPriority::Near);
+				}
 				if(resp){
 					irr::io::IReadFile* irf = resp->toIReadFile();
 					if(irf){
@@ -38,6 +38,7 @@ namespace OB{
 			netId = OB_NETID_NOT_REPLICATED;
 
 			Archivable = false;
+			tickable = true;
 
 			server_peer = NULL;
 		}
@@ -69,8 +70,6 @@ namespace OB{
 					}
 				}
 			}
-
-			tickChildren();
 		}
 
 		void NetworkClient::Connect(std::string server, int serverPort, int clientPort){
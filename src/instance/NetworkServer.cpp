@@ -37,6 +37,7 @@ namespace OB{
 			netId = OB_NETID_NOT_REPLICATED;
 
 			Archivable = false;
+			tickable = true;
 
 			Port = -1;
 		}
@@ -54,8 +55,6 @@ namespace OB{
 					processEvent(evt);
 				}
 			}
-
-			tickChildren();
 		}
 
 		int NetworkServer::getPort(){
@@ -29,10 +29,14 @@ namespace OB{
 			registerLuaClass(eng, LuaClassName, register_lua_metamethods, register_lua_methods, register_lua_property_getters, register_lua_property_setters, register_lua_events);
 		}
 
+#if HAVE_BULLET
+		std::map<Part::BoxShapeKey, weak_ptr<btBoxShape>> Part::boxShapeCache;
+#endif
+
 		Part::Part(OBEngine* eng) : BasePart(eng){
 			Name = ClassName;
 
-			Size = make_shared<Type::Vector3>(1, 1, 1);
+			Size = make_pooled<Type::Vector3>(1, 1, 1);
 		}
 
 		Part::~Part(){}
@@ -56,7 +60,7 @@ namespace OB{
 
 		void Part::setSize(shared_ptr<Type::Vector3> size){
 			if(size == NULL){
-				shared_ptr<Type::Vector3> vec3 = make_shared<Type::Vector3>(0, 0, 0);
+				shared_ptr<Type::Vector3> vec3 = make_pooled<Type::Vector3>(0, 0, 0);
 				if(!vec3->equals(Size)){
 					Size = vec3;
 
@@ -91,8 +95,47 @@ namespace OB{
 				}
 			}
 #endif
+
+#if HAVE_BULLET
+			updatePhysicsShape();
+#endif
 		}
 
+#if HAVE_BULLET
+		shared_ptr<btCollisionShape> Part::getCollisionShape(){
+			BoxShapeKey key(Size->getX(), Size->getY(), Size->getZ());
+
+			std::map<BoxShapeKey, weak_ptr<btBoxShape>>::iterator it = boxShapeCache.find(key);
+			if(it != boxShapeCache.end()){
+				if(shared_ptr<btBoxShape> shape = it->second.lock()){
+					return shape;
+				}
+			}
+
+			btVector3 halfExtents(std::get<0>(key) / 2, std::get<1>(key) / 2, std::get<2>(key) / 2);
+
+			shared_ptr<btBoxShape> shape(new btBoxShape(halfExtents), [key](btBoxShape* shape){
+				std::map<BoxShapeKey, weak_ptr<btBoxShape>>::iterator it = boxShapeCache.find(key);
+				if(it != boxShapeCache.end() && it->second.expired()){
+					boxShapeCache.erase(it);
+				}
+				delete shape;
+			});
+			boxShapeCache[key] = shape;
+
+			return shape;
+		}
+
+		double Part::getMass(){
+			double mass = Size->getX() * Size->getY() * Size->getZ();
+			if(mass <= 0){
+				// Flat parts still need some mass to simulate
+				mass = 0.001;
+			}
+			return mass;
+		}
+#endif
+
 		void Part::updateColor(){
 #if HAVE_IRRLICHT
 			if(irrNode){
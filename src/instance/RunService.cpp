@@ -33,6 +33,7 @@ namespace OB{
 			netId = OB_NETID_NOT_REPLICATED;
 
 			Archivable = false;
+			tickable = true;
 
 			wasRunning = false;
 			running = false;
@@ -95,8 +96,6 @@ namespace OB{
 
 		void RunService::tick(){
 			Stepped->Fire(eng);
-
-			tickChildren();
 		}
 
 		std::string RunService::fixedSerializedID(){
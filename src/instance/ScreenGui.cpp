@@ -53,7 +53,7 @@ namespace OB{
 					return pgo->getAbsolutePosition();
 				}
 			}
-			return make_shared<Type::Vector2>(0, 0);
+			return make_pooled<Type::Vector2>(0, 0);
 		}
 
 		shared_ptr<Type::Vector2> ScreenGui::getAbsoluteSize(){
@@ -62,7 +62,7 @@ namespace OB{
 					return pgo->getAbsoluteSize();
 				}
 			}
-			return make_shared<Type::Vector2>(0, 0);
+			return make_pooled<Type::Vector2>(0, 0);
 		}
 
 		bool ScreenGui::isEnabled(){
@@ -63,7 +63,10 @@ namespace OB{
 					aL->loadAssetSync(LinkedSource);
 				}
 				shared_ptr<AssetResponse> aR = aL->getAsset(LinkedSource);
-				return std::string(aR->getData());
+				if(!aR || !aR->getData()){
+					return "";
+				}
+				return std::string(aR->getData(), aR->getSize());
 			}else{
 				return Source;
 			}
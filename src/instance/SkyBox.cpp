@@ -65,7 +65,23 @@ namespace OB{
 #endif
 		}
 
-	    SkyBox::~SkyBox(){}
+		SkyBox::~SkyBox(){
+#if HAVE_IRRLICHT
+			if(irrNode){
+				irrNode->remove();
+				irrNode = NULL;
+			}
+
+			dropTexture(top_tex);
+			dropTexture(bottom_tex);
+			dropTexture(left_tex);
+			dropTexture(right_tex);
+			dropTexture(front_tex);
+			dropTexture(back_tex);
+
+			releaseStaleTextures();
+#endif
+		}
 
 		shared_ptr<Instance> SkyBox::cloneImpl(){
 		    shared_ptr<SkyBox> sb = make_shared<SkyBox>(eng);
@@ -93,24 +109,20 @@ namespace OB{
 				if(!Top.empty()){
 					shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 					if(assetLoc){
-						if(assetLoc->hasAsset(Top)){
-							top_tex = NULL;
+						dropTexture(top_tex);
+
+						shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
+						if(assetLoc->requireAsset(Top, sharedThis, Enum::AssetPriority::Far)){
 							top_loading = false;
 
-						    skybox_needs_updating = true;
+							skybox_needs_updating = true;
 							updateSkyBox();
 						}else{
-							top_tex = NULL;
-
 							top_loading = true;
-
-							shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
-							assetLoc->addWaitingInstance(sharedThis);
-							assetLoc->loadAsset(Top);
 						}
 					}
 				}else{
-					top_tex = NULL;
+					dropTexture(top_tex);
 
 					updateSkyBox();
 				}
@@ -133,24 +145,20 @@ namespace OB{
 				if(!Bottom.empty()){
 					shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 					if(assetLoc){
-						if(assetLoc->hasAsset(Bottom)){
-						    bottom_tex = NULL;
+						dropTexture(bottom_tex);
+
+						shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
+						if(assetLoc->requireAsset(Bottom, sharedThis, Enum::AssetPriority::Far)){
 							bottom_loading = false;
 
-						    skybox_needs_updating = true;
+							skybox_needs_updating = true;
 							updateSkyBox();
 						}else{
-						    bottom_tex = NULL;
-
 							bottom_loading = true;
-
-							shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
-							assetLoc->addWaitingInstance(sharedThis);
-							assetLoc->loadAsset(Bottom);
 						}
 					}
 				}else{
-				    bottom_tex = NULL;
+				    dropTexture(bottom_tex);
 
 					updateSkyBox();
 				}
@@ -173,24 +181,20 @@ namespace OB{
 				if(!Left.empty()){
 					shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 					if(assetLoc){
-						if(assetLoc->hasAsset(Left)){
-						    left_tex = NULL;
+						dropTexture(left_tex);
+
+						shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
+						if(assetLoc->requireAsset(Left, sharedThis, Enum::AssetPriority::Far)){
 							left_loading = false;
 
-						    skybox_needs_updating = true;
+							skybox_needs_updating = true;
 							updateSkyBox();
 						}else{
-							left_tex = NULL;
-
 							left_loading = true;
-
-							shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
-							assetLoc->addWaitingInstance(sharedThis);
-							assetLoc->loadAsset(Left);
 						}
 					}
 				}else{
-				    left_tex = NULL;
+				    dropTexture(left_tex);
 
 					updateSkyBox();
 				}
@@ -213,24 +217,20 @@ namespace OB{
 				if(!Right.empty()){
 					shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 					if(assetLoc){
-						if(assetLoc->hasAsset(Right)){
-						    right_tex = NULL;
+						dropTexture(right_tex);
+
+						shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
+						if(assetLoc->requireAsset(Right, sharedThis, Enum::AssetPriority::Far)){
 							right_loading = false;
 
-						    skybox_needs_updating = true;
+							skybox_needs_updating = true;
 							updateSkyBox();
 						}else{
-							right_tex = NULL;
-
 							right_loading = true;
-
-							shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
-							assetLoc->addWaitingInstance(sharedThis);
-							assetLoc->loadAsset(Right);
 						}
 					}
 				}else{
-				    right_tex = NULL;
+				    dropTexture(right_tex);
 
 					updateSkyBox();
 				}
@@ -253,24 +253,20 @@ namespace OB{
 				if(!Front.empty()){
 					shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 					if(assetLoc){
-						if(assetLoc->hasAsset(Front)){
-						    front_tex = NULL;
+						dropTexture(front_tex);
+
+						shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
+						if(assetLoc->requireAsset(Front, sharedThis, Enum::AssetPriority::Far)){
 							front_loading = false;
 
-						    skybox_needs_updating = true;
+							skybox_needs_updating = true;
 							updateSkyBox();
 						}else{
-							front_tex = NULL;
-
 							front_loading = true;
-
-							shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
-							assetLoc->addWaitingInstance(sharedThis);
-							assetLoc->loadAsset(Front);
 						}
 					}
 				}else{
-				    front_tex = NULL;
+				    dropTexture(front_tex);
 
 					updateSkyBox();
 				}
@@ -293,24 +289,20 @@ namespace OB{
 				if(!Back.empty()){
 					shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 					if(assetLoc){
-						if(assetLoc->hasAsset(Back)){
-						    back_tex = NULL;
+						dropTexture(back_tex);
+
+						shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
+						if(assetLoc->requireAsset(Back, sharedThis, Enum::AssetPriority::Far)){
 							back_loading = false;
 
-						    skybox_needs_updating = true;
+							skybox_needs_updating = true;
 							updateSkyBox();
 						}else{
-							back_tex = NULL;
-
 							back_loading = true;
-
-							shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
-							assetLoc->addWaitingInstance(sharedThis);
-							assetLoc->loadAsset(Back);
 						}
 					}
 				}else{
-				    back_tex = NULL;
+				    dropTexture(back_tex);
 
 					updateSkyBox();
 				}
@@ -341,98 +333,55 @@ namespace OB{
 #endif
 		}
 
+#if HAVE_IRRLICHT
+		static void _ob_skybox_load_texture(shared_ptr<OBRenderUtils> renderUtils, shared_ptr<AssetLocator> assetLoc, shared_ptr<Instance> inst, std::string url, irr::video::ITexture*& tex, bool& loading, bool& didLoadTexture, bool& pending){
+			if(tex || loading || url.empty()){
+				return;
+			}
+
+			bool texPending = false;
+			tex = renderUtils->acquireTexture(url, OB_TEXTURE_MIPMAPS, texPending);
+
+			if(tex){
+				didLoadTexture = true;
+			}
+			if(texPending){
+				pending = true;
+			}
+
+			// Evicted before it was decoded, wait for it to be loaded again
+			if(!tex && !texPending && assetLoc){
+				if(!assetLoc->requireAsset(url, inst, Enum::AssetPriority::Far)){
+					loading = true;
+				}
+			}
+		}
+#endif
+
 		void SkyBox::preRender(){
 #if HAVE_IRRLICHT
 			if(skybox_needs_updating){
 				skybox_needs_updating = false;
 
 				bool didLoadTexture = false;
+				bool pending = false;
 
-				shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
-				if(assetLoc){
-					irr::IrrlichtDevice* irrDev = eng->getIrrlichtDevice();
-					if(irrDev){
-						irr::video::IVideoDriver* videoDriver = irrDev->getVideoDriver();
-						if(videoDriver){
-							if(!top_tex){
-								if(!Top.empty()){
-									shared_ptr<AssetResponse> resp = assetLoc->getAsset(Top);
-									if(resp){
-										irr::io::IReadFile* irf = resp->toIReadFile();
-										if(irf){
-											top_tex = videoDriver->getTexture(irf);
-											didLoadTexture = true;
-										}
-									}
-								}
-							}
-
-							if(!bottom_tex){
-								if(!Bottom.empty()){
-									shared_ptr<AssetResponse> resp = assetLoc->getAsset(Bottom);
-									if(resp){
-										irr::io::IReadFile* irf = resp->toIReadFile();
-										if(irf){
-											bottom_tex = videoDriver->getTexture(irf);
-											didLoadTexture = true;
-										}
-									}
-								}
-							}
-
-							if(!left_tex){
-								if(!Left.empty()){
-									shared_ptr<AssetResponse> resp = assetLoc->getAsset(Left);
-									if(resp){
-										irr::io::IReadFile* irf = resp->toIReadFile();
-										if(irf){
-											left_tex = videoDriver->getTexture(irf);
-											didLoadTexture = true;
-										}
-									}
-								}
-							}
-
-							if(!right_tex){
-								if(!Right.empty()){
-									shared_ptr<AssetResponse> resp = assetLoc->getAsset(Right);
-									if(resp){
-										irr::io::IReadFile* irf = resp->toIReadFile();
-										if(irf){
-											right_tex = videoDriver->getTexture(irf);
-											didLoadTexture = true;
-										}
-									}
-								}
-							}
-
-							if(!front_tex){
-								if(!Front.empty()){
-									shared_ptr<AssetResponse> resp = assetLoc->getAsset(Front);
-									if(resp){
-										irr::io::IReadFile* irf = resp->toIReadFile();
-										if(irf){
-											front_tex = videoDriver->getTexture(irf);
-											didLoadTexture = true;
-										}
-									}
-								}
-							}
-
-							if(!back_tex){
-								if(!Back.empty()){
-									shared_ptr<AssetResponse> resp = assetLoc->getAsset(Back);
-									if(resp){
-										irr::io::IReadFile* irf = resp->toIReadFile();
-										if(irf){
-											back_tex = videoDriver->getTexture(irf);
-											didLoadTexture = true;
-										}
-									}
-								}
-							}
-						}
-					}
+				shared_ptr<OBRenderUtils> renderUtils = eng->getRenderUtils();
+				if(renderUtils){
+					shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
+					shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
+
+					_ob_skybox_load_texture(renderUtils, assetLoc, sharedThis, Top, top_tex, top_loading, didLoadTexture, pending);
+					_ob_skybox_load_texture(renderUtils, assetLoc, sharedThis, Bottom, bottom_tex, bottom_loading, didLoadTexture, pending);
+					_ob_skybox_load_texture(renderUtils, assetLoc, sharedThis, Left, left_tex, left_loading, didLoadTexture, pending);
+					_ob_skybox_load_texture(renderUtils, assetLoc, sharedThis, Right, right_tex, right_loading, didLoadTexture, pending);
+					_ob_skybox_load_texture(renderUtils, assetLoc, sharedThis, Front, front_tex, front_loading, didLoadTexture, pending);
+					_ob_skybox_load_texture(renderUtils, assetLoc, sharedThis, Back, back_tex, back_loading, didLoadTexture, pending);
+				}
+
+				// Some faces are still decoding, try again next frame
+				if(pending){
+					skybox_needs_updating = true;
 				}
 
 				if(didLoadTexture){
@@ -463,43 +412,64 @@ namespace OB{
 					irrNode = NULL;
 				}
 			}
+
+			// Nothing uses the old textures anymore
+			releaseStaleTextures();
+		}
+
+		void SkyBox::dropTexture(irr::video::ITexture*& tex){
+			if(tex){
+				// The scene node may still be drawing with it
+				stale_tex.push_back(tex);
+				tex = NULL;
+			}
+		}
+
+		void SkyBox::releaseStaleTextures(){
+			shared_ptr<OBRenderUtils> renderUtils = eng->getRenderUtils();
+			if(renderUtils){
+				for(std::vector<irr::video::ITexture*>::size_type i = 0; i < stale_tex.size(); i++){
+					renderUtils->releaseTexture(stale_tex[i]);
+				}
+			}
+			stale_tex.clear();
 		}
 
 		bool SkyBox::assetLoaded(std::string res){
 			bool assetsChanged = false;
 
 			if(top_loading && res == Top){
-				top_tex = NULL;
+				dropTexture(top_tex);
 				top_loading = false;
 
 				assetsChanged = true;
 			}
 			if(bottom_loading && res == Bottom){
-			    bottom_tex = NULL;
+			    dropTexture(bottom_tex);
 			    bottom_loading = false;
 
 				assetsChanged = true;
 			}
 			if(left_loading && res == Left){
-			    left_tex = NULL;
+			    dropTexture(left_tex);
 			    left_loading = false;
 
 				assetsChanged = true;
 			}
 			if(right_loading && res == Right){
-			    right_tex = NULL;
+			    dropTexture(right_tex);
 			    right_loading = false;
 
 				assetsChanged = true;
 			}
 			if(front_loading && res == Front){
-			    front_tex = NULL;
+			    dropTexture(front_tex);
 				front_loading = false;
 
 				assetsChanged = true;
 			}
 			if(back_loading && res == Back){
-				back_tex = NULL;
+				dropTexture(back_tex);
 			    back_loading = false;
 
 				assetsChanged = true;
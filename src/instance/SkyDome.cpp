@@ -48,7 +48,17 @@ namespace OB{
 #endif
 		}
 
-		SkyDome::~SkyDome(){}
+		SkyDome::~SkyDome(){
+#if HAVE_IRRLICHT
+			if(irrNode){
+				irrNode->remove();
+				irrNode = NULL;
+			}
+
+			dropTexture(dome_tex);
+			releaseStaleTextures();
+#endif
+		}
 
 		shared_ptr<Instance> SkyDome::cloneImpl(){
 			shared_ptr<SkyDome> sd = make_shared<SkyDome>(eng);
@@ -72,20 +82,15 @@ namespace OB{
 				if(!Dome.empty()){
 					shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
 					if(assetLoc){
-						if(assetLoc->hasAsset(Dome)){
-							dome_tex = NULL;
+						dropTexture(dome_tex);
 
+						shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
+						if(assetLoc->requireAsset(Dome, sharedThis, Enum::AssetPriority::Far)){
 							skydome_needs_updating = true;
-						}else{
-							dome_tex = NULL;
-
-							shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
-							assetLoc->addWaitingInstance(sharedThis);
-							assetLoc->loadAsset(Dome);
 						}
 					}
 				}else{
-					dome_tex = NULL;
+					dropTexture(dome_tex);
 
 					updateSkyDome();
 				}
@@ -122,22 +127,28 @@ namespace OB{
 			if(skydome_needs_updating){
 				skydome_needs_updating = false;
 
-				shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
-				if(assetLoc){
-					irr::IrrlichtDevice* irrDev = eng->getIrrlichtDevice();
-					if(irrDev){
-						irr::video::IVideoDriver* videoDriver = irrDev->getVideoDriver();
-						if(videoDriver){
-							if(!dome_tex){
-								shared_ptr<AssetResponse> resp = assetLoc->getAsset(Dome);
-								if(resp){
-									irr::io::IReadFile* irf = resp->toIReadFile();
-									if(irf){
-										dome_tex = videoDriver->getTexture(irf);
-
-										updateSkyDome();
-									}
-								}
+				shared_ptr<OBRenderUtils> renderUtils = eng->getRenderUtils();
+				if(renderUtils){
+					if(!dome_tex){
+						bool pending = false;
+						dome_tex = renderUtils->acquireTexture(Dome, OB_TEXTURE_MIPMAPS, pending);
+
+						if(dome_tex){
+							updateSkyDome();
+						}
+
+						// Still decoding, try again next frame
+						if(pending){
+							skydome_needs_updating = true;
+						}
+
+						// Evicted before it was decoded, assetLoaded
+						// picks it up again once it's reloaded
+						if(!dome_tex && !pending && !Dome.empty()){
+							shared_ptr<AssetLocator> assetLoc = eng->getAssetLocator();
+							if(assetLoc){
+								shared_ptr<Instance> sharedThis = std::enable_shared_from_this<OB::Instance::Instance>::shared_from_this();
+								assetLoc->requireAsset(Dome, sharedThis, Enum::AssetPriority::Far);
 							}
 						}
 					}
@@ -169,6 +180,27 @@ namespace OB{
 					irrNode = NULL;
 				}
 			}
+
+			// Nothing uses the old textures anymore
+			releaseStaleTextures();
+		}
+
+		void SkyDome::dropTexture(irr::video::ITexture*& tex){
+			if(tex){
+				// The scene node may still be drawing with it
+				stale_tex.push_back(tex);
+				tex = NULL;
+			}
+		}
+
+		void SkyDome::releaseStaleTextures(){
+			shared_ptr<OBRenderUtils> renderUtils = eng->getRenderUtils();
+			if(renderUtils){
+				for(std::vector<irr::video::ITexture*>::size_type i = 0; i < stale_tex.size(); i++){
+					renderUtils->releaseTexture(stale_tex[i]);
+				}
+			}
+			stale_tex.clear();
 		}
 
 		bool SkyDome::assetLoaded(std::string res){
@@ -177,7 +209,7 @@ namespace OB{
 			}
 
 			if(res == Dome){
-				dome_tex = NULL;
+				dropTexture(dome_tex);
 
 				skydome_needs_updating = true;
 
@@ -63,11 +63,11 @@ namespace OB{
 		}
 
 		shared_ptr<Type::Vector2>  UserInputService::GetMouseDelta(){
-			return make_shared<Type::Vector2>(mouseDeltaX, mouseDeltaY);
+			return make_pooled<Type::Vector2>(mouseDeltaX, mouseDeltaY);
 		}
 
 		shared_ptr<Type::Vector2>  UserInputService::GetMouseLocation(){
-			return make_shared<Type::Vector2>(mouseX, mouseY);
+			return make_pooled<Type::Vector2>(mouseX, mouseY);
 		}
 
 		shared_ptr<Instance> UserInputService::cloneImpl(){
@@ -167,7 +167,7 @@ namespace OB{
 				int deltaX = x - mouseX;
 				int deltaY = y - mouseY;
 
-				imme->setDelta(make_shared<Type::Vector2>(deltaX, deltaY));
+				imme->setDelta(make_pooled<Type::Vector2>(deltaX, deltaY));
 			}
 			mouseX = x;
 			mouseY = y;
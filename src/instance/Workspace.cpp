@@ -22,10 +22,22 @@
 #include "utility.h"
 
 #include "instance/Camera.h"
+#include "instance/BasePart.h"
 
 #include "instance/NetworkReplicator.h"
 #include "instance/NetworkServer.h"
 
+#include "OBEngine.h"
+#include "OBException.h"
+
+#include <set>
+
+// Ray batches smaller than this aren't worth splitting up
+#define OB_RAYCAST_GRAIN 16
+
+// Default maxParts of the Lua region queries
+#define OB_QUERY_DEFAULT_MAX_PARTS 20
+
 namespace OB{
 	namespace Instance{
 		DEFINE_CLASS(Workspace, false, isDataModel, Model){
@@ -36,17 +48,31 @@ namespace OB{
 			Name = ClassName;
 			netId = OB_NETID_WORKSPACE;
 
-			Gravity = make_shared<Type::Vector3>(0, -196.2, 0);
+			Gravity = make_pooled<Type::Vector3>(0, -196.2, 0);
 			FallenPartsDestroyHeight = -1000;
 			DestroyFallenParts = true;
 
 #if HAVE_BULLET
 			broadphase = new btDbvtBroadphase();
 			collisionConfiguration = new btDefaultCollisionConfiguration();
+#if HAVE_BULLET_MT
+			// Islands are solved in parallel, one solver per thread
+			dispatcher = new btCollisionDispatcherMt(collisionConfiguration);
+			btConstraintSolverPoolMt* solverPool = new btConstraintSolverPoolMt(BT_MAX_THREAD_COUNT);
+			solver = solverPool;
+			dynamicsWorld = new btDiscreteDynamicsWorldMt(dispatcher, broadphase, solverPool, NULL, collisionConfiguration);
+#else
 			dispatcher = new btCollisionDispatcher(collisionConfiguration);
 			solver = new btSequentialImpulseConstraintSolver();
 			dynamicsWorld = new btDiscreteDynamicsWorld(dispatcher, broadphase, solver, collisionConfiguration);
+#endif
 			updateGravity();
+
+			lastPhysicsTick = 0;
+			physicsAccumulator = 0;
+			physicsStepTime = 0;
+
+			tickable = true;
 #endif
 
 #if HAVE_IRRLICHT
@@ -62,6 +88,16 @@ namespace OB{
 
 		Workspace::~Workspace(){
 #if HAVE_BULLET
+			btCollisionObjectArray& objs = dynamicsWorld->getCollisionObjectArray();
+			while(objs.size() > 0){
+				BasePart* part = static_cast<BasePart*>(objs[objs.size() - 1]->getUserPointer());
+				if(part){
+					part->leavePhysicsWorld();
+				}else{
+					dynamicsWorld->removeCollisionObject(objs[objs.size() - 1]);
+				}
+			}
+
 			delete dynamicsWorld;
 			delete solver;
 			delete dispatcher;
@@ -82,6 +118,14 @@ namespace OB{
 			return runTime;
 		}
 
+		double Workspace::getPhysicsStepTime(){
+#if HAVE_BULLET
+			return physicsStepTime;
+#else
+			return 0;
+#endif
+		}
+
 		shared_ptr<Instance> Workspace::getCurrentCamera(){
 			return CurrentCamera;
 		}
@@ -102,7 +146,7 @@ namespace OB{
 
 		void Workspace::setGravity(shared_ptr<Type::Vector3> gravity){
 			if(gravity == NULL){
-				shared_ptr<Type::Vector3> vec3 = make_shared<Type::Vector3>(0, 0, 0);
+				shared_ptr<Type::Vector3> vec3 = make_pooled<Type::Vector3>(0, 0, 0);
 				if(!vec3->equals(Gravity)){
 					Gravity = vec3;
 
@@ -153,6 +197,367 @@ namespace OB{
 #endif
 		}
 
+#if HAVE_BULLET
+		btDiscreteDynamicsWorld* Workspace::getDynamicsWorld(){
+			return dynamicsWorld;
+		}
+
+		void Workspace::stepPhysics(){
+			ob_uint64 curTime = currentTimeMillis();
+			if(lastPhysicsTick == 0){
+				lastPhysicsTick = curTime;
+				return;
+			}
+
+			physicsAccumulator += (curTime - lastPhysicsTick) / 1000.0;
+			lastPhysicsTick = curTime;
+
+			ob_uint64 stepStart = currentTimeMicros();
+
+			int steps = 0;
+			while(physicsAccumulator >= OB_PHYSICS_STEP && steps < OB_PHYSICS_MAX_STEPS){
+				dynamicsWorld->stepSimulation(OB_PHYSICS_STEP, 0);
+				physicsAccumulator -= OB_PHYSICS_STEP;
+				steps++;
+			}
+
+			if(steps == 0){
+				return;
+			}
+
+			physicsStepTime = (currentTimeMicros() - stepStart) / 1000.0 / steps;
+			if(steps == OB_PHYSICS_MAX_STEPS){
+				// Don't try to catch up after a long stall
+				physicsAccumulator = 0;
+			}
+
+			/*
+			 * Only bodies the simulation moved are active, anchored
+			 * parts and sleeping bodies are skipped. Parts are
+			 * collected first, because writing back a transform
+			 * fires Changed, which may add or remove bodies.
+			 */
+			std::vector<shared_ptr<BasePart>> moved;
+			std::vector<shared_ptr<BasePart>> fallen;
+
+			btCollisionObjectArray& objs = dynamicsWorld->getCollisionObjectArray();
+			for(int i = 0; i < objs.size(); i++){
+				btCollisionObject* obj = objs[i];
+				if(obj->isStaticOrKinematicObject() || !obj->isActive()){
+					continue;
+				}
+
+				BasePart* part = static_cast<BasePart*>(obj->getUserPointer());
+				if(!part){
+					continue;
+				}
+
+				shared_ptr<BasePart> sPart = dynamic_pointer_cast<BasePart>(part->shared_from_this());
+				if(DestroyFallenParts && obj->getWorldTransform().getOrigin().y() < FallenPartsDestroyHeight){
+					fallen.push_back(sPart);
+				}else{
+					moved.push_back(sPart);
+				}
+			}
+
+			for(std::vector<shared_ptr<BasePart>>::size_type i = 0; i < moved.size(); i++){
+				moved[i]->physicsMoved();
+			}
+
+			for(std::vector<shared_ptr<BasePart>>::size_type i = 0; i < fallen.size(); i++){
+				if(fallen[i]->getRigidBody()){
+					fallen[i]->Destroy();
+				}
+			}
+		}
+#endif
+
+#if HAVE_BULLET
+		static bool _ob_query_matches(const std::set<Instance*>& filterSet, bool include, BasePart* part){
+			if(filterSet.empty()){
+				return !include;
+			}
+
+			bool found = filterSet.count(part) > 0;
+
+			shared_ptr<Instance> anc = part->getParent();
+			while(anc && !found){
+				found = filterSet.count(anc.get()) > 0;
+				anc = anc->getParent();
+			}
+
+			return found == include;
+		}
+
+		static std::set<Instance*> _ob_query_set(const struct _ob_query_filter& filter){
+			std::set<Instance*> filterSet;
+			for(std::vector<shared_ptr<Instance>>::size_type i = 0; i < filter.instances.size(); i++){
+				if(filter.instances[i]){
+					filterSet.insert(filter.instances[i].get());
+				}
+			}
+			return filterSet;
+		}
+
+		static shared_ptr<BasePart> _ob_query_part(const btCollisionObject* obj){
+			BasePart* part = static_cast<BasePart*>(obj->getUserPointer());
+			if(!part){
+				return NULL;
+			}
+			return dynamic_pointer_cast<BasePart>(part->shared_from_this());
+		}
+
+		/*
+		 * Closest hit callback that skips filtered parts, so they
+		 * don't hide the parts behind them.
+		 */
+		class _ob_ray_callback: public btCollisionWorld::ClosestRayResultCallback{
+			public:
+				_ob_ray_callback(const btVector3& from, const btVector3& to, const std::set<Instance*>* filterSet, bool include) : btCollisionWorld::ClosestRayResultCallback(from, to){
+					this->filterSet = filterSet;
+					this->include = include;
+
+					m_collisionFilterGroup = OB_PHYS_GROUP_QUERY;
+					m_collisionFilterMask = OB_PHYS_GROUP_COLLIDE | OB_PHYS_GROUP_NOCOLLIDE;
+				}
+
+				virtual bool needsCollision(btBroadphaseProxy* proxy0) const{
+					if(!btCollisionWorld::ClosestRayResultCallback::needsCollision(proxy0)){
+						return false;
+					}
+
+					btCollisionObject* obj = static_cast<btCollisionObject*>(proxy0->m_clientObject);
+					BasePart* part = static_cast<BasePart*>(obj->getUserPointer());
+					return part && _ob_query_matches(*filterSet, include, part);
+				}
+
+			private:
+				const std::set<Instance*>* filterSet;
+				bool include;
+		};
+
+		class _ob_aabb_callback: public btBroadphaseAabbCallback{
+			public:
+				virtual bool process(const btBroadphaseProxy* proxy){
+					objs.push_back(static_cast<btCollisionObject*>(proxy->m_clientObject));
+					return true;
+				}
+
+				std::vector<btCollisionObject*> objs;
+		};
+
+		struct _ob_raycast_batch{
+			btDiscreteDynamicsWorld* world;
+			const std::vector<shared_ptr<Type::Vector3>>* origins;
+			const std::vector<shared_ptr<Type::Vector3>>* directions;
+			const std::set<Instance*>* filterSet;
+			bool include;
+			std::vector<struct _ob_raycast_result>* results;
+		};
+
+		static struct _ob_raycast_result _ob_raycast(btDiscreteDynamicsWorld* world, shared_ptr<Type::Vector3> origin, shared_ptr<Type::Vector3> direction, const std::set<Instance*>& filterSet, bool include){
+			struct _ob_raycast_result res;
+			if(!origin || !direction){
+				return res;
+			}
+
+			btVector3 from = origin->toBulletVector3();
+			btVector3 to = from + direction->toBulletVector3();
+
+			_ob_ray_callback cb(from, to, &filterSet, include);
+			world->rayTest(from, to, cb);
+
+			if(cb.hasHit()){
+				res.part = _ob_query_part(cb.m_collisionObject);
+				if(res.part){
+					res.position = make_pooled<Type::Vector3>(cb.m_hitPointWorld.x(), cb.m_hitPointWorld.y(), cb.m_hitPointWorld.z());
+					res.normal = make_pooled<Type::Vector3>(cb.m_hitNormalWorld.x(), cb.m_hitNormalWorld.y(), cb.m_hitNormalWorld.z());
+				}
+			}
+
+			return res;
+		}
+
+		static void _ob_raycast_chunk(void* ud, int iBegin, int iEnd){
+			struct _ob_raycast_batch* batch = (struct _ob_raycast_batch*)ud;
+
+			for(int i = iBegin; i < iEnd; i++){
+				(*batch->results)[i] = _ob_raycast(batch->world, (*batch->origins)[i], (*batch->directions)[i], *batch->filterSet, batch->include);
+			}
+		}
+
+		static bool _ob_sphere_touches(const btCollisionObject* obj, const btVector3& center, btScalar radius){
+			const btCollisionShape* shape = obj->getCollisionShape();
+			const btTransform& trans = obj->getWorldTransform();
+
+			btVector3 local;
+			btVector3 closest;
+
+			if(shape->getShapeType() == BOX_SHAPE_PROXYTYPE){
+				// Closest point on the oriented box
+				btVector3 half = static_cast<const btBoxShape*>(shape)->getHalfExtentsWithMargin();
+				local = trans.invXform(center);
+				closest = btVector3(btClamped(local.x(), -half.x(), half.x()), btClamped(local.y(), -half.y(), half.y()), btClamped(local.z(), -half.z(), half.z()));
+			}else{
+				btVector3 aabbMin, aabbMax;
+				shape->getAabb(trans, aabbMin, aabbMax);
+				local = center;
+				closest = btVector3(btClamped(local.x(), aabbMin.x(), aabbMax.x()), btClamped(local.y(), aabbMin.y(), aabbMax.y()), btClamped(local.z(), aabbMin.z(), aabbMax.z()));
+			}
+
+			return (local - closest).length2() <= radius * radius;
+		}
+#endif
+
+		struct _ob_raycast_result Workspace::Raycast(shared_ptr<Type::Vector3> origin, shared_ptr<Type::Vector3> direction, const struct _ob_query_filter& filter){
+#if HAVE_BULLET
+			std::set<Instance*> filterSet = _ob_query_set(filter);
+			return _ob_raycast(dynamicsWorld, origin, direction, filterSet, filter.include);
+#else
+			(void)origin;
+			(void)direction;
+			(void)filter;
+			return _ob_raycast_result();
+#endif
+		}
+
+		std::vector<struct _ob_raycast_result> Workspace::RaycastMany(const std::vector<shared_ptr<Type::Vector3>>& origins, const std::vector<shared_ptr<Type::Vector3>>& directions, const struct _ob_query_filter& filter){
+			std::vector<struct _ob_raycast_result> results;
+			if(origins.size() != directions.size()){
+				throw new OBException("RaycastMany needs as many directions as origins.");
+			}
+			results.resize(origins.size());
+
+#if HAVE_BULLET
+			std::set<Instance*> filterSet = _ob_query_set(filter);
+
+			struct _ob_raycast_batch batch;
+			batch.world = dynamicsWorld;
+			batch.origins = &origins;
+			batch.directions = &directions;
+			batch.filterSet = &filterSet;
+			batch.include = filter.include;
+			batch.results = &results;
+
+#if HAVE_BULLET_MT && BT_THREADSAFE
+			// The broadphase only gives each thread its own ray stack in thread safe builds
+			shared_ptr<WorkerPool> pool = eng->getWorkerPool();
+			if(pool){
+				pool->parallelFor(0, results.size(), OB_RAYCAST_GRAIN, _ob_raycast_chunk, &batch);
+				return results;
+			}
+#endif
+			_ob_raycast_chunk(&batch, 0, results.size());
+#else
+			(void)filter;
+#endif
+
+			return results;
+		}
+
+		std::vector<shared_ptr<BasePart>> Workspace::FindPartsInRegion3(shared_ptr<Type::Vector3> min, shared_ptr<Type::Vector3> max, const struct _ob_query_filter& filter, int maxParts){
+			std::vector<shared_ptr<BasePart>> parts;
+
+#if HAVE_BULLET
+			if(!min || !max){
+				return parts;
+			}
+
+			btVector3 regionMin = min->toBulletVector3();
+			btVector3 regionMax = max->toBulletVector3();
+			regionMin.setMin(max->toBulletVector3());
+			regionMax.setMax(min->toBulletVector3());
+
+			_ob_aabb_callback cb;
+			broadphase->aabbTest(regionMin, regionMax, cb);
+
+			std::set<Instance*> filterSet = _ob_query_set(filter);
+
+			for(std::vector<btCollisionObject*>::size_type i = 0; i < cb.objs.size(); i++){
+				if(maxParts > 0 && (int)parts.size() >= maxParts){
+					break;
+				}
+
+				btCollisionObject* obj = cb.objs[i];
+				BasePart* part = static_cast<BasePart*>(obj->getUserPointer());
+				if(!part || !_ob_query_matches(filterSet, filter.include, part)){
+					continue;
+				}
+
+				// The broadphase box is padded, check the real one
+				btVector3 aabbMin, aabbMax;
+				obj->getCollisionShape()->getAabb(obj->getWorldTransform(), aabbMin, aabbMax);
+				if(!TestAabbAgainstAabb2(aabbMin, aabbMax, regionMin, regionMax)){
+					continue;
+				}
+
+				shared_ptr<BasePart> sPart = _ob_query_part(obj);
+				if(sPart){
+					parts.push_back(sPart);
+				}
+			}
+#else
+			(void)min;
+			(void)max;
+			(void)filter;
+			(void)maxParts;
+#endif
+
+			return parts;
+		}
+
+		std::vector<shared_ptr<BasePart>> Workspace::GetPartsInRadius(shared_ptr<Type::Vector3> center, double radius, const struct _ob_query_filter& filter, int maxParts){
+			std::vector<shared_ptr<BasePart>> parts;
+
+#if HAVE_BULLET
+			if(!center || radius < 0){
+				return parts;
+			}
+
+			btVector3 btCenter = center->toBulletVector3();
+			btVector3 extent(radius, radius, radius);
+
+			_ob_aabb_callback cb;
+			broadphase->aabbTest(btCenter - extent, btCenter + extent, cb);
+
+			std::set<Instance*> filterSet = _ob_query_set(filter);
+
+			for(std::vector<btCollisionObject*>::size_type i = 0; i < cb.objs.size(); i++){
+				if(maxParts > 0 && (int)parts.size() >= maxParts){
+					break;
+				}
+
+				btCollisionObject* obj = cb.objs[i];
+				BasePart* part = static_cast<BasePart*>(obj->getUserPointer());
+				if(!part || !_ob_query_matches(filterSet, filter.include, part)){
+					continue;
+				}
+
+				if(!_ob_sphere_touches(obj, btCenter, radius)){
+					continue;
+				}
+
+				shared_ptr<BasePart> sPart = _ob_query_part(obj);
+				if(sPart){
+					parts.push_back(sPart);
+				}
+			}
+#else
+			(void)center;
+			(void)radius;
+			(void)filter;
+			(void)maxParts;
+#endif
+
+			return parts;
+		}
+
+		void Workspace::tick(){
+#if HAVE_BULLET
+			stepPhysics();
+#endif
+		}
+
 #if HAVE_ENET
 		void Workspace::replicateProperties(shared_ptr<NetworkReplicator> peer){
 			Instance::replicateProperties(peer);
@@ -230,6 +635,201 @@ namespace OB{
 			return 1;
 		}
 
+		/*
+		 * Reads the optional filter arguments shared by the spatial
+		 * queries: an Instance or a table of them at idx, then the
+		 * include flag. Returns the first bad table index, or 0.
+		 */
+		static int _ob_lua_query_filter(lua_State* L, int idx, struct _ob_query_filter& filter){
+			filter.include = lua_toboolean(L, idx + 1);
+
+			if(lua_isnoneornil(L, idx)){
+				return 0;
+			}
+
+			if(lua_istable(L, idx)){
+				int top = lua_gettop(L);
+
+				int len = lua_rawlen(L, idx);
+				for(int i = 1; i <= len; i++){
+					lua_rawgeti(L, idx, i);
+					shared_ptr<Instance> inst = Instance::checkInstance(L, -1, false, false);
+					lua_settop(L, top);
+
+					if(!inst){
+						return i;
+					}
+					filter.instances.push_back(inst);
+				}
+				return 0;
+			}
+
+			shared_ptr<Instance> inst = Instance::checkInstance(L, idx, true, false);
+			filter.instances.push_back(inst);
+			return 0;
+		}
+
+		static void _ob_lua_push_parts(lua_State* L, std::vector<shared_ptr<BasePart>> parts){
+			lua_newtable(L);
+
+			for(std::vector<shared_ptr<BasePart>>::size_type i = 0; i < parts.size(); i++){
+				parts[i]->wrap_lua(L);
+				lua_rawseti(L, -2, i + 1);
+			}
+		}
+
+		int Workspace::lua_Raycast(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<Workspace> instW = dynamic_pointer_cast<Workspace>(inst)){
+				shared_ptr<Type::Vector3> origin = Type::checkVector3(L, 2, true, false);
+				shared_ptr<Type::Vector3> direction = Type::checkVector3(L, 3, true, false);
+
+				struct _ob_query_filter filter;
+				int badIdx = _ob_lua_query_filter(L, 4, filter);
+				if(badIdx){
+					return luaL_error(L, "bad filter list entry %d (Instance expected)", badIdx);
+				}
+
+				struct _ob_raycast_result res = instW->Raycast(origin, direction, filter);
+				if(!res.part){
+					lua_pushnil(L);
+					return 1;
+				}
+
+				res.part->wrap_lua(L);
+				res.position->wrap_lua(L);
+				res.normal->wrap_lua(L);
+				return 3;
+			}
+
+			return luaL_error(L, COLONERR, "Raycast");
+		}
+
+		int Workspace::lua_RaycastMany(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<Workspace> instW = dynamic_pointer_cast<Workspace>(inst)){
+				luaL_checktype(L, 2, LUA_TTABLE);
+				luaL_checktype(L, 3, LUA_TTABLE);
+
+				int count = lua_rawlen(L, 2);
+				if((int)lua_rawlen(L, 3) != count){
+					return luaL_error(L, "RaycastMany needs as many directions as origins");
+				}
+
+				struct _ob_query_filter filter;
+				int badIdx = _ob_lua_query_filter(L, 4, filter);
+				if(badIdx){
+					return luaL_error(L, "bad filter list entry %d (Instance expected)", badIdx);
+				}
+
+				std::vector<shared_ptr<Type::Vector3>> origins;
+				std::vector<shared_ptr<Type::Vector3>> directions;
+				origins.reserve(count);
+				directions.reserve(count);
+
+				int top = lua_gettop(L);
+				for(int i = 1; i <= count; i++){
+					lua_rawgeti(L, 2, i);
+					shared_ptr<Type::Vector3> origin = Type::checkVector3(L, -1, false, false);
+					lua_rawgeti(L, 3, i);
+					shared_ptr<Type::Vector3> direction = Type::checkVector3(L, -1, false, false);
+					lua_settop(L, top);
+
+					if(!origin || !direction){
+						return luaL_error(L, "bad ray %d (Vector3 origin and direction expected)", i);
+					}
+
+					origins.push_back(origin);
+					directions.push_back(direction);
+				}
+
+				std::vector<struct _ob_raycast_result> results = instW->RaycastMany(origins, directions, filter);
+
+				lua_createtable(L, results.size(), 0);
+				for(std::vector<struct _ob_raycast_result>::size_type i = 0; i < results.size(); i++){
+					struct _ob_raycast_result& res = results[i];
+					if(res.part){
+						lua_createtable(L, 0, 3);
+
+						res.part->wrap_lua(L);
+						lua_setfield(L, -2, "Part");
+						res.position->wrap_lua(L);
+						lua_setfield(L, -2, "Position");
+						res.normal->wrap_lua(L);
+						lua_setfield(L, -2, "Normal");
+					}else{
+						// Keeps the result list free of holes
+						lua_pushboolean(L, false);
+					}
+					lua_rawseti(L, -2, i + 1);
+				}
+				return 1;
+			}
+
+			return luaL_error(L, COLONERR, "RaycastMany");
+		}
+
+		int Workspace::lua_FindPartsInRegion3(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<Workspace> instW = dynamic_pointer_cast<Workspace>(inst)){
+				shared_ptr<Type::Vector3> min = Type::checkVector3(L, 2, true, false);
+				shared_ptr<Type::Vector3> max = Type::checkVector3(L, 3, true, false);
+
+				struct _ob_query_filter filter;
+				int badIdx = _ob_lua_query_filter(L, 4, filter);
+				if(badIdx){
+					return luaL_error(L, "bad filter list entry %d (Instance expected)", badIdx);
+				}
+
+				int maxParts = luaL_optinteger(L, 6, OB_QUERY_DEFAULT_MAX_PARTS);
+
+				_ob_lua_push_parts(L, instW->FindPartsInRegion3(min, max, filter, maxParts));
+				return 1;
+			}
+
+			return luaL_error(L, COLONERR, "FindPartsInRegion3");
+		}
+
+		int Workspace::lua_GetPartsInRadius(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(shared_ptr<Workspace> instW = dynamic_pointer_cast<Workspace>(inst)){
+				shared_ptr<Type::Vector3> center = Type::checkVector3(L, 2, true, false);
+				double radius = luaL_checknumber(L, 3);
+
+				struct _ob_query_filter filter;
+				int badIdx = _ob_lua_query_filter(L, 4, filter);
+				if(badIdx){
+					return luaL_error(L, "bad filter list entry %d (Instance expected)", badIdx);
+				}
+
+				int maxParts = luaL_optinteger(L, 6, OB_QUERY_DEFAULT_MAX_PARTS);
+
+				_ob_lua_push_parts(L, instW->GetPartsInRadius(center, radius, filter, maxParts));
+				return 1;
+			}
+
+			return luaL_error(L, COLONERR, "GetPartsInRadius");
+		}
+
+		int Workspace::lua_getPhysicsStepTime(lua_State* L){
+			shared_ptr<Instance> inst = checkInstance(L, 1, false);
+
+			if(inst){
+				shared_ptr<Workspace> instW = dynamic_pointer_cast<Workspace>(inst);
+				if(instW){
+					lua_pushnumber(L, instW->getPhysicsStepTime());
+					return 1;
+				}
+			}
+
+			lua_pushnil(L);
+			return 1;
+		}
+
 		int Workspace::lua_setCurrentCamera(lua_State* L){
 			shared_ptr<Instance> inst = checkInstance(L, 1, false);
 
@@ -356,12 +956,26 @@ namespace OB{
 			return 1;
 		}
 
+		void Workspace::register_lua_methods(lua_State* L){
+			Instance::register_lua_methods(L);
+
+			luaL_Reg methods[] = {
+				{"Raycast", lua_Raycast},
+				{"RaycastMany", lua_RaycastMany},
+				{"FindPartsInRegion3", lua_FindPartsInRegion3},
+				{"GetPartsInRadius", lua_GetPartsInRadius},
+				{NULL, NULL}
+			};
+			luaL_setfuncs(L, methods, 0);
+		}
+
 		void Workspace::register_lua_property_setters(lua_State* L){
 			Instance::register_lua_property_setters(L);
 
 			luaL_Reg properties[] = {
 				{"CurrentCamera", lua_setCurrentCamera},
 				{"DistributedGameTime", lua_readOnlyProperty},
+				{"PhysicsStepTime", lua_readOnlyProperty},
 				{"Gravity", lua_setGravity},
 				{"FallenPartsDestroyHeight", lua_setFallenPartsDestroyHeight},
 				{"DestroyFallenParts", lua_setDestroyFallenParts},
@@ -376,9 +990,10 @@ namespace OB{
 			luaL_Reg properties[] = {
 				{"CurrentCamera", lua_getCurrentCamera},
 				{"DistributedGameTime", lua_getDistributedGameTime},
+				{"PhysicsStepTime", lua_getPhysicsStepTime},
 				{"Gravity", lua_getGravity},
-				{"FallenPartsDestroyHeight", lua_setFallenPartsDestroyHeight},
-				{"DestroyFallenParts", lua_setDestroyFallenParts},
+				{"FallenPartsDestroyHeight", lua_getFallenPartsDestroyHeight},
+				{"DestroyFallenParts", lua_getDestroyFallenParts},
 				{NULL, NULL}
 			};
 			luaL_setfuncs(L, properties, 0);
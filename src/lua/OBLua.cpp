@@ -18,6 +18,7 @@
  */
 
 #include "lua/OBLua.h"
+#include "lua/OBLuaAllocator.h"
 
 #include "lua/OBLua_OBBase.h"
 #include "lua/OBLua_OBOS.h"
@@ -48,25 +49,13 @@ namespace OB{
 	namespace Lua{
 		OBLState* globalOBLState = NULL;
 
-		void* l_alloc(void* ud, void* ptr, size_t osize, size_t nsize){
-			(void)ud;
-			(void)osize;
-
-			if(nsize == 0){
-				free(ptr);
-				return NULL;
-			}else{
-				return realloc(ptr, nsize);
-			}
-		}
-
 		// Stores information about Lua states used by OpenBlox, for example the 'script' value.
 		static std::map<lua_State*, struct OBLState*> lStates;
 
 		lua_State* initGlobal(OBEngine* eng){
 			// Don't put anything on the global state, its one purpose
 			// is to be the parent of coroutines.
-			lua_State* L = lua_newstate(l_alloc, NULL);
+			lua_State* L = lua_newstate(LuaAllocator::l_alloc, eng->getLuaAllocator().get());
 
 			struct OBLState* LState = new struct OBLState;
 			LState->L = L;
@@ -303,6 +292,15 @@ namespace OB{
 			}
 		}
 
+		void set_hook_all(OBEngine* eng, lua_Hook hook, int mask, int count){
+			for(std::map<lua_State*, struct OBLState*>::iterator it = lStates.begin(); it != lStates.end(); ++it){
+				struct OBLState* LState = it->second;
+				if(LState && LState->eng == eng){
+					lua_sethook(LState->L, hook, mask, count);
+				}
+			}
+		}
+
 		std::string handle_errors(lua_State* L){
 			std::string lerr = std::string(lua_tostring(L, -1));
 
@@ -486,6 +484,107 @@ namespace OB{
 			return _ob_lua_processDelay(L, 0, 1);
 		}
 
+		struct _ob_lua_resume_t{
+			lua_State* L;
+			// Registry reference keeping L alive until it's resumed
+			int ref;
+			ob_lua_resume_fnc pushArgs;
+			void* ud;
+			bool blockLogService;
+		};
+
+		// Wakes up a Lua coroutine parked by resume_later
+		int _ob_lua_wake_resume(void* metad, ob_uint64 start){
+			(void)start;
+
+			struct _ob_lua_resume_t* res = (struct _ob_lua_resume_t*)metad;
+			lua_State* L = res->L;
+
+			int nargs = 0;
+			if(res->pushArgs){
+				nargs = res->pushArgs(L, res->ud);
+			}
+
+			bool blockLogService = res->blockLogService;
+			int ref = res->ref;
+			delete res;
+
+			shared_ptr<Instance::LogService> ls;
+
+			if(blockLogService){
+				OBEngine* eng = getEngine(L);
+				if(eng){
+					shared_ptr<Instance::DataModel> dm = eng->getDataModel();
+					if(dm){
+						ls = dm->getLogService();
+						if(ls){
+							ls->block();
+						}
+					}
+				}
+			}
+
+			int ret = lua_resume(L, NULL, nargs);
+
+			if(ls){
+				ls->unblock();
+			}
+
+			// Anything that still needs L has its own reference by now
+			luaL_unref(L, LUA_REGISTRYINDEX, ref);
+
+			if(ret != LUA_OK && ret != LUA_YIELD){
+				std::string lerr = Lua::handle_errors(L);
+				std::cerr << "A Lua error occurred:" << std::endl;
+				std::cerr << lerr << std::endl;
+
+				close_state(L);
+
+				return 0;
+			}
+
+			if(ret == LUA_OK){
+				close_state(L);
+			}
+
+			return 0;
+		}
+
+		bool resume_later(lua_State* L, ob_lua_resume_fnc pushArgs, void* ud, bool blockLogService){
+			OBEngine* eng = NULL;
+			bool getsPaused = true;
+			bool dmBound = true;
+
+			std::map<lua_State*, struct OBLState*>::iterator it = lStates.find(L);
+			if(it != lStates.end() && it->second){
+				eng = it->second->eng;
+				getsPaused = it->second->getsPaused;
+				dmBound = it->second->dmBound;
+			}else{
+				// Not one of ours, like a coroutine from the coroutine library, treat it like a script
+				lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_MAINTHREAD);
+				eng = getEngine(lua_tothread(L, -1));
+				lua_pop(L, 1);
+			}
+
+			if(!eng){
+				return false;
+			}
+
+			struct _ob_lua_resume_t* res = new struct _ob_lua_resume_t;
+			res->L = L;
+			res->pushArgs = pushArgs;
+			res->ud = ud;
+			res->blockLogService = blockLogService;
+
+			lua_pushthread(L);
+			res->ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+			eng->getTaskScheduler()->enqueue(_ob_lua_wake_resume, res, currentTimeMillis(), getsPaused, dmBound);
+
+			return true;
+		}
+
 		int lua_newInstance(lua_State* L){
 			std::string className = std::string(luaL_checkstring(L, 1));
 			shared_ptr<Instance::Instance> par = Instance::Instance::checkInstance(L, 2);
@@ -518,7 +617,7 @@ namespace OB{
 				b = luaL_checknumber(L, 3);
 			}
 
-			shared_ptr<Type::Color3> newGuy = make_shared<Type::Color3>(r, g, b);
+			shared_ptr<Type::Color3> newGuy = make_pooled<Type::Color3>(r, g, b);
 			return newGuy->wrap_lua(L);
 		}
 
@@ -533,7 +632,7 @@ namespace OB{
 				b = luaL_checknumber(L, 3);
 			}
 
-			shared_ptr<Type::Color3> newGuy = make_shared<Type::Color3>(r / 255, g / 255, b / 255);
+			shared_ptr<Type::Color3> newGuy = make_pooled<Type::Color3>(r / 255, g / 255, b / 255);
 			return newGuy->wrap_lua(L);
 		}
 
@@ -548,7 +647,7 @@ namespace OB{
 				z = luaL_checknumber(L, 3);
 			}
 
-			shared_ptr<Type::Vector3> newGuy = make_shared<Type::Vector3>(x, y, z);
+			shared_ptr<Type::Vector3> newGuy = make_pooled<Type::Vector3>(x, y, z);
 			return newGuy->wrap_lua(L);
 		}
 
@@ -561,7 +660,7 @@ namespace OB{
 				y = luaL_checknumber(L, 2);
 			}
 
-			shared_ptr<Type::Vector2> newGuy = make_shared<Type::Vector2>(x, y);
+			shared_ptr<Type::Vector2> newGuy = make_pooled<Type::Vector2>(x, y);
 			return newGuy->wrap_lua(L);
 		}
 
@@ -620,7 +719,7 @@ namespace OB{
 				offset = luaL_checknumber(L, 2);
 			}
 
-			shared_ptr<Type::UDim> newGuy = make_shared<Type::UDim>(scale, offset);
+			shared_ptr<Type::UDim> newGuy = make_pooled<Type::UDim>(scale, offset);
 			return newGuy->wrap_lua(L);
 		}
 
@@ -637,7 +736,7 @@ namespace OB{
 				yOffset = luaL_checknumber(L, 4);
 			}
 
-			shared_ptr<Type::UDim2> newGuy = make_shared<Type::UDim2>(xScale, xOffset, yScale, yOffset);
+			shared_ptr<Type::UDim2> newGuy = make_pooled<Type::UDim2>(xScale, xOffset, yScale, yOffset);
 			return newGuy->wrap_lua(L);
 		}
 
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "lua/OBLuaAllocator.h"
+
+#include <cstdlib>
+#include <cstring>
+
+// Size class index for a small block size
+#define OB_LUAALLOC_CLASS(sz) (((sz) - 1) / OB_LUAALLOC_GRANULARITY)
+
+namespace OB{
+	namespace Lua{
+		LuaAllocator::LuaAllocator(){
+			for(size_t i = 0; i < OB_LUAALLOC_NUM_CLASSES; i++){
+				freeLists[i] = NULL;
+			}
+
+			slabCur = NULL;
+			slabEnd = NULL;
+
+			bytesInUse = 0;
+			peakBytes = 0;
+			slabBytes = 0;
+			memoryLimit = 0;
+		}
+
+		LuaAllocator::~LuaAllocator(){
+			for(std::vector<void*>::iterator it = slabs.begin(); it != slabs.end(); ++it){
+				free(*it);
+			}
+			slabs.clear();
+		}
+
+		void* LuaAllocator::l_alloc(void* ud, void* ptr, size_t osize, size_t nsize){
+			LuaAllocator* alloc = (LuaAllocator*)ud;
+			return alloc->allocate(ptr, osize, nsize);
+		}
+
+		void* LuaAllocator::allocate(void* ptr, size_t osize, size_t nsize){
+			if(ptr == NULL){
+				// osize encodes the type of object being created
+				osize = 0;
+			}
+
+			if(nsize == 0){
+				if(ptr){
+					if(osize <= OB_LUAALLOC_MAX_SMALL){
+						freeSmall(ptr, OB_LUAALLOC_CLASS(osize));
+					}else{
+						free(ptr);
+					}
+					bytesInUse -= osize;
+				}
+				return NULL;
+			}
+
+			// Lua assumes shrinking never fails, so only growth is capped
+			if(memoryLimit > 0 && nsize > osize){
+				if(bytesInUse - osize + nsize > memoryLimit){
+					return NULL;
+				}
+			}
+
+			bool oldSmall = ptr && osize <= OB_LUAALLOC_MAX_SMALL;
+			bool newSmall = nsize <= OB_LUAALLOC_MAX_SMALL;
+
+			void* nptr = NULL;
+
+			if(oldSmall && newSmall && OB_LUAALLOC_CLASS(osize) == OB_LUAALLOC_CLASS(nsize)){
+				// Still fits in the same block
+				nptr = ptr;
+			}else if(ptr && !oldSmall && !newSmall){
+				nptr = realloc(ptr, nsize);
+				if(!nptr){
+					return NULL;
+				}
+			}else{
+				if(newSmall){
+					nptr = allocSmall(OB_LUAALLOC_CLASS(nsize));
+				}else{
+					nptr = malloc(nsize);
+				}
+				if(!nptr){
+					return NULL;
+				}
+
+				if(ptr){
+					memcpy(nptr, ptr, osize < nsize ? osize : nsize);
+
+					if(oldSmall){
+						freeSmall(ptr, OB_LUAALLOC_CLASS(osize));
+					}else{
+						free(ptr);
+					}
+				}
+			}
+
+			bytesInUse = bytesInUse - osize + nsize;
+			if(bytesInUse > peakBytes){
+				peakBytes = bytesInUse;
+			}
+
+			return nptr;
+		}
+
+		void* LuaAllocator::allocSmall(size_t sizeClass){
+			FreeBlock* blk = freeLists[sizeClass];
+			if(blk){
+				freeLists[sizeClass] = blk->next;
+				return blk;
+			}
+
+			size_t blockSize = (sizeClass + 1) * OB_LUAALLOC_GRANULARITY;
+
+			if(slabCur == NULL || (size_t)(slabEnd - slabCur) < blockSize){
+				// Whatever is left of the current slab is abandoned
+				char* slab = (char*)malloc(OB_LUAALLOC_SLAB_SIZE);
+				if(!slab){
+					return NULL;
+				}
+
+				slabs.push_back(slab);
+				slabBytes += OB_LUAALLOC_SLAB_SIZE;
+
+				slabCur = slab;
+				slabEnd = slab + OB_LUAALLOC_SLAB_SIZE;
+			}
+
+			void* ret = slabCur;
+			slabCur += blockSize;
+
+			return ret;
+		}
+
+		void LuaAllocator::freeSmall(void* ptr, size_t sizeClass){
+			FreeBlock* blk = (FreeBlock*)ptr;
+			blk->next = freeLists[sizeClass];
+			freeLists[sizeClass] = blk;
+		}
+
+		size_t LuaAllocator::getBytesInUse(){
+			return bytesInUse;
+		}
+
+		size_t LuaAllocator::getPeakBytes(){
+			return peakBytes;
+		}
+
+		size_t LuaAllocator::getSlabBytes(){
+			return slabBytes;
+		}
+
+		size_t LuaAllocator::getMemoryLimit(){
+			return memoryLimit;
+		}
+
+		void LuaAllocator::setMemoryLimit(size_t limit){
+			memoryLimit = limit;
+		}
+	}
+}
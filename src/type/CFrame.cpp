@@ -95,7 +95,7 @@ namespace OB{
 			m[3][0] = x;
 			m[3][1] = y;
 			m[3][2] = z;
-			m[3][3] = 0;
+			m[3][3] = 1;
 
 			fB = CFPerfT::Unknown;
 		}
@@ -218,7 +218,7 @@ namespace OB{
 		}
 
 		shared_ptr<Vector3> CFrame::getPosition(){
-			return make_shared<Vector3>(m[3][0], m[3][1], m[3][2]);
+			return make_pooled<Vector3>(m[3][0], m[3][1], m[3][2]);
 		}
 
 		bool _ob_cf_nearZero(double d){
@@ -390,110 +390,14 @@ namespace OB{
 				m[2][3] = other->m[2][3];
 				m[3][3] = other->m[3][3];
 			}else{
-				double tm[4][4];
-				tm[0][0] =
-					m[0][0] * other->m[0][0] +
-					m[1][0] * other->m[0][1] +
-					m[2][0] * other->m[0][2] +
-					m[3][0] * other->m[0][3];
-				tm[0][1] =
-					m[0][1] * other->m[0][0] +
-					m[1][1] * other->m[0][1] +
-					m[2][1] * other->m[0][2] +
-					m[3][1] * other->m[0][3];
-				tm[0][2] =
-					m[0][2] * other->m[0][0] +
-					m[1][2] * other->m[0][1] +
-					m[2][2] * other->m[0][2] +
-					m[3][2] * other->m[0][3];
-				tm[0][3] =
-					m[0][3] * other->m[0][0] +
-					m[1][3] * other->m[0][1] +
-					m[2][3] * other->m[0][2] +
-					m[3][3] * other->m[0][3];
-				tm[1][0] =
-					m[0][0] * other->m[1][0] +
-					m[1][0] * other->m[1][1] +
-					m[2][0] * other->m[1][2] +
-					m[3][0] * other->m[1][3];
-				tm[1][1] =
-					m[0][1] * other->m[1][0] +
-					m[1][1] * other->m[1][1] +
-					m[2][1] * other->m[1][2] +
-					m[3][1] * other->m[1][3];
-				tm[1][2] =
-					m[0][2] * other->m[1][0] +
-					m[1][2] * other->m[1][1] +
-					m[2][2] * other->m[1][2] +
-					m[3][2] * other->m[1][3];
-				tm[1][3] =
-					m[0][3] * other->m[1][0] +
-					m[1][3] * other->m[1][1] +
-					m[2][3] * other->m[1][2] +
-					m[3][3] * other->m[1][3];
-				tm[2][0] =
-					m[0][0] * other->m[2][0] +
-					m[1][0] * other->m[2][1] +
-					m[2][0] * other->m[2][2] +
-					m[3][0] * other->m[2][3];
-				tm[2][1] =
-					m[0][1] * other->m[2][0] +
-					m[1][1] * other->m[2][1] +
-					m[2][1] * other->m[2][2] +
-					m[3][1] * other->m[2][3];
-				tm[2][2] =
-					m[0][2] * other->m[2][0] +
-					m[1][2] * other->m[2][1] +
-					m[2][2] * other->m[2][2] +
-					m[3][2] * other->m[2][3];
-				tm[2][3] =
-					m[0][3] * other->m[2][0] +
-					m[1][3] * other->m[2][1] +
-					m[2][3] * other->m[2][2] +
-					m[3][3] * other->m[2][3];
-				tm[3][0] =
-					m[0][0] * other->m[3][0] +
-					m[1][0] * other->m[3][1] +
-					m[2][0] * other->m[3][2] +
-					m[3][0] * other->m[3][3];
-				tm[3][1] =
-					m[0][1] * other->m[3][0] +
-					m[1][1] * other->m[3][1] +
-					m[2][1] * other->m[3][2] +
-					m[3][1] * other->m[3][3];
-				tm[3][2] =
-					m[0][2] * other->m[3][0] +
-					m[1][2] * other->m[3][1] +
-					m[2][2] * other->m[3][2] +
-					m[3][2] * other->m[3][3];
-				tm[3][3] =
-					m[0][3] * other->m[3][0] +
-					m[1][3] * other->m[3][1] +
-					m[2][3] * other->m[3][2] +
-					m[3][3] * other->m[3][3];
-
-				m[0][0] = tm[0][0];
-				m[1][0] = tm[1][0];
-				m[2][0] = tm[2][0];
-				m[3][0] = tm[3][0];
-				m[0][1] = tm[0][1];
-				m[1][1] = tm[1][1];
-				m[2][1] = tm[2][1];
-				m[3][1] = tm[3][1];
-				m[0][2] = tm[0][2];
-				m[1][2] = tm[1][2];
-				m[2][2] = tm[2][2];
-				m[3][2] = tm[3][2];
-				m[0][3] = tm[0][3];
-				m[1][3] = tm[1][3];
-				m[2][3] = tm[2][3];
-				m[3][3] = tm[3][3];
+				// m = other * m, in matrix terms
+				CFrameKernels::get()->mul(m, other->m, m);
 			}
 		}
 
 		void CFrame::lookAt(shared_ptr<Vector3> pos, shared_ptr<Vector3> at){
 			// Might make this an arg, possibly
-			shared_ptr<Vector3> upVector = make_shared<Vector3>(0, 1, 0);
+			shared_ptr<Vector3> upVector = make_pooled<Vector3>(0, 1, 0);
 
 			shared_ptr<Vector3> zaxis = (at->sub(pos))->normalize();
 			shared_ptr<Vector3> xaxis = upVector->cross(zaxis)->normalize();
@@ -616,28 +520,72 @@ namespace OB{
 				shared_ptr<CFrame> sharedThis = dynamic_pointer_cast<CFrame>(shared_from_this());
 				return sharedThis;
 			}else{
-				// TODO:
+				shared_ptr<CFrame> cfL = make_shared<CFrame>(0);
+				CFrameKernels::lerp(cfL->m, m, goal->m, alpha);
+				return cfL;
+			}
+		}
+
+		shared_ptr<CFrame> CFrame::inverse(){
+			shared_ptr<CFrame> cfI = make_shared<CFrame>(0);
+			if(!CFrameKernels::inverse(cfI->m, m)){
+				return NULL;
+			}
+			return cfI;
+		}
+
+		shared_ptr<Vector3> CFrame::pointToWorldSpace(shared_ptr<Vector3> v){
+			if(!v){
 				return NULL;
 			}
+
+			double p[3] = {v->getX(), v->getY(), v->getZ()};
+			CFrameKernels::get()->transformPoints(m, p, p, 1);
+
+			return make_pooled<Vector3>(p[0], p[1], p[2]);
+		}
+
+		shared_ptr<Vector3> CFrame::vectorToWorldSpace(shared_ptr<Vector3> v){
+			if(!v){
+				return NULL;
+			}
+
+			double p[3] = {v->getX(), v->getY(), v->getZ()};
+			CFrameKernels::get()->transformVectors(m, p, p, 1);
+
+			return make_pooled<Vector3>(p[0], p[1], p[2]);
+		}
+
+		void CFrame::pointsToWorldSpace(const double* in, double* out, size_t count){
+			CFrameKernels::get()->transformPoints(m, in, out, count);
+		}
+
+		void CFrame::vectorsToWorldSpace(const double* in, double* out, size_t count){
+			CFrameKernels::get()->transformVectors(m, in, out, count);
+		}
+
+		void CFrame::mulMany(const double (*children)[4][4], double (*out)[4][4], size_t count){
+			// this * child is child->m * m, see multiplyInternal
+			CFrameKernels::get()->mulMany(out, children, m, count);
 		}
 
 		shared_ptr<Vector3> CFrame::toEulerAnglesXYZ(){
 			if(m[0][2] < 1.0){
 				if(m[0][2] > -1.0){
-					return make_shared<Vector3>(
+					return make_pooled<Vector3>(
 						std::atan2(-m[1][2], m[2][2]),
 						std::asin(m[0][2]),
 						std::atan2(-m[0][1], m[0][0])
 					);
 				}else{
-					return make_shared<Vector3>(
+					return make_pooled<Vector3>(
 						-std::atan2(m[1][0], m[1][1]),
 						-M_PI_2,
 						0.0
 					);
 				}
 			}else{
-				return make_shared<Vector3>(
+				return make_pooled<Vector3>(
 					std::atan2(m[1][0], m[1][1]),
 					M_PI_2,
 					0.0
@@ -648,20 +596,20 @@ namespace OB{
 		shared_ptr<Vector3> CFrame::toEulerAnglesXZY(){
 			if(m[0][1] < 1.0){
 				if(m[0][1] > -1.0){
-					return make_shared<Vector3>(
+					return make_pooled<Vector3>(
 						std::atan2(m[2][1], m[1][1]),
 						std::asin(-m[0][1]),
 						std::atan2(m[0][2], m[0][0])
 					);
 				}else{
-					return make_shared<Vector3>(
+					return make_pooled<Vector3>(
 						std::atan2(m[2][0], m[2][2]),
 						M_PI_2,
 						0.0
 					);
 				}
 			}else{
-				return make_shared<Vector3>(
+				return make_pooled<Vector3>(
 					std::atan2(-m[2][0], m[2][2]),
 					-M_PI_2,
 					0.0
@@ -672,20 +620,20 @@ namespace OB{
 		shared_ptr<Vector3> CFrame::toEulerAnglesYXZ(){
 			if(m[1][2] < 1.0){
 				if(m[1][2] > -1.0){
-					return make_shared<Vector3>(
+					return make_pooled<Vector3>(
 						std::atan2(m[0][2], m[2][2]),
 						std::asin(-m[1][2]),
 						std::atan2(m[1][0], m[1][1])
 					);
 				}else{
-					return make_shared<Vector3>(
+					return make_pooled<Vector3>(
 						std::atan2(m[0][1], m[0][0]),
 						M_PI_2,
 						0.0
 					);
 				}
 			}else{
-				return make_shared<Vector3>(
+				return make_pooled<Vector3>(
 					std::atan2(-m[0][1], m[0][0]),
 					-M_PI_2,
 					0.0
@@ -696,20 +644,20 @@ namespace OB{
 		shared_ptr<Vector3> CFrame::toEulerAnglesYZX(){
 			if(m[1][0] < 1.0){
 				if(m[1][0] > -1.0){
-					return make_shared<Vector3>(
+					return make_pooled<Vector3>(
 						std::atan2(-m[2][0], m[0][0]),
 						std::asin(m[1][0]),
 						std::atan2(-m[1][2], m[1][1])
 					);
 				}else{
-					return make_shared<Vector3>(
+					return make_pooled<Vector3>(
 						-std::atan2(m[2][1], m[2][2]),
 						-M_PI_2,
 						0.0
 					);
 				}
 			}else{
-				return make_shared<Vector3>(
+				return make_pooled<Vector3>(
 					std::atan2(m[2][1], m[2][2]),
 					M_PI_2,
 					0.0
@@ -720,20 +668,20 @@ namespace OB{
 		shared_ptr<Vector3> CFrame::toEulerAnglesZXY(){
 			if(m[2][1] < 1.0){
 				if(m[2][1] > -1.0){
-					return make_shared<Vector3>(
+					return make_pooled<Vector3>(
 						std::atan2(-m[0][1], m[1][1]),
 						std::asin(m[2][1]),
 						std::atan2(-m[2][0], m[2][2])
 					);
 				}else{
-					return make_shared<Vector3>(
+					return make_pooled<Vector3>(
 						-std::atan2(m[0][2], m[0][0]),
 						-M_PI_2,
 						0.0
 					);
 				}
 			}else{
-				return make_shared<Vector3>(
+				return make_pooled<Vector3>(
 					std::atan2(m[0][2], m[0][0]),
 					M_PI_2,
 					0.0
@@ -744,20 +692,20 @@ namespace OB{
 		shared_ptr<Vector3> CFrame::toEulerAnglesZYX(){
 			if(m[2][0] < 1.0){
 				if(m[2][0] > -1.0){
-					return make_shared<Vector3>(
+					return make_pooled<Vector3>(
 						std::atan2(m[1][0], m[0][0]),
 						std::asin(-m[2][1]),
 						std::atan2(m[2][1], m[2][2])
 					);
 				}else{
-					return make_shared<Vector3>(
+					return make_pooled<Vector3>(
 						-std::atan2(m[0][1], m[0][2]),
 						M_PI_2,
 						0.0
 					);
 				}
 			}else{
-				return make_shared<Vector3>(
+				return make_pooled<Vector3>(
 					std::atan2(-m[0][1], -m[0][2]),
 					-M_PI_2,
 					0.0
@@ -831,12 +779,86 @@ namespace OB{
 				return luaL_error(L, COLONERR, "Lerp");
 			}
 
-			shared_ptr<CFrame> cfr = checkCFrame(L, 2);
+			shared_ptr<CFrame> cfr = checkCFrame(L, 2, true, false);
 			double alpha = luaL_checknumber(L, 3);
 
 			return LuaCFrame->lerp(cfr, alpha)->wrap_lua(L);
 		}
 
+		int CFrame::lua_inverse(lua_State* L){
+			shared_ptr<CFrame> LuaCFrame = checkCFrame(L, 1, false);
+			if(!LuaCFrame){
+				return luaL_error(L, COLONERR, "Inverse");
+			}
+
+			shared_ptr<CFrame> cfI = LuaCFrame->inverse();
+			if(cfI){
+				return cfI->wrap_lua(L);
+			}
+
+			lua_pushnil(L);
+			return 1;
+		}
+
+		int CFrame::lua_pointToWorldSpace(lua_State* L){
+			shared_ptr<CFrame> LuaCFrame = checkCFrame(L, 1, false);
+			if(!LuaCFrame){
+				return luaL_error(L, COLONERR, "PointToWorldSpace");
+			}
+
+			shared_ptr<Vector3> vec3 = checkVector3(L, 2, true, false);
+			return LuaCFrame->pointToWorldSpace(vec3)->wrap_lua(L);
+		}
+
+		int CFrame::lua_vectorToWorldSpace(lua_State* L){
+			shared_ptr<CFrame> LuaCFrame = checkCFrame(L, 1, false);
+			if(!LuaCFrame){
+				return luaL_error(L, COLONERR, "VectorToWorldSpace");
+			}
+
+			shared_ptr<Vector3> vec3 = checkVector3(L, 2, true, false);
+			return LuaCFrame->vectorToWorldSpace(vec3)->wrap_lua(L);
+		}
+
+		int CFrame::lua_pointsToWorldSpace(lua_State* L){
+			shared_ptr<CFrame> LuaCFrame = checkCFrame(L, 1, false);
+			if(!LuaCFrame){
+				return luaL_error(L, COLONERR, "PointsToWorldSpace");
+			}
+
+			luaL_checktype(L, 2, LUA_TTABLE);
+			size_t count = lua_rawlen(L, 2);
+
+			// Check everything before allocating, errors don't unwind C++
+			for(size_t i = 1; i <= count; i++){
+				lua_rawgeti(L, 2, i);
+				if(!checkVector3(L, -1, false, false)){
+					return luaL_error(L, "bad element #%d to 'PointsToWorldSpace' (Vector3 expected)", (int)i);
+				}
+				lua_pop(L, 1);
+			}
+
+			std::vector<double> pts(count * 3);
+
+			for(size_t i = 0; i < count; i++){
+				lua_rawgeti(L, 2, i + 1);
+				shared_ptr<Vector3> vec3 = checkVector3(L, -1, false, false);
+				pts[i * 3] = vec3->getX();
+				pts[i * 3 + 1] = vec3->getY();
+				pts[i * 3 + 2] = vec3->getZ();
+				lua_pop(L, 1);
+			}
+
+			LuaCFrame->pointsToWorldSpace(pts.data(), pts.data(), count);
+
+			lua_createtable(L, count, 0);
+			for(size_t i = 0; i < count; i++){
+				make_pooled<Vector3>(pts[i * 3], pts[i * 3 + 1], pts[i * 3 + 2])->wrap_lua(L);
+				lua_rawseti(L, -2, i + 1);
+			}
+			return 1;
+		}
+
 		int CFrame::lua_toEulerAnglesXYZ(lua_State* L){
 			shared_ptr<CFrame> LuaCFrame = checkCFrame(L, 1, false);
 			if(!LuaCFrame){
@@ -997,6 +1019,10 @@ namespace OB{
 		void CFrame::register_lua_methods(lua_State* L){
 			luaL_Reg methods[] = {
 				{"Lerp", lua_lerp},
+				{"Inverse", lua_inverse},
+				{"PointToWorldSpace", lua_pointToWorldSpace},
+				{"VectorToWorldSpace", lua_vectorToWorldSpace},
+				{"PointsToWorldSpace", lua_pointsToWorldSpace},
 				{"ToEulerAnglesXYZ", lua_toEulerAnglesXYZ},
 				{"ToEulerAnglesXZY", lua_toEulerAnglesXZY},
 				{"ToEulerAnglesYXZ", lua_toEulerAnglesYXZ},
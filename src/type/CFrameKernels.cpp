@@ -0,0 +1,465 @@
+/*
+ * Copyright (C) 2016 John M. Harris, Jr. <johnmh@openblox.org>
+ *
+ * This file is part of OpenBlox.
+ *
+ * OpenBlox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenBlox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the Lesser GNU General Public License
+ * along with OpenBlox. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "type/CFrameKernels.h"
+
+#include <cstring>
+#include <cmath>
+
+// The SIMD versions are compiled with per-function target attributes,
+// so the rest of the library doesn't need any extra compiler flags.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define OB_CFRAME_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+/* Cosine of the angle between two rotations above which slerp is
+   replaced by a normalized lerp. Past this point the two give the
+   same result to within float precision, and sin(theta) gets too
+   small to divide by safely. */
+#define OB_CFRAME_NLERP_THRESHOLD 0.9995
+
+namespace OB{
+	namespace Type{
+		// Scalar
+
+		static void _ob_cf_scalar_mul(double out[4][4], const double a[4][4], const double b[4][4]){
+			double tm[4][4];
+
+			for(int i = 0; i < 4; i++){
+				for(int j = 0; j < 4; j++){
+					tm[i][j] =
+						a[i][0] * b[0][j] +
+						a[i][1] * b[1][j] +
+						a[i][2] * b[2][j] +
+						a[i][3] * b[3][j];
+				}
+			}
+
+			memcpy(out, tm, sizeof(tm));
+		}
+
+		static void _ob_cf_scalar_mulMany(double (*out)[4][4], const double (*a)[4][4], const double b[4][4], size_t count){
+			for(size_t i = 0; i < count; i++){
+				_ob_cf_scalar_mul(out[i], a[i], b);
+			}
+		}
+
+		static void _ob_cf_scalar_transformPoints(const double m[4][4], const double* in, double* out, size_t count){
+			for(size_t i = 0; i < count; i++){
+				double x = in[i * 3];
+				double y = in[i * 3 + 1];
+				double z = in[i * 3 + 2];
+
+				out[i * 3] = x * m[0][0] + y * m[1][0] + z * m[2][0] + m[3][0];
+				out[i * 3 + 1] = x * m[0][1] + y * m[1][1] + z * m[2][1] + m[3][1];
+				out[i * 3 + 2] = x * m[0][2] + y * m[1][2] + z * m[2][2] + m[3][2];
+			}
+		}
+
+		static void _ob_cf_scalar_transformVectors(const double m[4][4], const double* in, double* out, size_t count){
+			for(size_t i = 0; i < count; i++){
+				double x = in[i * 3];
+				double y = in[i * 3 + 1];
+				double z = in[i * 3 + 2];
+
+				out[i * 3] = x * m[0][0] + y * m[1][0] + z * m[2][0];
+				out[i * 3 + 1] = x * m[0][1] + y * m[1][1] + z * m[2][1];
+				out[i * 3 + 2] = x * m[0][2] + y * m[1][2] + z * m[2][2];
+			}
+		}
+
+		static const CFrameKernels _ob_cf_scalar = {
+			"scalar",
+			_ob_cf_scalar_mul,
+			_ob_cf_scalar_mulMany,
+			_ob_cf_scalar_transformPoints,
+			_ob_cf_scalar_transformVectors
+		};
+
+#if OB_CFRAME_SIMD_X86
+		// SSE2, each row is held in two registers
+
+		__attribute__((target("sse2")))
+		static inline void _ob_cf_sse2_mulRows(double out[4][4], const double a[4][4], const double b[4][4]){
+			__m128d b0l = _mm_loadu_pd(&b[0][0]);
+			__m128d b0h = _mm_loadu_pd(&b[0][2]);
+			__m128d b1l = _mm_loadu_pd(&b[1][0]);
+			__m128d b1h = _mm_loadu_pd(&b[1][2]);
+			__m128d b2l = _mm_loadu_pd(&b[2][0]);
+			__m128d b2h = _mm_loadu_pd(&b[2][2]);
+			__m128d b3l = _mm_loadu_pd(&b[3][0]);
+			__m128d b3h = _mm_loadu_pd(&b[3][2]);
+
+			// Nothing is written until both inputs have been read, so out can alias either
+			__m128d rl[4];
+			__m128d rh[4];
+
+			for(int i = 0; i < 4; i++){
+				__m128d a0 = _mm_set1_pd(a[i][0]);
+				__m128d a1 = _mm_set1_pd(a[i][1]);
+				__m128d a2 = _mm_set1_pd(a[i][2]);
+				__m128d a3 = _mm_set1_pd(a[i][3]);
+
+				rl[i] = _mm_add_pd(_mm_add_pd(_mm_mul_pd(a0, b0l), _mm_mul_pd(a1, b1l)), _mm_add_pd(_mm_mul_pd(a2, b2l), _mm_mul_pd(a3, b3l)));
+				rh[i] = _mm_add_pd(_mm_add_pd(_mm_mul_pd(a0, b0h), _mm_mul_pd(a1, b1h)), _mm_add_pd(_mm_mul_pd(a2, b2h), _mm_mul_pd(a3, b3h)));
+			}
+
+			for(int i = 0; i < 4; i++){
+				_mm_storeu_pd(&out[i][0], rl[i]);
+				_mm_storeu_pd(&out[i][2], rh[i]);
+			}
+		}
+
+		__attribute__((target("sse2")))
+		static void _ob_cf_sse2_mul(double out[4][4], const double a[4][4], const double b[4][4]){
+			_ob_cf_sse2_mulRows(out, a, b);
+		}
+
+		__attribute__((target("sse2")))
+		static void _ob_cf_sse2_mulMany(double (*out)[4][4], const double (*a)[4][4], const double b[4][4], size_t count){
+			double tb[4][4];
+			memcpy(tb, b, sizeof(tb));
+
+			for(size_t i = 0; i < count; i++){
+				_ob_cf_sse2_mulRows(out[i], a[i], tb);
+			}
+		}
+
+		__attribute__((target("sse2")))
+		static void _ob_cf_sse2_transform(const double m[4][4], const double* in, double* out, size_t count, bool points){
+			__m128d r0l = _mm_loadu_pd(&m[0][0]);
+			__m128d r0h = _mm_load_sd(&m[0][2]);
+			__m128d r1l = _mm_loadu_pd(&m[1][0]);
+			__m128d r1h = _mm_load_sd(&m[1][2]);
+			__m128d r2l = _mm_loadu_pd(&m[2][0]);
+			__m128d r2h = _mm_load_sd(&m[2][2]);
+			__m128d r3l = _mm_setzero_pd();
+			__m128d r3h = _mm_setzero_pd();
+
+			if(points){
+				r3l = _mm_loadu_pd(&m[3][0]);
+				r3h = _mm_load_sd(&m[3][2]);
+			}
+
+			for(size_t i = 0; i < count; i++){
+				__m128d x = _mm_set1_pd(in[i * 3]);
+				__m128d y = _mm_set1_pd(in[i * 3 + 1]);
+				__m128d z = _mm_set1_pd(in[i * 3 + 2]);
+
+				__m128d lo = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, r0l), _mm_mul_pd(y, r1l)), _mm_add_pd(_mm_mul_pd(z, r2l), r3l));
+				__m128d hi = _mm_add_sd(_mm_add_sd(_mm_mul_sd(x, r0h), _mm_mul_sd(y, r1h)), _mm_add_sd(_mm_mul_sd(z, r2h), r3h));
+
+				_mm_storeu_pd(&out[i * 3], lo);
+				_mm_store_sd(&out[i * 3 + 2], hi);
+			}
+		}
+
+		static void _ob_cf_sse2_transformPoints(const double m[4][4], const double* in, double* out, size_t count){
+			_ob_cf_sse2_transform(m, in, out, count, true);
+		}
+
+		static void _ob_cf_sse2_transformVectors(const double m[4][4], const double* in, double* out, size_t count){
+			_ob_cf_sse2_transform(m, in, out, count, false);
+		}
+
+		static const CFrameKernels _ob_cf_sse2 = {
+			"sse2",
+			_ob_cf_sse2_mul,
+			_ob_cf_sse2_mulMany,
+			_ob_cf_sse2_transformPoints,
+			_ob_cf_sse2_transformVectors
+		};
+
+		// AVX2, each row fits in one register
+
+		__attribute__((target("avx2,fma")))
+		static inline void _ob_cf_avx2_mulRows(double out[4][4], const double a[4][4], __m256d b0, __m256d b1, __m256d b2, __m256d b3){
+			__m256d r[4];
+
+			for(int i = 0; i < 4; i++){
+				__m256d acc = _mm256_mul_pd(_mm256_broadcast_sd(&a[i][0]), b0);
+				acc = _mm256_fmadd_pd(_mm256_broadcast_sd(&a[i][1]), b1, acc);
+				acc = _mm256_fmadd_pd(_mm256_broadcast_sd(&a[i][2]), b2, acc);
+				r[i] = _mm256_fmadd_pd(_mm256_broadcast_sd(&a[i][3]), b3, acc);
+			}
+
+			for(int i = 0; i < 4; i++){
+				_mm256_storeu_pd(&out[i][0], r[i]);
+			}
+		}
+
+		__attribute__((target("avx2,fma")))
+		static void _ob_cf_avx2_mul(double out[4][4], const double a[4][4], const double b[4][4]){
+			// b is fully loaded first, so out can alias either input
+			_ob_cf_avx2_mulRows(out, a, _mm256_loadu_pd(&b[0][0]), _mm256_loadu_pd(&b[1][0]), _mm256_loadu_pd(&b[2][0]), _mm256_loadu_pd(&b[3][0]));
+		}
+
+		__attribute__((target("avx2,fma")))
+		static void _ob_cf_avx2_mulMany(double (*out)[4][4], const double (*a)[4][4], const double b[4][4], size_t count){
+			__m256d b0 = _mm256_loadu_pd(&b[0][0]);
+			__m256d b1 = _mm256_loadu_pd(&b[1][0]);
+			__m256d b2 = _mm256_loadu_pd(&b[2][0]);
+			__m256d b3 = _mm256_loadu_pd(&b[3][0]);
+
+			for(size_t i = 0; i < count; i++){
+				_ob_cf_avx2_mulRows(out[i], a[i], b0, b1, b2, b3);
+			}
+		}
+
+		__attribute__((target("avx2,fma")))
+		static void _ob_cf_avx2_transform(const double m[4][4], const double* in, double* out, size_t count, bool points){
+			// Only x, y and z are written, w would land on the next point
+			__m256i mask = _mm256_set_epi64x(0, -1, -1, -1);
+
+			__m256d r0 = _mm256_loadu_pd(&m[0][0]);
+			__m256d r1 = _mm256_loadu_pd(&m[1][0]);
+			__m256d r2 = _mm256_loadu_pd(&m[2][0]);
+			__m256d r3 = _mm256_setzero_pd();
+
+			if(points){
+				r3 = _mm256_loadu_pd(&m[3][0]);
+			}
+
+			for(size_t i = 0; i < count; i++){
+				__m256d acc = _mm256_fmadd_pd(_mm256_broadcast_sd(&in[i * 3]), r0, r3);
+				acc = _mm256_fmadd_pd(_mm256_broadcast_sd(&in[i * 3 + 1]), r1, acc);
+				acc = _mm256_fmadd_pd(_mm256_broadcast_sd(&in[i * 3 + 2]), r2, acc);
+
+				_mm256_maskstore_pd(&out[i * 3], mask, acc);
+			}
+		}
+
+		static void _ob_cf_avx2_transformPoints(const double m[4][4], const double* in, double* out, size_t count){
+			_ob_cf_avx2_transform(m, in, out, count, true);
+		}
+
+		static void _ob_cf_avx2_transformVectors(const double m[4][4], const double* in, double* out, size_t count){
+			_ob_cf_avx2_transform(m, in, out, count, false);
+		}
+
+		static const CFrameKernels _ob_cf_avx2 = {
+			"avx2",
+			_ob_cf_avx2_mul,
+			_ob_cf_avx2_mulMany,
+			_ob_cf_avx2_transformPoints,
+			_ob_cf_avx2_transformVectors
+		};
+#endif
+
+		static const CFrameKernels* _ob_cf_select(){
+#if OB_CFRAME_SIMD_X86
+			__builtin_cpu_init();
+
+			if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")){
+				return &_ob_cf_avx2;
+			}
+			if(__builtin_cpu_supports("sse2")){
+				return &_ob_cf_sse2;
+			}
+#endif
+			return &_ob_cf_scalar;
+		}
+
+		const CFrameKernels* CFrameKernels::get(){
+			static const CFrameKernels* selected = _ob_cf_select();
+			return selected;
+		}
+
+		const CFrameKernels* CFrameKernels::get(std::string name){
+			if(name == "scalar"){
+				return &_ob_cf_scalar;
+			}
+
+#if OB_CFRAME_SIMD_X86
+			__builtin_cpu_init();
+
+			if(name == "sse2" && __builtin_cpu_supports("sse2")){
+				return &_ob_cf_sse2;
+			}
+			if(name == "avx2" && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")){
+				return &_ob_cf_avx2;
+			}
+#endif
+
+			return NULL;
+		}
+
+		bool CFrameKernels::inverse(double out[4][4], const double in[4][4]){
+			// Rows of the inverse rotation are the columns of the adjugate
+			double c00 = in[1][1] * in[2][2] - in[1][2] * in[2][1];
+			double c01 = in[0][2] * in[2][1] - in[0][1] * in[2][2];
+			double c02 = in[0][1] * in[1][2] - in[0][2] * in[1][1];
+			double c10 = in[1][2] * in[2][0] - in[1][0] * in[2][2];
+			double c11 = in[0][0] * in[2][2] - in[0][2] * in[2][0];
+			double c12 = in[0][2] * in[1][0] - in[0][0] * in[1][2];
+			double c20 = in[1][0] * in[2][1] - in[1][1] * in[2][0];
+			double c21 = in[0][1] * in[2][0] - in[0][0] * in[2][1];
+			double c22 = in[0][0] * in[1][1] - in[0][1] * in[1][0];
+
+			double det = in[0][0] * c00 + in[0][1] * c10 + in[0][2] * c20;
+			if(det == 0){
+				return false;
+			}
+			double invDet = 1.0 / det;
+
+			double r[3][3] = {
+				{c00 * invDet, c01 * invDet, c02 * invDet},
+				{c10 * invDet, c11 * invDet, c12 * invDet},
+				{c20 * invDet, c21 * invDet, c22 * invDet}
+			};
+
+			double tx = in[3][0];
+			double ty = in[3][1];
+			double tz = in[3][2];
+
+			for(int i = 0; i < 3; i++){
+				out[i][0] = r[i][0];
+				out[i][1] = r[i][1];
+				out[i][2] = r[i][2];
+				out[i][3] = 0;
+			}
+
+			out[3][0] = -(tx * r[0][0] + ty * r[1][0] + tz * r[2][0]);
+			out[3][1] = -(tx * r[0][1] + ty * r[1][1] + tz * r[2][1]);
+			out[3][2] = -(tx * r[0][2] + ty * r[1][2] + tz * r[2][2]);
+			out[3][3] = 1;
+
+			return true;
+		}
+
+		// Quaternion (x, y, z, w) for the rotation part of a CFrame
+		static void _ob_cf_toQuat(const double m[4][4], double q[4]){
+			double trace = m[0][0] + m[1][1] + m[2][2];
+
+			if(trace > 0){
+				double s = sqrt(trace + 1.0) * 2;
+				q[3] = 0.25 * s;
+				q[0] = (m[1][2] - m[2][1]) / s;
+				q[1] = (m[2][0] - m[0][2]) / s;
+				q[2] = (m[0][1] - m[1][0]) / s;
+			}else if(m[0][0] > m[1][1] && m[0][0] > m[2][2]){
+				double s = sqrt(1.0 + m[0][0] - m[1][1] - m[2][2]) * 2;
+				q[3] = (m[1][2] - m[2][1]) / s;
+				q[0] = 0.25 * s;
+				q[1] = (m[0][1] + m[1][0]) / s;
+				q[2] = (m[2][0] + m[0][2]) / s;
+			}else if(m[1][1] > m[2][2]){
+				double s = sqrt(1.0 + m[1][1] - m[0][0] - m[2][2]) * 2;
+				q[3] = (m[2][0] - m[0][2]) / s;
+				q[0] = (m[0][1] + m[1][0]) / s;
+				q[1] = 0.25 * s;
+				q[2] = (m[1][2] + m[2][1]) / s;
+			}else{
+				double s = sqrt(1.0 + m[2][2] - m[0][0] - m[1][1]) * 2;
+				q[3] = (m[0][1] - m[1][0]) / s;
+				q[0] = (m[2][0] + m[0][2]) / s;
+				q[1] = (m[1][2] + m[2][1]) / s;
+				q[2] = 0.25 * s;
+			}
+		}
+
+		// Same layout CFrame::rotateQ produces
+		static void _ob_cf_fromQuat(double m[4][4], const double q[4]){
+			double xx = q[0] * q[0];
+			double xy = q[0] * q[1];
+			double xz = q[0] * q[2];
+			double xw = q[0] * q[3];
+			double yy = q[1] * q[1];
+			double yz = q[1] * q[2];
+			double yw = q[1] * q[3];
+			double zz = q[2] * q[2];
+			double zw = q[2] * q[3];
+
+			m[0][0] = 1 - 2 * (yy + zz);
+			m[0][1] =     2 * (xy + zw);
+			m[0][2] =     2 * (xz - yw);
+			m[0][3] = 0;
+			m[1][0] =     2 * (xy - zw);
+			m[1][1] = 1 - 2 * (xx + zz);
+			m[1][2] =     2 * (yz + xw);
+			m[1][3] = 0;
+			m[2][0] =     2 * (xz + yw);
+			m[2][1] =     2 * (yz - xw);
+			m[2][2] = 1 - 2 * (xx + yy);
+			m[2][3] = 0;
+		}
+
+		void CFrameKernels::lerp(double out[4][4], const double a[4][4], const double b[4][4], double alpha){
+			double qa[4];
+			double qb[4];
+			_ob_cf_toQuat(a, qa);
+			_ob_cf_toQuat(b, qb);
+
+			double cosTheta = qa[0] * qb[0] + qa[1] * qb[1] + qa[2] * qb[2] + qa[3] * qb[3];
+
+			// q and -q are the same rotation, take the short way around
+			if(cosTheta < 0){
+				cosTheta = -cosTheta;
+				qb[0] = -qb[0];
+				qb[1] = -qb[1];
+				qb[2] = -qb[2];
+				qb[3] = -qb[3];
+			}
+
+			double wa;
+			double wb;
+
+			if(cosTheta > OB_CFRAME_NLERP_THRESHOLD){
+				wa = 1 - alpha;
+				wb = alpha;
+			}else{
+				double theta = acos(cosTheta);
+				double sinTheta = sin(theta);
+				wa = sin((1 - alpha) * theta) / sinTheta;
+				wb = sin(alpha * theta) / sinTheta;
+			}
+
+			double q[4];
+			for(int i = 0; i < 4; i++){
+				q[i] = wa * qa[i] + wb * qb[i];
+			}
+
+			// Only needed for nlerp, but it also cleans up rounding
+			double len = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+			if(len > 0){
+				for(int i = 0; i < 4; i++){
+					q[i] /= len;
+				}
+			}
+
+			double px = a[3][0] + (b[3][0] - a[3][0]) * alpha;
+			double py = a[3][1] + (b[3][1] - a[3][1]) * alpha;
+			double pz = a[3][2] + (b[3][2] - a[3][2]) * alpha;
+
+			_ob_cf_fromQuat(out, q);
+
+			out[3][0] = px;
+			out[3][1] = py;
+			out[3][2] = pz;
+			out[3][3] = 1;
+		}
+
+		void CFrameKernels::lerpMany(double (*out)[4][4], const double (*a)[4][4], const double (*b)[4][4], size_t count, double alpha){
+			for(size_t i = 0; i < count; i++){
+				lerp(out[i], a[i], b[i], alpha);
+			}
+		}
+	}
+}
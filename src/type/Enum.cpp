@@ -244,6 +244,12 @@ namespace OB{
 			  "Middle",
 			  "Inset");
 
+		DENUM(AssetPriority,
+			  "UI",
+			  "Near",
+			  "Default",
+			  "Far");
+
 		void registerLuaEnums(lua_State* L){
 			lua_newtable(L);
 
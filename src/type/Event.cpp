@@ -22,11 +22,13 @@
 #include "type/EventConnection.h"
 
 #include "OBEngine.h"
-#include "TaskScheduler.h"
 #include "instance/LogService.h"
 
 #include <algorithm>
 #include <iostream>
+#include <deque>
+
+#include <pthread.h>
 
 namespace OB{
 	namespace Type{
@@ -38,13 +40,22 @@ namespace OB{
 			this->name = name;
 			this->canFireFromLua = canFireFromLua;
 			this->blockLogService = blockLogService;
+
+			listenerHook = NULL;
+			listenerHookUd = NULL;
 		}
 
-		Event::~Event(){}
+		Event::~Event(){
+			// Nothing can wake these anymore, let them be collected
+			for(std::vector<struct evt_waiter_t>::size_type i = 0; i != waiters.size(); i++){
+				luaL_unref(waiters[i].L, LUA_REGISTRYINDEX, waiters[i].ref);
+			}
+		}
 
-		shared_ptr<EventConnection> Event::Connect(std::function<void(std::vector<shared_ptr<VarWrapper>>)> fnc){
+		shared_ptr<EventConnection> Event::Connect(std::function<void(const std::vector<shared_ptr<VarWrapper>>&)> fnc){
 			shared_ptr<EventConnection> evtCon = make_shared<EventConnection>(dynamic_pointer_cast<Event>(std::enable_shared_from_this<Type>::shared_from_this()), fnc);
 			conns.push_back(evtCon);
+			listenersChanged(1);
 
 			return evtCon;
 		}
@@ -52,15 +63,41 @@ namespace OB{
 		shared_ptr<EventConnection> Event::Connect(void (*fnc)(std::vector<shared_ptr<VarWrapper>>, void*), void* ud){
 			using namespace std::placeholders;
 
-			std::function<void(std::vector<shared_ptr<VarWrapper>>)> nfnc = std::bind(fnc, _1, ud);
+			std::function<void(const std::vector<shared_ptr<VarWrapper>>&)> nfnc = std::bind(fnc, _1, ud);
+			shared_ptr<EventConnection> evtCon = make_shared<EventConnection>(dynamic_pointer_cast<Event>(std::enable_shared_from_this<Type>::shared_from_this()), nfnc, ud);
+			conns.push_back(evtCon);
+			listenersChanged(1);
+
+			return evtCon;
+		}
+
+		shared_ptr<EventConnection> Event::Connect(void (*fnc)(const std::vector<shared_ptr<VarWrapper>>&, void*), void* ud){
+			using namespace std::placeholders;
+
+			std::function<void(const std::vector<shared_ptr<VarWrapper>>&)> nfnc = std::bind(fnc, _1, ud);
 			shared_ptr<EventConnection> evtCon = make_shared<EventConnection>(dynamic_pointer_cast<Event>(std::enable_shared_from_this<Type>::shared_from_this()), nfnc, ud);
 			conns.push_back(evtCon);
+			listenersChanged(1);
+
+			return evtCon;
+		}
+
+		shared_ptr<EventConnection> Event::ConnectImmediate(std::function<void(const std::vector<shared_ptr<VarWrapper>>&)> fnc){
+			shared_ptr<EventConnection> evtCon = make_shared<EventConnection>(dynamic_pointer_cast<Event>(std::enable_shared_from_this<Type>::shared_from_this()), fnc);
+			evtCon->setImmediate(true);
+			conns.push_back(evtCon);
+			listenersChanged(1);
 
 			return evtCon;
 		}
 
 		void Event::disconnectAll(){
+			int removed = conns.size();
 			conns.clear();
+
+			if(removed > 0){
+				listenersChanged(-removed);
+			}
 		}
 
 		void Event::disconnect(shared_ptr<EventConnection> conn){
@@ -72,6 +109,7 @@ namespace OB{
 
 			if(res != conns.end()){
 				conns.erase(res);
+				listenersChanged(-1);
 			}
 		}
 
@@ -83,34 +121,127 @@ namespace OB{
 			return blockLogService;
 		}
 
-		struct evt_vconn_t{
-			shared_ptr<EventConnection> evtCon;
-			std::vector<shared_ptr<VarWrapper>> args;
-		};
+		bool Event::hasWaiters(){
+			return !waiters.empty();
+		}
+
+		bool Event::hasListeners(){
+			return !conns.empty() || !waiters.empty();
+		}
 
-		int evt_do_fire_connection(void* vconn, ob_uint64 startTime){
-			struct evt_vconn_t* conn = (struct evt_vconn_t*)vconn;
+		size_t Event::getListenerCount(){
+			return conns.size() + waiters.size();
+		}
+
+		void Event::setListenerHook(void (*hook)(Event*, int, void*), void* ud){
+			listenerHook = hook;
+			listenerHookUd = ud;
+		}
 
-			conn->evtCon->fire(conn->args);
+		void Event::listenersChanged(int delta){
+			if(listenerHook){
+				listenerHook(this, delta, listenerHookUd);
+			}
+		}
 
-			delete conn;
+		EventQueue::EventQueue(){
+			pthread_mutex_init(&mmutex, NULL);
+		}
 
-			return 0;
+		EventQueue::~EventQueue(){
+			pthread_mutex_destroy(&mmutex);
+		}
+
+		void EventQueue::push(const struct evt_dispatch_t& disp){
+			pthread_mutex_lock(&mmutex);
+			deferred.push_back(disp);
+			pthread_mutex_unlock(&mmutex);
+		}
+
+		void EventQueue::dispatchDeferred(){
+			pthread_mutex_lock(&mmutex);
+			// Anything fired by these connections waits for the next dispatch
+			size_t count = deferred.size();
+			pthread_mutex_unlock(&mmutex);
+
+			for(size_t i = 0; i < count; i++){
+				pthread_mutex_lock(&mmutex);
+				struct evt_dispatch_t disp = deferred.front();
+				deferred.pop_front();
+				pthread_mutex_unlock(&mmutex);
+
+				// Disconnected between Fire and now
+				if(!disp.evtCon->isConnected()){
+					continue;
+				}
+
+				disp.evtCon->fire(*disp.args);
+			}
+		}
+
+		size_t EventQueue::getDeferredCount(){
+			pthread_mutex_lock(&mmutex);
+			size_t count = deferred.size();
+			pthread_mutex_unlock(&mmutex);
+
+			return count;
+		}
+
+		// Pushes the arguments of Fire for a thread parked in Wait
+		int evt_push_waiter_args(lua_State* L, void* ud){
+			shared_ptr<std::vector<shared_ptr<VarWrapper>>>* args = (shared_ptr<std::vector<shared_ptr<VarWrapper>>>*)ud;
+
+			int nargs = (*args)->size();
+			for(int i = 0; i < nargs; i++){
+				(**args)[i]->wrap_lua(L);
+			}
+
+			delete args;
+			return nargs;
 		}
 
 		void Event::Fire(OBEngine* eng, std::vector<shared_ptr<VarWrapper>> argList){
-			if(!conns.empty()){
-				shared_ptr<TaskScheduler> tasks = eng->getTaskScheduler();
+			if(conns.empty() && waiters.empty()){
+				return;
+			}
 
-				for(std::vector<shared_ptr<EventConnection>>::size_type i = 0; i != conns.size(); i++){
-					/* We push these tasks onto the TaskScheduler so that
-					   they can call Disconnect without messing up this loop. */
-					struct evt_vconn_t* conn = new struct evt_vconn_t;
-					conn->evtCon = conns[i];
-					conn->args = argList;
+			// One argument block, shared by every connection and waiter
+			shared_ptr<std::vector<shared_ptr<VarWrapper>>> args = make_shared<std::vector<shared_ptr<VarWrapper>>>(std::move(argList));
+
+			if(!waiters.empty()){
+				/* Waiters are taken off the list before any of them
+				   run, so a thread that waits again from here is
+				   parked for the next Fire instead of this one. */
+				std::vector<struct evt_waiter_t> toWake;
+				toWake.swap(waiters);
+				listenersChanged(-(int)toWake.size());
+
+				for(std::vector<struct evt_waiter_t>::size_type i = 0; i != toWake.size(); i++){
+					shared_ptr<std::vector<shared_ptr<VarWrapper>>>* wargs = new shared_ptr<std::vector<shared_ptr<VarWrapper>>>(args);
+					if(!Lua::resume_later(toWake[i].L, evt_push_waiter_args, wargs, blockLogService)){
+						delete wargs;
+					}
+
+					// resume_later holds its own reference until the thread runs
+					luaL_unref(toWake[i].L, LUA_REGISTRYINDEX, toWake[i].ref);
+				}
+			}
 
-					tasks->enqueue(evt_do_fire_connection, conn, 0, false, false);
+			shared_ptr<EventQueue> queue = eng->getEventQueue();
+
+			for(std::vector<shared_ptr<EventConnection>>::size_type i = 0; i < conns.size(); i++){
+				shared_ptr<EventConnection> evtCon = conns[i];
+
+				if(evtCon->isImmediate()){
+					evtCon->fire(*args);
+					continue;
 				}
+
+				struct evt_dispatch_t disp;
+				disp.evtCon = evtCon;
+				disp.args = args;
+
+				queue->push(disp);
 			}
 		}
 
@@ -193,7 +324,7 @@ namespace OB{
 			bool blockedLogService;
 		};
 
-		void evt_lua_connection_fnc(std::vector<shared_ptr<VarWrapper>> args, void* ud){
+		void evt_lua_connection_fnc(const std::vector<shared_ptr<VarWrapper>>& args, void* ud){
 			struct evt_lua_connection_ud_t* eud = (struct evt_lua_connection_ud_t*)ud;
 
 			lua_State* L = Lua::initCoroutine(eud->thread);
@@ -265,8 +396,23 @@ namespace OB{
 			if(!evt){
 				return luaL_error(L, COLONERR, "Wait");
 			}
-			// TODO:
-			return 0;
+
+			if(!lua_isyieldable(L)){
+				return luaL_error(L, "attempt to yield from outside a coroutine");
+			}
+
+			struct evt_waiter_t waiter;
+			waiter.L = L;
+
+			// Nothing else may refer to L, like a dropped coroutine.wrap
+			lua_pushthread(L);
+			waiter.ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+			evt->waiters.push_back(waiter);
+			evt->listenersChanged(1);
+
+			// Fire has the TaskScheduler resume us with its arguments
+			return lua_yield(L, 0);
 		}
 
 		void Event::register_lua_methods(lua_State* L){
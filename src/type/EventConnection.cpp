@@ -31,16 +31,18 @@ namespace OB{
 			registerLuaType(eng, LuaTypeName, TypeName, register_lua_metamethods, register_lua_methods, register_lua_property_getters, register_lua_property_setters);
 		}
 
-		EventConnection::EventConnection(shared_ptr<Event> evt, std::function<void(std::vector<shared_ptr<VarWrapper>>)> fnc){
+		EventConnection::EventConnection(shared_ptr<Event> evt, std::function<void(const std::vector<shared_ptr<VarWrapper>>&)> fnc){
 			this->evt = evt;
 			this->fnc = fnc;
 			ud = NULL;
+			immediate = false;
 		}
 
-		EventConnection::EventConnection(shared_ptr<Event> evt, std::function<void(std::vector<shared_ptr<VarWrapper>>)> fnc, void* ud){
+		EventConnection::EventConnection(shared_ptr<Event> evt, std::function<void(const std::vector<shared_ptr<VarWrapper>>&)> fnc, void* ud){
 			this->evt = evt;
 			this->ud = ud;
 			this->fnc = fnc;
+			immediate = false;
 		}
 
 		EventConnection::~EventConnection(){
@@ -65,7 +67,15 @@ namespace OB{
 			}
 		}
 
-		void EventConnection::fire(std::vector<shared_ptr<VarWrapper>> args){
+		bool EventConnection::isImmediate(){
+			return immediate;
+		}
+
+		void EventConnection::setImmediate(bool immediate){
+			this->immediate = immediate;
+		}
+
+		void EventConnection::fire(const std::vector<shared_ptr<VarWrapper>>& args){
 			fnc(args);
 		}
 
@@ -33,16 +33,25 @@ namespace OB{
 		}
 
 		UDim2::UDim2(){
-			x = make_shared<UDim>();
-			y = make_shared<UDim>();
+			xScale = 0;
+			xOffset = 0;
+			yScale = 0;
+			yOffset = 0;
 		}
 
 		UDim2::UDim2(double xScale, double xOffset, double yScale, double yOffset){
-			x = make_shared<UDim>(xScale, xOffset);
-			y = make_shared<UDim>(yScale, yOffset);
+			this->xScale = xScale;
+			this->xOffset = xOffset;
+			this->yScale = yScale;
+			this->yOffset = yOffset;
 		}
 
 		UDim2::UDim2(std::string str){
+			xScale = 0;
+			xOffset = 0;
+			yScale = 0;
+			yOffset = 0;
+
 			std::vector<std::string> fields = split(str);
 			if(fields.size() == 4){
 				std::string xScaleStr = trim(fields[0]);
@@ -50,11 +59,6 @@ namespace OB{
 				std::string yScaleStr = trim(fields[2]);
 				std::string yOffsetStr = trim(fields[3]);
 
-				double xScale = 0;
-				double xOffset = 0;
-				double yScale = 0;
-				double yOffset = 0;
-
 				if(xScaleStr.length() > 0){
 					xScale = atof(xScaleStr.c_str());
 				}
@@ -70,41 +74,47 @@ namespace OB{
 				if(yOffsetStr.length() > 0){
 					yOffset = atof(yOffsetStr.c_str());
 				}
-
-				x = make_shared<UDim>(xScale, xOffset);
-				y = make_shared<UDim>(yScale, yOffset);
-			}else{
-				x = make_shared<UDim>();
-				y = make_shared<UDim>();
 			}
 		}
 
 		UDim2::~UDim2(){}
 
 		shared_ptr<UDim> UDim2::getX(){
-			return x;
+			return make_pooled<UDim>(xScale, xOffset);
 		}
 
 		shared_ptr<UDim> UDim2::getY(){
-			return y;
+			return make_pooled<UDim>(yScale, yOffset);
+		}
+
+		double UDim2::getXScale(){
+			return xScale;
+		}
+
+		double UDim2::getXOffset(){
+			return xOffset;
+		}
+
+		double UDim2::getYScale(){
+			return yScale;
+		}
+
+		double UDim2::getYOffset(){
+			return yOffset;
 		}
 
 		shared_ptr<UDim2> UDim2::add(shared_ptr<UDim2> u){
 			if(!u){
-				return make_shared<UDim2>(x->getScale(), x->getOffset(), y->getScale(), y->getOffset());
+				return make_pooled<UDim2>(xScale, xOffset, yScale, yOffset);
 			}
-			shared_ptr<UDim> uX = u->getX();
-			shared_ptr<UDim> uY = u->getY();
-			return make_shared<UDim2>(x->getScale() + uX->getScale(), x->getOffset() + uX->getOffset(), y->getScale() + uY->getScale(), y->getOffset() + uY->getOffset());
+			return make_pooled<UDim2>(xScale + u->xScale, xOffset + u->xOffset, yScale + u->yScale, yOffset + u->yOffset);
 		}
 
 		shared_ptr<UDim2> UDim2::sub(shared_ptr<UDim2> u){
 			if(!u){
-				return make_shared<UDim2>(x->getScale(), x->getOffset(), y->getScale(), y->getOffset());
+				return make_pooled<UDim2>(xScale, xOffset, yScale, yOffset);
 			}
-			shared_ptr<UDim> uX = u->getX();
-			shared_ptr<UDim> uY = u->getY();
-			return make_shared<UDim2>(x->getScale() - uX->getScale(), x->getOffset() - uX->getOffset(), y->getScale() - uY->getScale(), y->getOffset() - uY->getOffset());
+			return make_pooled<UDim2>(xScale - u->xScale, xOffset - u->xOffset, yScale - u->yScale, yOffset - u->yOffset);
 		}
 
 		bool UDim2::equals(shared_ptr<Type> other){
@@ -113,11 +123,13 @@ namespace OB{
 				return false;
 			}
 
-			return co->x->equals(x) && co->y->equals(y);
+			return co->xScale == xScale && co->xOffset == xOffset && co->yScale == yScale && co->yOffset == yOffset;
 		}
 
 		std::string UDim2::toString(){
-			return x->toString() + ", " + y->toString();
+			std::ostringstream out;
+			out << std::dec << xScale << ", " << xOffset << ", " << yScale << ", " << yOffset;
+			return out.str();
 		}
 
 		int UDim2::lua_getX(lua_State* L){
@@ -212,7 +212,7 @@ namespace OB{
 				shared_ptr<Type> tp = *static_cast<shared_ptr<Type>*>(wrapped);
 				return dynamic_pointer_cast<Vector3>(tp);
 			}
-			return make_shared<Vector3>(0, 0, 0);
+			return make_pooled<Vector3>(0, 0, 0);
 		}
 
 		shared_ptr<Vector2> VarWrapper::asVector2(){
@@ -220,7 +220,7 @@ namespace OB{
 				shared_ptr<Type> tp = *static_cast<shared_ptr<Type>*>(wrapped);
 				return dynamic_pointer_cast<Vector2>(tp);
 			}
-			return make_shared<Vector2>(0, 0);
+			return make_pooled<Vector2>(0, 0);
 		}
 
 		shared_ptr<Color3> VarWrapper::asColor3(){
@@ -228,7 +228,7 @@ namespace OB{
 				shared_ptr<Type> tp = *static_cast<shared_ptr<Type>*>(wrapped);
 				return dynamic_pointer_cast<Color3>(tp);
 			}
-			return make_shared<Color3>(0, 0, 0);
+			return make_pooled<Color3>(0, 0, 0);
 		}
 
 		shared_ptr<UDim> VarWrapper::asUDim(){
@@ -236,7 +236,7 @@ namespace OB{
 				shared_ptr<Type> tp = *static_cast<shared_ptr<Type>*>(wrapped);
 				return dynamic_pointer_cast<UDim>(tp);
 			}
-			return make_shared<UDim>();
+			return make_pooled<UDim>();
 		}
 
 		shared_ptr<UDim2> VarWrapper::asUDim2(){
@@ -244,7 +244,7 @@ namespace OB{
 				shared_ptr<Type> tp = *static_cast<shared_ptr<Type>*>(wrapped);
 				return dynamic_pointer_cast<UDim2>(tp);
 			}
-			return make_shared<UDim2>();
+			return make_pooled<UDim2>();
 		}
 
 		bool VarWrapper::valueEquals(shared_ptr<VarWrapper> other){
@@ -107,54 +107,54 @@ namespace OB{
 		shared_ptr<Vector2> Vector2::normalize(){
 			double len = getLength();
 			if(len == 0){//Prevents NaN in sqrt
-				return make_shared<Vector2>(x, y);
+				return make_pooled<Vector2>(x, y);
 			}
 			len = 1.0 / sqrt(len);
 
 			double X = (double)(x * len);
 			double Y = (double)(y * len);
 
-			return make_shared<Vector2>(X, Y);
+			return make_pooled<Vector2>(X, Y);
 		}
 
 		shared_ptr<Vector2> Vector2::add(double v){
-			return make_shared<Vector2>(x + v, y + v);
+			return make_pooled<Vector2>(x + v, y + v);
 		}
 
 		shared_ptr<Vector2> Vector2::add(shared_ptr<Vector2> v){
 			if(!v){
-				return make_shared<Vector2>(x, y);
+				return make_pooled<Vector2>(x, y);
 			}
-			return make_shared<Vector2>(x + v->x, y + v->y);
+			return make_pooled<Vector2>(x + v->x, y + v->y);
 		}
 
 		shared_ptr<Vector2> Vector2::sub(double v){
-			return make_shared<Vector2>(x - v, y - v);
+			return make_pooled<Vector2>(x - v, y - v);
 		}
 
 		shared_ptr<Vector2> Vector2::sub(shared_ptr<Vector2> v){
 			if(!v){
-				return make_shared<Vector2>(x, y);
+				return make_pooled<Vector2>(x, y);
 			}
-			return make_shared<Vector2>(x - v->x, y - v->y);
+			return make_pooled<Vector2>(x - v->x, y - v->y);
 		}
 
 		shared_ptr<Vector2> Vector2::mul(double v){
-			return make_shared<Vector2>(x * v, y * v);
+			return make_pooled<Vector2>(x * v, y * v);
 		}
 
 		shared_ptr<Vector2> Vector2::mul(shared_ptr<Vector2> v){
 			if(!v){
-				return make_shared<Vector2>(0, 0);
+				return make_pooled<Vector2>(0, 0);
 			}
-			return make_shared<Vector2>(x * v->x, y * v->y);
+			return make_pooled<Vector2>(x * v->x, y * v->y);
 		}
 
 		shared_ptr<Vector2> Vector2::div(double v){
 			if(v == 0){
 				return NULL;
 			}
-			return make_shared<Vector2>(x / v, y / v);
+			return make_pooled<Vector2>(x / v, y / v);
 		}
 
 		shared_ptr<Vector2> Vector2::div(shared_ptr<Vector2> v){
@@ -164,11 +164,11 @@ namespace OB{
 			if(v->x == 0 || v->y == 0){//Divide by 0
 				return NULL;
 			}
-			return make_shared<Vector2>(x / v->x, y / v->y);
+			return make_pooled<Vector2>(x / v->x, y / v->y);
 		}
 
 		shared_ptr<Vector2> Vector2::neg(){
-			return make_shared<Vector2>(-x, -y);
+			return make_pooled<Vector2>(-x, -y);
 		}
 
 		shared_ptr<Vector2> Vector2::lerp(shared_ptr<Vector2> goal, double alpha){
@@ -176,7 +176,7 @@ namespace OB{
 				return NULL;
 			}
 
-			return make_shared<Vector2>((x + alpha) * (goal->x - x), (y + alpha) * (goal->y - y));
+			return make_pooled<Vector2>((x + alpha) * (goal->x - x), (y + alpha) * (goal->y - y));
 		}
 
 		double Vector2::dot(shared_ptr<Vector2> v){
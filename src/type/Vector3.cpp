@@ -127,7 +127,7 @@ namespace OB{
 		shared_ptr<Vector3> Vector3::normalize(){
 			double len = getLength();
 			if(len == 0){//Prevents NaN in sqrt
-				return make_shared<Vector3>(x, y, z);
+				return make_pooled<Vector3>(x, y, z);
 			}
 			len = 1.0 / sqrt(len);
 
@@ -135,47 +135,47 @@ namespace OB{
 			double Y = (double)(y * len);
 			double Z = (double)(z * len);
 
-			return make_shared<Vector3>(X, Y, Z);
+			return make_pooled<Vector3>(X, Y, Z);
 		}
 
 		shared_ptr<Vector3> Vector3::add(double v){
-			return make_shared<Vector3>(x + v, y + v, z + v);
+			return make_pooled<Vector3>(x + v, y + v, z + v);
 		}
 
 		shared_ptr<Vector3> Vector3::add(shared_ptr<Vector3> v){
 			if(!v){
-				return make_shared<Vector3>(x, y, z);
+				return make_pooled<Vector3>(x, y, z);
 			}
-			return make_shared<Vector3>(x + v->x, y + v->y, z + v->z);
+			return make_pooled<Vector3>(x + v->x, y + v->y, z + v->z);
 		}
 
 		shared_ptr<Vector3> Vector3::sub(double v){
-			return make_shared<Vector3>(x - v, y - v, z - v);
+			return make_pooled<Vector3>(x - v, y - v, z - v);
 		}
 
 		shared_ptr<Vector3> Vector3::sub(shared_ptr<Vector3> v){
 			if(!v){
-				return make_shared<Vector3>(x, y, z);
+				return make_pooled<Vector3>(x, y, z);
 			}
-			return make_shared<Vector3>(x - v->x, y - v->y, z - v->z);
+			return make_pooled<Vector3>(x - v->x, y - v->y, z - v->z);
 		}
 
 		shared_ptr<Vector3> Vector3::mul(double v){
-			return make_shared<Vector3>(x * v, y * v, z * v);
+			return make_pooled<Vector3>(x * v, y * v, z * v);
 		}
 
 		shared_ptr<Vector3> Vector3::mul(shared_ptr<Vector3> v){
 			if(!v){
-				return make_shared<Vector3>(0, 0, 0);
+				return make_pooled<Vector3>(0, 0, 0);
 			}
-			return make_shared<Vector3>(x * v->x, y * v->y, z * v->z);
+			return make_pooled<Vector3>(x * v->x, y * v->y, z * v->z);
 		}
 
 		shared_ptr<Vector3> Vector3::div(double v){
 			if(v == 0){
 				return NULL;
 			}
-			return make_shared<Vector3>(x / v, y / v, z / v);
+			return make_pooled<Vector3>(x / v, y / v, z / v);
 		}
 
 		shared_ptr<Vector3> Vector3::div(shared_ptr<Vector3> v){
@@ -185,11 +185,11 @@ namespace OB{
 			if(v->x == 0 || v->y == 0 || v->z == 0){//Divide by 0
 				return NULL;
 			}
-			return make_shared<Vector3>(x / v->x, y / v->y, z / v->z);
+			return make_pooled<Vector3>(x / v->x, y / v->y, z / v->z);
 		}
 
 		shared_ptr<Vector3> Vector3::neg(){
-			return make_shared<Vector3>(-x, -y, -z);
+			return make_pooled<Vector3>(-x, -y, -z);
 		}
 
 		shared_ptr<Vector3> Vector3::lerp(shared_ptr<Vector3> goal, double alpha){
@@ -197,7 +197,7 @@ namespace OB{
 				return NULL;
 			}
 
-			return make_shared<Vector3>((x + alpha) * (goal->x - x),
+			return make_pooled<Vector3>((x + alpha) * (goal->x - x),
 										(y + alpha) * (goal->y - y),
 										(z + alpha) * (goal->z - z));
 		}
@@ -213,7 +213,7 @@ namespace OB{
 			if(v == NULL){
 				return NULL;
 			}
-			return make_shared<Vector3>(y * v->z - z * v->y,
+			return make_pooled<Vector3>(y * v->z - z * v->y,
 										z * v->x - x * v->z,
 										x * v->y - y * v->x);
 		}
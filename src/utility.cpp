@@ -25,6 +25,8 @@
 #endif
 
 #include <algorithm>
+#include <cstring>
+#include <stdint.h>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -47,6 +49,13 @@ namespace OB{
 		return retVal;
 	}
 
+	ob_uint64 currentTimeMicros(){
+		struct timeval tp;
+		gettimeofday(&tp, NULL);
+
+		return ((ob_uint64)tp.tv_sec * 1000000) + tp.tv_usec;
+	}
+
 	bool ob_str_startsWith(std::string str, std::string prefix){
 		if(prefix.size() > str.size()){
 			return false;
@@ -61,6 +70,102 @@ namespace OB{
 		return std::equal(suffix.rbegin(), suffix.rend(), str.rbegin());
 	}
 
+	static const uint32_t _ob_sha256_k[64] = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+	};
+
+	static inline uint32_t _ob_sha256_rotr(uint32_t x, int n){
+		return (x >> n) | (x << (32 - n));
+	}
+
+	static void _ob_sha256_block(uint32_t h[8], const unsigned char* block){
+		uint32_t w[64];
+		for(int i = 0; i < 16; i++){
+			w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) | ((uint32_t)block[i * 4 + 2] << 8) | (uint32_t)block[i * 4 + 3];
+		}
+		for(int i = 16; i < 64; i++){
+			uint32_t s0 = _ob_sha256_rotr(w[i - 15], 7) ^ _ob_sha256_rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+			uint32_t s1 = _ob_sha256_rotr(w[i - 2], 17) ^ _ob_sha256_rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+		}
+
+		uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+
+		for(int i = 0; i < 64; i++){
+			uint32_t S1 = _ob_sha256_rotr(e, 6) ^ _ob_sha256_rotr(e, 11) ^ _ob_sha256_rotr(e, 25);
+			uint32_t ch = (e & f) ^ (~e & g);
+			uint32_t t1 = hh + S1 + ch + _ob_sha256_k[i] + w[i];
+			uint32_t S0 = _ob_sha256_rotr(a, 2) ^ _ob_sha256_rotr(a, 13) ^ _ob_sha256_rotr(a, 22);
+			uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+			uint32_t t2 = S0 + maj;
+
+			hh = g;
+			g = f;
+			f = e;
+			e = d + t1;
+			d = c;
+			c = b;
+			b = a;
+			a = t1 + t2;
+		}
+
+		h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+		h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+	}
+
+	std::string ob_sha256_hex(const char* data, size_t len){
+		uint32_t h[8] = {
+			0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+			0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+		};
+
+		const unsigned char* udata = (const unsigned char*)data;
+
+		size_t i = 0;
+		for(; i + 64 <= len; i += 64){
+			_ob_sha256_block(h, udata + i);
+		}
+
+		// Padding: 0x80, zeros, then the length in bits, big endian
+		unsigned char tail[128];
+		size_t rem = len - i;
+		memset(tail, 0, sizeof(tail));
+		if(rem > 0){
+			memcpy(tail, udata + i, rem);
+		}
+		tail[rem] = 0x80;
+
+		size_t tailLen = (rem < 56) ? 64 : 128;
+		ob_uint64 bitLen = (ob_uint64)len * 8;
+		for(int j = 0; j < 8; j++){
+			tail[tailLen - 1 - j] = (unsigned char)(bitLen >> (j * 8));
+		}
+
+		_ob_sha256_block(h, tail);
+		if(tailLen == 128){
+			_ob_sha256_block(h, tail + 64);
+		}
+
+		static const char hexDigits[] = "0123456789abcdef";
+
+		std::string out;
+		out.reserve(64);
+		for(int j = 0; j < 8; j++){
+			for(int k = 28; k >= 0; k -= 4){
+				out.push_back(hexDigits[(h[j] >> k) & 0xf]);
+			}
+		}
+
+		return out;
+	}
+
 	// Windows compat
 #ifdef _WIN32
 	char* realpath(const char* path, char resolved_path[PATH_MAX]){